@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+
+# Benchmark Suite: Phase timings of rendering generated tables
+# Generates a table for each row count in BENCH_ROWS with BENCH_COLUMNS columns, and runs the
+# benchmark driver built with the release -Os flags as the baseline and with BENCH_CFLAGS, so a
+# change can be measured against the shipped build. Run through: make bench
+
+bench_dir="$(dirname "$0")"
+rows_list="${BENCH_ROWS:-10000 50000}"
+columns="${BENCH_COLUMNS:-9}"
+rounds="${BENCH_ROUNDS:-3}"
+
+# Create temporary files for the generated tables
+layout_file=$(mktemp)
+data_file=$(mktemp)
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+for rows in $rows_list; do
+    if ! "$bench_dir/table_gen" "$rows" "$columns" "$layout_file" "$data_file"; then
+        echo "Error: Failed to generate a table of $rows rows" >&2
+        exit 1
+    fi
+    size=$(wc -c < "$data_file")
+
+    header="Bench: $rows rows, $columns columns, $size bytes of data"
+    echo -e "\n$header"
+    echo "${header//?/-}"
+    for driver in table_bench_baseline table_bench; do
+        if [[ "$driver" == "table_bench_baseline" ]]; then
+            echo "Baseline (-Os release flags)"
+        else
+            echo "Build (BENCH_CFLAGS)"
+        fi
+        if ! "$bench_dir/$driver" "$layout_file" "$data_file" "$rounds"; then
+            echo "Error: $driver failed on $rows rows" >&2
+            exit 1
+        fi
+    done
+done
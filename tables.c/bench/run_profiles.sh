@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+
+# Benchmark Suite: Startup and per-row costs of tables executables built with different profiles
+# Each executable given as an argument renders a one-row table PROFILE_RUNS times, giving the
+# cost of starting up, and a generated table of each row count in BENCH_ROWS, giving the cost
+# of each row once the startup is taken off. The executables are listed side by side, the first
+# one being the baseline the others are compared with. Run through: make bench-profiles
+
+bench_dir="$(dirname "$0")"
+rows_list="${BENCH_ROWS:-10000 50000}"
+columns="${BENCH_COLUMNS:-9}"
+runs="${PROFILE_RUNS:-100}"
+rounds="${BENCH_ROUNDS:-3}"
+
+if [[ "$#" -lt 1 ]]; then
+    echo "Usage: run_profiles.sh <baseline executable> [executable...]" >&2
+    exit 1
+fi
+
+# Create temporary files for the generated tables
+layout_file=$(mktemp)
+data_file=$(mktemp)
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Helper function to print the milliseconds of the fastest of rounds runs of a command
+best_ms() {
+    local best="" start end elapsed
+    for ((round = 0; round < rounds; round++)); do
+        start=$(date +%s%N)
+        "$@" > /dev/null || return 1
+        end=$(date +%s%N)
+        elapsed=$(( (end - start) / 1000 ))
+        if [[ -z "$best" || "$elapsed" -lt "$best" ]]; then
+            best=$elapsed
+        fi
+    done
+    awk -v us="$best" 'BEGIN { printf "%.3f", us / 1000 }'
+}
+
+# Helper function to run the startup table runs times in a row
+startup_runs() {
+    for ((run = 0; run < runs; run++)); do
+        "$1" "$layout_file" "$data_file" || return 1
+    done
+}
+
+if ! "$bench_dir/table_gen" 1 "$columns" "$layout_file" "$data_file"; then
+    echo "Error: Failed to generate the startup table" >&2
+    exit 1
+fi
+declare -A startup
+header="Profiles: startup of $runs runs of a one-row table, then per-row cost"
+echo "$header"
+echo "${header//?/-}"
+printf "%-28s %10s %12s\n" "Executable" "Size" "Startup ms"
+for binary in "$@"; do
+    total=$(best_ms startup_runs "$binary") || { echo "Error: $binary failed" >&2; exit 1; }
+    startup[$binary]=$(awk -v total="$total" -v runs="$runs" 'BEGIN { printf "%.3f", total / runs }')
+    printf "%-28s %10s %12s\n" "$(basename "$binary")" "$(wc -c < "$binary")" "${startup[$binary]}"
+done
+
+for rows in $rows_list; do
+    if ! "$bench_dir/table_gen" "$rows" "$columns" "$layout_file" "$data_file"; then
+        echo "Error: Failed to generate a table of $rows rows" >&2
+        exit 1
+    fi
+    echo -e "\n$rows rows, $columns columns, $(wc -c < "$data_file") bytes of data"
+    printf "%-28s %10s %12s %10s\n" "Executable" "Total ms" "Per row us" "Speedup"
+    baseline=""
+    for binary in "$@"; do
+        total=$(best_ms "$binary" "$layout_file" "$data_file") || { echo "Error: $binary failed on $rows rows" >&2; exit 1; }
+        per_row=$(awk -v total="$total" -v start="${startup[$binary]}" -v rows="$rows" \
+                  'BEGIN { cost = (total - start) * 1000 / rows; printf "%.3f", (cost > 0 ? cost : 0) }')
+        [[ -z "$baseline" ]] && baseline=$per_row
+        speedup=$(awk -v base="$baseline" -v cost="$per_row" 'BEGIN { if (cost > 0) printf "%.2fx", base / cost; else print "-" }')
+        printf "%-28s %10s %12s %10s\n" "$(basename "$binary")" "$total" "$per_row" "$speedup"
+    done
+done
@@ -0,0 +1,210 @@
+/*
+ * table_bench.c - Benchmark driver timing each phase of rendering a table
+ * Runs the same steps as tables for one layout and data file, with the rendered table written to
+ * /dev/null, and reports the time, rows per second, heap allocations, arena bytes and peak RSS of
+ * each phase. Allocations are counted by linking with --wrap for the allocation functions, so
+ * they cover the tables sources and any library linked statically with them.
+ * Usage: table_bench <layout_file> <data_file> [rounds]
+ * Build and run with: make bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../tables_config.h"
+#include "../tables_data.h"
+#include "../tables_themes.h"
+#include "../tables_arena.h"
+#include "../tables_render_buffer.h"
+#include "../tables_render_layout.h"
+#include "../tables_render_output.h"
+#include "../tables_render_rows.h"
+
+/* Phases of rendering a table, in the order they run */
+typedef enum {
+    PHASE_PARSE,
+    PHASE_LOAD,
+    PHASE_SORT,
+    PHASE_PROCESS,
+    PHASE_WIDTHS,
+    PHASE_RENDER,
+    PHASE_COUNT
+} Phase;
+
+static const char *phase_names[PHASE_COUNT] = { "parse", "load", "sort", "process", "widths", "render" };
+
+/* Measurements of one phase, the time being the best of all rounds */
+typedef struct {
+    double best_ms;         /* Fastest time of the phase */
+    long allocations;       /* Heap allocations made by the phase in the last round */
+    size_t arena_bytes;     /* Arena bytes in use after the phase in the last round */
+    long peak_rss_kb;       /* Peak resident set size of the process after the phase in the first round */
+} PhaseStats;
+
+static long allocation_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+char *__real_strdup(const char *str);
+char *__real_strndup(const char *str, size_t length);
+
+/*
+ * Allocation functions the linker substitutes for the real ones, counting each call
+ */
+void *__wrap_malloc(size_t size) {
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(const char *str) {
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_strdup(str);
+}
+
+char *__wrap_strndup(const char *str, size_t length) {
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_strndup(str, length);
+}
+
+/*
+ * Helper function to return the current time in milliseconds
+ */
+static double now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+/*
+ * Helper function to record the end of a phase that started at start_ms with start_allocations
+ * The peak RSS is taken in the first round, as later rounds reuse the memory it reached
+ */
+static void end_phase(PhaseStats *stats, double start_ms, long start_allocations) {
+    double elapsed = now_ms() - start_ms;
+    if (stats->best_ms < 0 || elapsed < stats->best_ms) stats->best_ms = elapsed;
+    stats->allocations = __atomic_load_n(&allocation_count, __ATOMIC_RELAXED) - start_allocations;
+    stats->arena_bytes = arena_current()->bytes_used;
+    if (stats->peak_rss_kb == 0) {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        stats->peak_rss_kb = usage.ru_maxrss;
+    }
+}
+
+/*
+ * Helper function to run every phase once, returning the number of rows or -1 on failure
+ */
+static int run_round(const char *layout_file, const char *data_file, PhaseStats *stats) {
+    TableConfig config;
+    TableData data;
+    double start;
+    long allocations;
+
+#define BEGIN_PHASE() (start = now_ms(), allocations = __atomic_load_n(&allocation_count, __ATOMIC_RELAXED))
+
+    BEGIN_PHASE();
+    if (parse_layout_file(layout_file, &config) != 0) {
+        fprintf(stderr, "Error: Failed to parse layout file %s\n", layout_file);
+        return -1;
+    }
+    get_theme(&config);
+    end_phase(&stats[PHASE_PARSE], start, allocations);
+
+    BEGIN_PHASE();
+    if (prepare_data(data_file, &config, &data) != 0) {
+        fprintf(stderr, "Error: Failed to load data from %s\n", data_file);
+        free_table_config(&config);
+        return -1;
+    }
+    end_phase(&stats[PHASE_LOAD], start, allocations);
+
+    BEGIN_PHASE();
+    sort_data(&config, &data);
+    end_phase(&stats[PHASE_SORT], start, allocations);
+
+    BEGIN_PHASE();
+    process_data_rows(&config, &data);
+    end_phase(&stats[PHASE_PROCESS], start, allocations);
+
+    BEGIN_PHASE();
+    calculate_column_widths(&config, &data);
+    end_phase(&stats[PHASE_WIDTHS], start, allocations);
+
+    // The same steps as render_table() after the widths
+    BEGIN_PHASE();
+    int total_width = calculate_total_width(&config);
+    render_table_start(&config, total_width);
+    render_rows(&config, &data);
+    render_table_end(&config, &data, total_width);
+    output_finish();
+    end_phase(&stats[PHASE_RENDER], start, allocations);
+
+#undef BEGIN_PHASE
+
+    int rows = data.row_count;
+    free_table_data(&data, config.column_count);
+    free_table_config(&config);
+    arena_release(NULL);
+    return rows;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <layout_file> <data_file> [rounds]\n", argv[0]);
+        return 1;
+    }
+    int rounds = argc > 3 ? atoi(argv[3]) : 3;
+    if (rounds < 1) rounds = 1;
+
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd < 0) {
+        fprintf(stderr, "Error: Cannot open /dev/null\n");
+        return 1;
+    }
+    output_set_fd(null_fd);
+
+    PhaseStats stats[PHASE_COUNT];
+    memset(stats, 0, sizeof(stats));
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        stats[p].best_ms = -1;
+    }
+    int rows = 0;
+    for (int round = 0; round < rounds; round++) {
+        rows = run_round(argv[1], argv[2], stats);
+        if (rows < 0) return 1;
+    }
+
+    printf("%d rows, best of %d rounds\n", rows, rounds);
+    printf("%-8s %10s %14s %12s %12s %12s\n", "phase", "ms", "rows/sec", "allocations", "arena KB", "peak RSS KB");
+    double total_ms = 0;
+    long total_allocations = 0;
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        total_ms += stats[p].best_ms;
+        total_allocations += stats[p].allocations;
+        // The layout is parsed once per table, so it has no rate per row
+        char rate[32] = "-";
+        if (p != PHASE_PARSE && stats[p].best_ms > 0) {
+            snprintf(rate, sizeof(rate), "%.0f", rows / (stats[p].best_ms / 1000.0));
+        }
+        printf("%-8s %10.2f %14s %12ld %12zu %12ld\n", phase_names[p], stats[p].best_ms, rate,
+               stats[p].allocations, stats[p].arena_bytes / 1024, stats[p].peak_rss_kb);
+    }
+    printf("%-8s %10.2f %14.0f %12ld\n", "total", total_ms, total_ms > 0 ? rows / (total_ms / 1000.0) : 0, total_allocations);
+    close(null_fd);
+    return 0;
+}
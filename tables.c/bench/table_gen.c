@@ -0,0 +1,209 @@
+/*
+ * table_gen.c - Synthetic layout and data generator for the table benchmark
+ * Writes a layout of the given number of columns and a JSON array of the given number of rows,
+ * built from a fixed seed so every run measures the same table. The columns cycle through the
+ * kinds below: text with multi-byte characters and emoji, int, float, kcpu and kmem values,
+ * wrapped and clipped text, color placeholders, unique summaries and a break_on_change group.
+ * Usage: table_gen <rows> <columns> <layout_file> <data_file> [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Kinds of generated columns, the group column only appears once */
+typedef enum {
+    KIND_GROUP,
+    KIND_NAME,
+    KIND_INT,
+    KIND_FLOAT,
+    KIND_KCPU,
+    KIND_KMEM,
+    KIND_NOTES,
+    KIND_TAGS,
+    KIND_STATUS,
+    KIND_COUNT
+} ColumnKind;
+
+/* Layout of each kind of column, with %d standing for the column number in keys and headers */
+static const char *column_layouts[KIND_COUNT] = {
+    "{ \"header\": \"Zone\", \"key\": \"zone\", \"break\": true, \"summary\": \"unique\" }",
+    "{ \"header\": \"Name %d\", \"key\": \"name%d\", \"width\": 18, \"summary\": \"unique\" }",
+    "{ \"header\": \"Count %d\", \"key\": \"count%d\", \"datatype\": \"int\", \"justification\": \"right\", \"summary\": \"sum\" }",
+    "{ \"header\": \"Load %d\", \"key\": \"load%d\", \"datatype\": \"float\", \"justification\": \"right\", \"summary\": \"avg\" }",
+    "{ \"header\": \"CPU %d\", \"key\": \"cpu%d\", \"datatype\": \"kcpu\", \"justification\": \"right\", \"summary\": \"sum\" }",
+    "{ \"header\": \"Memory %d\", \"key\": \"mem%d\", \"datatype\": \"kmem\", \"justification\": \"right\", \"summary\": \"max\" }",
+    "{ \"header\": \"Notes %d\", \"key\": \"notes%d\", \"width\": 24, \"wrap_mode\": \"wrap\" }",
+    "{ \"header\": \"Tags %d\", \"key\": \"tags%d\", \"width\": 14, \"wrap_mode\": \"wrap\", \"wrap_char\": \",\", \"justification\": \"center\" }",
+    "{ \"header\": \"Status %d\", \"key\": \"status%d\", \"summary\": \"unique\", \"justification\": \"center\" }"
+};
+
+static const char *zones[] = { "us-east-1", "us-west-2", "eu-central-1", "ap-south-1", "sa-east-1" };
+static const char *name_parts[] = {
+    "web", "api", "db", "cache", "queue", "worker", "caf\xc3\xa9", "na\xc3\xafve", "\xe6\x9c\x8d\xe5\x8a\xa1",
+    "\xf0\x9f\x9a\x80", "\xe2\x9c\x85", "gateway", "search", "m\xc3\xbcnchen"
+};
+static const char *note_words[] = {
+    "restarted", "after", "the", "nightly", "deploy", "{RED}failed{RESET}", "{GREEN}healthy{RESET}",
+    "disk", "almost", "full", "on", "/var/lib", "r\xc3\xa9plica", "lagging", "\xe2\x9a\xa0", "behind"
+};
+static const char *tag_words[] = { "prod", "canary", "blue", "green", "critical", "batch", "\xe2\x98\x85" };
+static const char *statuses[] = {
+    "{GREEN}Running{RESET}", "{YELLOW}Pending{RESET}", "{RED}Failed{RESET}", "Succeeded", "{CYAN}Unknown{RESET}"
+};
+
+static unsigned long long rng_state = 1;
+
+/*
+ * Helper function to return the next number of a xorshift generator
+ */
+static unsigned int next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned int)(rng_state >> 16);
+}
+
+/*
+ * Helper function to pick one of count strings
+ */
+static const char *pick(const char **strings, int count) {
+    return strings[next_random() % count];
+}
+
+/*
+ * Helper function to return the kind of column c, with the group column first
+ */
+static ColumnKind column_kind(int c) {
+    if (c == 0) return KIND_GROUP;
+    return (ColumnKind)(KIND_NAME + (c - 1) % (KIND_COUNT - 1));
+}
+
+/*
+ * Helper function to write the layout of all columns, sorted by zone and then by the first name
+ */
+static int write_layout(const char *filename, int columns) {
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Cannot create layout file %s\n", filename);
+        return 1;
+    }
+    fprintf(file, "{\n  \"theme\": \"Red\",\n  \"title\": \"Benchmark table\",\n  \"footer\": \"Generated rows\",\n");
+    fprintf(file, "  \"columns\": [\n");
+    for (int c = 0; c < columns; c++) {
+        fprintf(file, "    ");
+        fprintf(file, column_layouts[column_kind(c)], c, c);
+        fprintf(file, "%s\n", c + 1 < columns ? "," : "");
+    }
+    fprintf(file, "  ],\n  \"sort\": [\n    { \"key\": \"zone\", \"direction\": \"asc\", \"priority\": 1 }");
+    if (columns > 1) {
+        fprintf(file, ",\n    { \"key\": \"name1\", \"direction\": \"asc\", \"priority\": 2 }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+    return fclose(file) != 0;
+}
+
+/*
+ * Helper function to write the value of column c for one row
+ */
+static void write_value(FILE *file, int c) {
+    ColumnKind kind = column_kind(c);
+    const char *key[] = { "zone", "name", "count", "load", "cpu", "mem", "notes", "tags", "status" };
+    if (kind == KIND_GROUP) {
+        fprintf(file, "\"zone\": \"%s\"", pick(zones, 5));
+        return;
+    }
+    fprintf(file, "\"%s%d\": ", key[kind], c);
+    if (next_random() % 50 == 0) {
+        fprintf(file, "null");
+        return;
+    }
+    switch (kind) {
+        case KIND_NAME:
+            fprintf(file, "\"%s-%s-%02u\"", pick(name_parts, 14), pick(name_parts, 14), next_random() % 100);
+            break;
+        case KIND_INT:
+            fprintf(file, "%u", next_random() % 100000);
+            break;
+        case KIND_FLOAT:
+            fprintf(file, "%u.%03u", next_random() % 100, next_random() % 1000);
+            break;
+        case KIND_KCPU:
+            if (next_random() % 4 == 0) {
+                fprintf(file, "\"%u.%u\"", next_random() % 8, next_random() % 10);
+            } else {
+                fprintf(file, "\"%um\"", 10 + next_random() % 2000);
+            }
+            break;
+        case KIND_KMEM:
+            if (next_random() % 3 == 0) {
+                fprintf(file, "\"%uGi\"", 1 + next_random() % 16);
+            } else {
+                fprintf(file, "\"%uMi\"", 16 + next_random() % 1024);
+            }
+            break;
+        case KIND_NOTES: {
+            int words = 3 + next_random() % 12;
+            fputc('"', file);
+            for (int w = 0; w < words; w++) {
+                fprintf(file, "%s%s", w ? " " : "", pick(note_words, 16));
+            }
+            fputc('"', file);
+            break;
+        }
+        case KIND_TAGS: {
+            int tags = 1 + next_random() % 4;
+            fputc('"', file);
+            for (int t = 0; t < tags; t++) {
+                fprintf(file, "%s%s", t ? "," : "", pick(tag_words, 7));
+            }
+            fputc('"', file);
+            break;
+        }
+        default:
+            fprintf(file, "\"%s\"", pick(statuses, 5));
+            break;
+    }
+}
+
+/*
+ * Helper function to write the data rows
+ */
+static int write_data(const char *filename, long rows, int columns) {
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Cannot create data file %s\n", filename);
+        return 1;
+    }
+    fputs("[\n", file);
+    for (long r = 0; r < rows; r++) {
+        fputs("  { ", file);
+        for (int c = 0; c < columns; c++) {
+            if (c) fputs(", ", file);
+            write_value(file, c);
+        }
+        fprintf(file, " }%s\n", r + 1 < rows ? "," : "");
+    }
+    fputs("]\n", file);
+    return fclose(file) != 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 5) {
+        fprintf(stderr, "Usage: %s <rows> <columns> <layout_file> <data_file> [seed]\n", argv[0]);
+        return 1;
+    }
+    long rows = strtol(argv[1], NULL, 10);
+    int columns = atoi(argv[2]);
+    if (rows < 0 || columns < 1 || columns > 100) {
+        fprintf(stderr, "Error: Rows must be 0 or more and columns between 1 and 100\n");
+        return 1;
+    }
+    if (argc > 5) rng_state = strtoull(argv[5], NULL, 10) * 2654435761ULL + 1;
+
+    if (write_layout(argv[3], columns) != 0 || write_data(argv[4], rows, columns) != 0) {
+        fprintf(stderr, "Error: Failed to write the benchmark table\n");
+        return 1;
+    }
+    return 0;
+}
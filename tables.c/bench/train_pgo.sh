@@ -0,0 +1,43 @@
+#!/usr/bin/env bash
+
+# Benchmark Suite: Training runs of a profile-guided build
+# Renders generated tables of each row count in PGO_ROWS with PGO_COLUMNS columns using the
+# instrumented executable given as the argument, once for each way tables is commonly run, so
+# the profile covers loading, sorting, summaries, limits and rendering. Run through: make pgo
+
+bench_dir="$(dirname "$0")"
+tables_binary="${1:?Usage: train_pgo.sh <instrumented tables executable>}"
+rows_list="${PGO_ROWS:-1000 20000}"
+columns="${PGO_COLUMNS:-9}"
+
+# Create temporary files for the generated tables
+layout_file=$(mktemp)
+data_file=$(mktemp)
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+for rows in $rows_list; do
+    if ! "$bench_dir/table_gen" "$rows" "$columns" "$layout_file" "$data_file"; then
+        echo "Error: Failed to generate a table of $rows rows" >&2
+        exit 1
+    fi
+    echo "Training on $rows rows, $columns columns"
+    for options in "" "--threads 1" "--limit 50" "--format ndjson"; do
+        data="$data_file"
+        if [[ "$options" == "--format ndjson" ]]; then
+            # The same rows with one object per line
+            data=$(mktemp)
+            sed -e '1d' -e '$d' -e 's/^  //' -e 's/,$//' "$data_file" > "$data"
+        fi
+        # shellcheck disable=SC2086
+        if ! "$tables_binary" "$layout_file" "$data" $options > /dev/null; then
+            echo "Error: Training run with '$options' failed on $rows rows" >&2
+            exit 1
+        fi
+        [[ "$data" != "$data_file" ]] && rm -f "$data"
+    done
+done
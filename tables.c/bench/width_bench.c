@@ -0,0 +1,184 @@
+/*
+ * width_bench.c - Micro-benchmark for get_display_width()
+ * Compares the single-pass scanner against the previous implementation, which copied each string
+ * into the arena to strip ANSI escapes and scanned it again for non-ASCII bytes. Both are first
+ * checked to give the same width for random strings of ASCII, escapes and partial UTF-8 sequences.
+ * Build and run with: make bench-width
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../tables_render_utils.h"
+#include "../tables_arena.h"
+
+int tables_debug_mode = 0;
+
+#define CHECK_STRINGS 200000
+#define BENCH_STRINGS 4096
+#define BENCH_ROUNDS 500
+
+/*
+ * Previous implementation of get_display_width(), kept for comparison
+ */
+static int legacy_display_width(const char *text) {
+    if (text == NULL || strlen(text) == 0) return 0;
+
+    ArenaMark mark = arena_mark();
+    char *clean_text = arena_alloc(strlen(text) + 1);
+    if (!clean_text) return 0;
+
+    int in_ansi = 0;
+    int j = 0;
+    for (const char *p = text; *p; p++) {
+        if (*p == '\033') in_ansi = 1;
+        if (!in_ansi) clean_text[j++] = *p;
+        if (in_ansi && *p == 'm') in_ansi = 0;
+    }
+    clean_text[j] = '\0';
+
+    int is_ascii = 1;
+    for (int i = 0; clean_text[i]; i++) {
+        if ((unsigned char)clean_text[i] > 127) {
+            is_ascii = 0;
+            break;
+        }
+    }
+    if (is_ascii) {
+        int len = strlen(clean_text);
+        arena_reset(mark);
+        return len;
+    }
+
+    int width = 0;
+    int len = strlen(clean_text);
+    int i = 0;
+    while (i < len) {
+        unsigned char byte1 = (unsigned char)clean_text[i];
+        if (byte1 < 128) {
+            width++;
+            i++;
+        } else if (byte1 < 224) {
+            if (i + 1 < len) {
+                unsigned char byte2 = (unsigned char)clean_text[i + 1];
+                int codepoint = ((byte1 & 0x1F) << 6) | (byte2 & 0x3F);
+                width += (codepoint >= 4352 && codepoint <= 55215) ? 2 : 1;
+                i += 2;
+            } else {
+                width++;
+                i++;
+            }
+        } else if (byte1 < 240) {
+            if (i + 2 < len) {
+                unsigned char byte2 = (unsigned char)clean_text[i + 1];
+                unsigned char byte3 = (unsigned char)clean_text[i + 2];
+                int codepoint = ((byte1 & 0x0F) << 12) | ((byte2 & 0x3F) << 6) | (byte3 & 0x3F);
+                width += ((codepoint >= 127744 && codepoint <= 129535) ||
+                          (codepoint >= 9728 && codepoint <= 9983)) ? 2 : 1;
+                i += 3;
+            } else {
+                width++;
+                i++;
+            }
+        } else {
+            if (i + 3 < len) {
+                width += 2;
+                i += 4;
+            } else {
+                width++;
+                i++;
+            }
+        }
+    }
+    arena_reset(mark);
+    return width;
+}
+
+/*
+ * Helper function to fill buffer with a random string built from the given pieces
+ */
+static void random_string(char *buffer, size_t size, const char **pieces, int piece_count) {
+    size_t length = 0;
+    int count = rand() % 12;
+    buffer[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        const char *piece = pieces[rand() % piece_count];
+        size_t piece_length = strlen(piece);
+        if (length + piece_length + 1 > size) break;
+        memcpy(buffer + length, piece, piece_length + 1);
+        length += piece_length;
+    }
+}
+
+/*
+ * Helper function to time width over all strings, returning nanoseconds per call
+ */
+static double time_width(int (*width)(const char *), char **strings, int count, long *total) {
+    struct timespec start, stop;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < count; i++) {
+            *total += width(strings[i]);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double elapsed = (stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec);
+    return elapsed / ((double)BENCH_ROUNDS * count);
+}
+
+int main(void) {
+    // Pieces for the equality check, including escapes without an end and cut UTF-8 sequences
+    const char *check_pieces[] = {
+        "a", "server-01", " ", "m", "\033", "\033[0;31m", "\033[1;37", "\xc3\xa9", "\xc3",
+        "\xe2\x94\x80", "\xe2\x98\x80", "\xe2\x9c\x85", "\xe2\x98", "\xf0\x9f\x98\x8a", "\xf0\x9f",
+        "\x9f", "\xff", "1,234.50", "\xe4\xb8\xad"
+    };
+    char buffer[256];
+    srand(42);
+    for (int i = 0; i < CHECK_STRINGS; i++) {
+        random_string(buffer, sizeof(buffer), check_pieces, sizeof(check_pieces) / sizeof(check_pieces[0]));
+        int expected = legacy_display_width(buffer);
+        int actual = get_display_width(buffer);
+        if (expected != actual) {
+            fprintf(stderr, "Error: Width %d instead of %d for string %d\n", actual, expected, i);
+            return 1;
+        }
+    }
+    printf("Checked %d random strings, widths match\n", CHECK_STRINGS);
+
+    // Workloads resembling table cells
+    const char *ascii_pieces[] = { "web-server", "-01", " ", "1,234", ".50", "default", "Running" };
+    const char *color_pieces[] = { "\033[0;32m", "\033[0m", "healthy", " ", "2,048M", "\033[1;37m" };
+    const char *utf8_pieces[] = { "\xe2\x94\x80", "\xf0\x9f\x9a\x80", "Caf\xc3\xa9", " ", "\xe2\x9c\x93", "status" };
+    struct {
+        const char *name;
+        const char **pieces;
+        int piece_count;
+    } workloads[] = {
+        { "ascii", ascii_pieces, sizeof(ascii_pieces) / sizeof(ascii_pieces[0]) },
+        { "ansi colors", color_pieces, sizeof(color_pieces) / sizeof(color_pieces[0]) },
+        { "utf-8", utf8_pieces, sizeof(utf8_pieces) / sizeof(utf8_pieces[0]) }
+    };
+
+    printf("%-12s %12s %12s %8s\n", "workload", "legacy ns", "scanner ns", "speedup");
+    for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+        char *strings[BENCH_STRINGS];
+        for (int i = 0; i < BENCH_STRINGS; i++) {
+            random_string(buffer, sizeof(buffer), workloads[w].pieces, workloads[w].piece_count);
+            strings[i] = strdup(buffer);
+        }
+        long legacy_total = 0, scanner_total = 0;
+        double legacy = time_width(legacy_display_width, strings, BENCH_STRINGS, &legacy_total);
+        double scanner = time_width(get_display_width, strings, BENCH_STRINGS, &scanner_total);
+        if (legacy_total != scanner_total) {
+            fprintf(stderr, "Error: Total width %ld instead of %ld for %s\n", scanner_total, legacy_total, workloads[w].name);
+            return 1;
+        }
+        printf("%-12s %12.1f %12.1f %7.1fx\n", workloads[w].name, legacy, scanner, legacy / scanner);
+        for (int i = 0; i < BENCH_STRINGS; i++) free(strings[i]);
+    }
+
+    arena_release(NULL);
+    return 0;
+}
@@ -8,24 +8,54 @@
 #include <string.h>
 #include <jansson.h>
 #include <locale.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "tables_config.h"
 #include "tables_themes.h"
 #include "tables_data.h"
 #include "tables_render.h"
+#include "tables_arena.h"
+#include "tables_render_buffer.h"
+#include "tables_parallel.h"
+#include "tables_commands.h"
+#include "tables_server.h"
+#include "tables_input.h"
+#include "tables_reader.h"
+#include "tables_layout_cache.h"
+#include "tables_select.h"
+#include "tables_profile.h"
+#include "tables_watch.h"
+#include "tables_page.h"
 
 #define VERSION "1.0.1"
 
+/* Structure holding a layout file parsed once for all batch tables using it */
+typedef struct {
+    char *filename;         /* Layout file as named in the manifest */
+    json_t *root;           /* Parsed layout JSON */
+} BatchLayout;
+
 /* Function prototypes */
 void print_help(void);
 void print_version(void);
+static int render_one(TableConfig *config, const char *data_file);
+static int render_batch(const char *manifest_file);
+static int render_watched(TableConfig *config, const char *data_file);
+
+static int stream_requested = 0;   /* --stream was given */
+static int mmap_requested = 0;     /* --mmap was given */
+static int layout_cache_requested = 0; /* --layout_cache was given */
+static int stream_mode = 0;        /* Table is rendered while its rows are read */
+static int mmap_mode = 0;          /* Data file is mapped and its rows rendered in place */
+
+extern int tables_debug_mode;
+extern int tables_debug_layout;
 
 /*
  * Main function
  * Handles command-line arguments and coordinates the execution flow.
  */
-int debug_mode = 0;
-int debug_layout = 0;
-
 int main(int argc, char *argv[]) {
     setlocale(LC_ALL, "");
     
@@ -54,73 +84,380 @@ int main(int argc, char *argv[]) {
     // Check for debug options
     for (int i = 3; i < argc; i++) {
         if (strcmp(argv[i], "--debug") == 0) {
-            debug_mode = 1;
+            tables_debug_mode = 1;
             fprintf(stderr, "Debug mode enabled\n");
         }
         if (strcmp(argv[i], "--debug_layout") == 0) {
-            debug_layout = 1;
+            tables_debug_layout = 1;
             fprintf(stderr, "Debug layout mode enabled\n");
         }
+        if (strcmp(argv[i], "--stream") == 0) {
+            stream_requested = 1;
+        }
+        if (strcmp(argv[i], "--mmap") == 0) {
+            mmap_requested = 1;
+        }
+        if (strcmp(argv[i], "--layout_cache") == 0) {
+            layout_cache_requested = 1;
+        }
+        if (strcmp(argv[i], "--profile") == 0) {
+            profile_enable();
+        }
+        if (strcmp(argv[i], "--buffer_size") == 0) {
+            char *end = NULL;
+            long size = (i + 1 < argc) ? strtol(argv[i + 1], &end, 10) : 0;
+            if (end == NULL || *end != '\0' || size <= 0) {
+                fprintf(stderr, "Error: --buffer_size needs a positive number of bytes\n");
+                return 1;
+            }
+            output_set_buffer_size((size_t)size);
+            i++;
+        }
+        if (strcmp(argv[i], "--format") == 0) {
+            if (data_format_set(i + 1 < argc ? argv[i + 1] : NULL) != 0) {
+                return 1;
+            }
+            i++;
+        }
+        if (strcmp(argv[i], "--limit") == 0) {
+            char *end = NULL;
+            long rows = (i + 1 < argc) ? strtol(argv[i + 1], &end, 10) : -1;
+            if (end == NULL || *end != '\0') rows = -1;
+            if (select_set_limit(rows) != 0) {
+                return 1;
+            }
+            i++;
+        }
+        if (strcmp(argv[i], "--page_size") == 0) {
+            char *end = NULL;
+            long rows = (i + 1 < argc) ? strtol(argv[i + 1], &end, 10) : 0;
+            if (end == NULL || *end != '\0') rows = 0;
+            if (page_set_size(rows) != 0) {
+                return 1;
+            }
+            i++;
+        }
+        if (strcmp(argv[i], "--page") == 0) {
+            char *end = NULL;
+            long page = (i + 1 < argc) ? strtol(argv[i + 1], &end, 10) : 0;
+            if (end == NULL || *end != '\0') page = 0;
+            if (page_set_number(page) != 0) {
+                return 1;
+            }
+            i++;
+        }
+        if (strcmp(argv[i], "--watch") == 0) {
+            if (watch_set_interval(i + 1 < argc ? argv[i + 1] : NULL) != 0) {
+                return 1;
+            }
+            i++;
+        }
+        if (strcmp(argv[i], "--threads") == 0) {
+            char *end = NULL;
+            long count = (i + 1 < argc) ? strtol(argv[i + 1], &end, 10) : 0;
+            if (end == NULL || *end != '\0') count = 0;
+            if (parallel_set_threads(count) != 0) {
+                return 1;
+            }
+            i++;
+        }
+    }
+
+    if (page_check_options() != 0) {
+        return 1;
+    }
+
+    // Serve render requests on a Unix socket, or send one to a running server
+    if (strcmp(argv[1], "--serve") == 0) {
+        return serve_tables(argv[2]);
+    }
+    if (strcmp(argv[1], "--client") == 0) {
+        if (argc < 5) {
+            fprintf(stderr, "Error: --client needs a socket, a layout file and a data file\n");
+            return 1;
+        }
+        return request_table(argv[2], argv[3], argv[4]);
+    }
+
+    // Render every table listed in a batch manifest in this process
+    if (strcmp(argv[1], "--batch") == 0) {
+        int status = render_batch(argv[2]);
+        profile_report();
+        return status;
     }
 
     // Validate input files
+    profile_switch(PROFILE_VALIDATE);
     if (validate_input_files(layout_file, data_file) != 0) {
         fprintf(stderr, "Error: Input file validation failed\n");
         return 1;
     }
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Input files validated successfully\n");
     }
 
     // Parse layout file
+    profile_switch(PROFILE_PARSE);
     TableConfig config;
-    if (parse_layout_file(layout_file, &config) != 0) {
+    int parse_status = layout_cache_requested && !input_is_stdin(layout_file) ?
+                       parse_layout_cached(layout_file, VERSION, &config) : parse_layout_file(layout_file, &config);
+    if (parse_status != 0) {
         fprintf(stderr, "Error: Failed to parse layout file %s\n", layout_file);
         return 1;
     }
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Layout file parsed successfully, %d columns\n", config.column_count);
     }
 
     // Set the theme based on configuration
+    profile_switch(PROFILE_THEME);
     get_theme(&config);
+    profile_switch(PROFILE_NONE);
+
+    // Render the table once, or again as its data changes until interrupted
+    int status = watch_requested() ? watch_table(&config, data_file, render_watched) :
+                 render_one(&config, data_file);
+
+    // Clean up
+    free_table_config(&config);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Table configuration freed\n");
+    }
+    release_run_memory();
+    profile_report();
+
+    return status;
+}
+
+/*
+ * Render one table from a parsed layout and a data file, returning 0 on success
+ * The caller frees the configuration and calls release_run_memory() afterwards
+ */
+static int render_one(TableConfig *config, const char *data_file) {
+    profile_add(PROFILE_TABLES, 1);
+
+    // Start the $() commands of the title and footer, so they run while the data is loaded
+    commands_start(config);
+
+    // Render rows as they are read when requested, or automatically when the output is unaffected
+    stream_mode = stream_requested;
+    mmap_mode = mmap_requested;
+    if (stream_mode) {
+        const char *reason = NULL;
+        if (!stream_mode_supported(config, &reason)) {
+            fprintf(stderr, "Warning: --stream ignored, %s\n", reason);
+            stream_mode = 0;
+        }
+    } else if (stream_mode_automatic(config)) {
+        stream_mode = 1;
+    }
+    if (stream_mode) {
+        if (tables_debug_mode) {
+            fprintf(stderr, "Debug: Streaming mode enabled\n");
+        }
+        int status = render_table_stream(data_file, config);
+        if (status != 0) {
+            fprintf(stderr, "Error: Failed to load data from %s\n", input_name(data_file));
+        }
+        return status;
+    }
+
+    // Measure and render in two passes over the mapped data file when requested
+    if (mmap_mode) {
+        const char *reason = NULL;
+        if (!mapped_mode_supported(config, data_file, &reason)) {
+            fprintf(stderr, "Warning: --mmap ignored, %s\n", reason);
+            mmap_mode = 0;
+        }
+    }
+    if (mmap_mode) {
+        if (tables_debug_mode) {
+            fprintf(stderr, "Debug: Two-pass mapped mode enabled\n");
+        }
+        int status = render_table_mapped(data_file, config);
+        if (status != 0) {
+            fprintf(stderr, "Error: Failed to load data from %s\n", input_name(data_file));
+        }
+        return status;
+    }
 
     // Load and prepare data
     TableData table_data;
-    if (prepare_data(data_file, &config, &table_data) != 0) {
-        fprintf(stderr, "Error: Failed to load data from %s\n", data_file);
-        free_table_config(&config);
+    profile_switch(PROFILE_LOAD);
+    if (prepare_data(data_file, config, &table_data) != 0) {
+        profile_switch(PROFILE_NONE);
+        fprintf(stderr, "Error: Failed to load data from %s\n", input_name(data_file));
         return 1;
     }
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Data loaded successfully, %d rows\n", table_data.row_count);
     }
 
     // Sort data if specified
-    sort_data(&config, &table_data);
+    profile_switch(PROFILE_SORT);
+    sort_data(config, &table_data);
 
     // Process data rows and calculate summaries
-    process_data_rows(&config, &table_data);
+    profile_switch(PROFILE_PROCESS);
+    process_data_rows(config, &table_data);
 
     // Render table
-    render_table(&config, &table_data);
-    if (debug_mode) {
+    render_table(config, &table_data);
+    profile_switch(PROFILE_NONE);
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Table rendering completed\n");
     }
 
     // Clean up data
-    free_table_data(&table_data, config.column_count);
-    if (debug_mode) {
+    free_table_data(&table_data, config->column_count);
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Table data freed\n");
     }
+    return 0;
+}
 
-    // Clean up
-    free_table_config(&config);
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Table configuration freed\n");
+/*
+ * Render one frame of a watched table, releasing its rows and text before the next frame
+ */
+static int render_watched(TableConfig *config, const char *data_file) {
+    int status = render_one(config, data_file);
+    release_run_memory();
+    return status;
+}
+
+/*
+ * Helper function to return the current time in milliseconds
+ */
+static double now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+/*
+ * Render every table listed in a batch manifest, returning 0 if all of them were rendered
+ * The manifest is a JSON array of objects naming a "layout" and a "data" file, and optionally an
+ * "output" file written instead of stdout. A layout file used by several tables is parsed once.
+ */
+static int render_batch(const char *manifest_file) {
+    json_error_t error;
+    json_t *manifest = json_load_file(manifest_file, 0, &error);
+    if (manifest == NULL) {
+        fprintf(stderr, "Error: JSON parsing failed for %s: %s\n", manifest_file, error.text);
+        return 1;
+    }
+    if (!json_is_array(manifest)) {
+        fprintf(stderr, "Error: Batch manifest %s must be an array of tables\n", manifest_file);
+        json_decref(manifest);
+        return 1;
     }
 
-    return 0;
+    size_t table_count = json_array_size(manifest);
+    BatchLayout *layouts = calloc(table_count ? table_count : 1, sizeof(BatchLayout));
+    if (layouts == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for batch layouts\n");
+        json_decref(manifest);
+        return 1;
+    }
+    int layout_count = 0;
+    int failures = 0;
+    double batch_start = now_ms();
+
+    for (size_t i = 0; i < table_count; i++) {
+        json_t *entry = json_array_get(manifest, i);
+        const char *layout_file = json_string_value(json_object_get(entry, "layout"));
+        const char *data_file = json_string_value(json_object_get(entry, "data"));
+        const char *output_file = json_string_value(json_object_get(entry, "output"));
+        if (layout_file == NULL || data_file == NULL) {
+            fprintf(stderr, "Error: Batch table %zu needs \"layout\" and \"data\" files\n", i + 1);
+            failures++;
+            continue;
+        }
+        double table_start = now_ms();
+
+        // Reuse the layout when an earlier table had the same layout file
+        json_t *root = NULL;
+        int reused = 0;
+        for (int l = 0; l < layout_count && root == NULL; l++) {
+            if (strcmp(layouts[l].filename, layout_file) == 0) {
+                root = layouts[l].root;
+                reused = 1;
+            }
+        }
+        profile_switch(PROFILE_VALIDATE);
+        if (validate_input_files(layout_file, data_file) != 0) {
+            profile_switch(PROFILE_NONE);
+            fprintf(stderr, "Error: Input file validation failed for batch table %zu\n", i + 1);
+            failures++;
+            continue;
+        }
+        profile_switch(PROFILE_PARSE);
+        if (root == NULL) {
+            root = load_layout_file(layout_file);
+            char *filename = strdup(layout_file);
+            if (root == NULL || filename == NULL) {
+                profile_switch(PROFILE_NONE);
+                fprintf(stderr, "Error: Failed to parse layout file %s\n", layout_file);
+                json_decref(root);
+                free(filename);
+                failures++;
+                continue;
+            }
+            layouts[layout_count].filename = filename;
+            layouts[layout_count].root = root;
+            layout_count++;
+        }
+
+        TableConfig config;
+        if (parse_layout_json(root, &config) != 0) {
+            profile_switch(PROFILE_NONE);
+            fprintf(stderr, "Error: Failed to parse layout file %s\n", layout_file);
+            failures++;
+            continue;
+        }
+        profile_switch(PROFILE_THEME);
+        get_theme(&config);
+        profile_switch(PROFILE_NONE);
+        double setup_ms = now_ms() - table_start;
+
+        int output_fd = -1;
+        if (output_file) {
+            output_fd = open(output_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (output_fd < 0) {
+                fprintf(stderr, "Error: Cannot open output file %s\n", output_file);
+                free_table_config(&config);
+                failures++;
+                continue;
+            }
+            output_set_fd(output_fd);
+        }
+
+        if (render_one(&config, data_file) != 0) {
+            failures++;
+        }
+        free_table_config(&config);
+        release_run_memory();
+        if (output_fd >= 0) {
+            output_set_fd(STDOUT_FILENO);
+            close(output_fd);
+        }
+        if (tables_debug_mode) {
+            fprintf(stderr, "Debug: Batch table %zu took %.3f ms, %.3f ms of it for the %s layout and theme\n",
+                    i + 1, now_ms() - table_start, setup_ms, reused ? "reused" : "parsed");
+        }
+    }
+
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Batch of %zu tables took %.3f ms, %d layout files parsed, %d failed\n",
+                table_count, now_ms() - batch_start, layout_count, failures);
+    }
+    for (int l = 0; l < layout_count; l++) {
+        free(layouts[l].filename);
+        json_decref(layouts[l].root);
+    }
+    free(layouts);
+    json_decref(manifest);
+    return failures > 0 ? 1 : 0;
 }
 
 /*
@@ -128,12 +465,32 @@ int main(int argc, char *argv[]) {
  */
 void print_help(void) {
     printf("Usage: tables <layout_json_file> <data_json_file> [OPTIONS]\n");
+    printf("       tables --batch <manifest_json_file> [OPTIONS]\n");
+    printf("       tables --serve <socket_path> [OPTIONS]\n");
+    printf("       tables --client <socket_path> <layout_json_file> <data_json_file>\n");
     printf("Parameters:\n");
     printf("  layout_json_file: JSON file defining table structure and formatting\n");
     printf("  data_json_file: JSON file containing the data to display\n");
+    printf("    (either file can be a named pipe, or - to read it from stdin)\n");
+    printf("    (the data is a JSON array of row objects, or NDJSON with one row object per line)\n");
+    printf("  manifest_json_file: JSON array of {\"layout\", \"data\", \"output\"} objects, rendered in turn\n");
+    printf("    (\"output\" is optional, tables without it are written to stdout one after another)\n");
+    printf("  socket_path: Unix socket a server renders tables on, keeping parsed layouts between requests\n");
+    printf("    (a request is the layout file path on one line followed by the data JSON)\n");
     printf("Options:\n");
     printf("  --debug: Enable debug output to stderr for memory issues\n");
     printf("  --debug_layout: Enable debug output for layout issues\n");
+    printf("  --stream: Render rows while the data is read (every visible column needs a width)\n");
+    printf("  --mmap: Measure and render in two passes over the mapped data file instead of loading all rows\n");
+    printf("  --layout_cache: Keep the parsed layout in ~/.cache/tables and reuse it until the layout file changes\n");
+    printf("  --buffer_size <bytes>: Size of the output buffer written to stdout at once (default 65536)\n");
+    printf("  --format <json|ndjson|auto>: Format of the data (default auto, NDJSON when it starts with an object)\n");
+    printf("  --limit <rows>: Show only the first rows in sort order, overriding the layout's \"limit\" (0 for all)\n");
+    printf("  --page_size <rows>: Split the rows into pages of this many rows, repeating the headers on each page\n");
+    printf("  --page <number>: Show only this page, counting from 1, with widths and summaries of all rows\n");
+    printf("  --threads <count>: Number of threads formatting and measuring rows (default: number of cores)\n");
+    printf("  --watch <seconds>: Render the table again every few seconds and on SIGHUP, repainting changed lines (0 for SIGHUP only)\n");
+    printf("  --profile: Print the time of each phase and counts of rows, cells, commands and bytes as JSON to stderr\n");
     printf("  --version: Display version information\n");
     printf("  --help, -h: Show this help message\n");
 }
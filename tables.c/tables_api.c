@@ -0,0 +1,195 @@
+/*
+ * tables_api.c - Implementation of rendering tables from rows held in memory
+ * Rows pushed by the caller are copied into the arena and parsed into the column store as they
+ * arrive, exactly as rows loaded from a JSON file are, so the rest of the run is shared with the
+ * tables command: sorting, the limit, summaries and subtotals, and rendering.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tables_api.h"
+#include "tables_config.h"
+#include "tables_data.h"
+#include "tables_render.h"
+#include "tables_render_buffer.h"
+#include "tables_themes.h"
+#include "tables_commands.h"
+#include "tables_select.h"
+#include "tables_profile.h"
+
+/* Number of rows a table is first allocated for, doubling as rows are pushed */
+#define TABLES_INITIAL_ROWS 256
+
+/* Flags read throughout the library, set by the tables command line or through the setters */
+int tables_debug_mode = 0;
+int tables_debug_layout = 0;
+
+/* Structure behind the opaque layout handle of the interface */
+struct TablesLayout {
+    TableConfig config;     /* Parsed layout with its theme */
+};
+
+static TableConfig *table_config = NULL;   /* Layout of the table begun, NULL when none is */
+static TableData table_data;
+static int row_capacity = 0;                /* Rows table_data.rows and its column store hold */
+static int push_failed = 0;                 /* A row could not be added, so the table is not rendered */
+
+/*
+ * Parse a layout file and select its theme, returning NULL on failure
+ * The layout is released with tables_free_layout() once no more tables use it
+ */
+TablesLayout *tables_load_layout(const char *filename) {
+    TablesLayout *layout = malloc(sizeof(TablesLayout));
+    if (layout == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for layout %s\n", filename);
+        return NULL;
+    }
+    if (parse_layout_file(filename, &layout->config) != 0) {
+        fprintf(stderr, "Error: Failed to parse layout file %s\n", filename);
+        free(layout);
+        return NULL;
+    }
+    get_theme(&layout->config);
+    return layout;
+}
+
+/*
+ * Release a layout returned by tables_load_layout()
+ */
+void tables_free_layout(TablesLayout *layout) {
+    if (layout == NULL) return;
+    free_table_config(&layout->config);
+    free(layout);
+}
+
+/*
+ * Turn on debug messages on stderr, as --debug does
+ */
+void tables_set_debug(int enabled) {
+    tables_debug_mode = enabled;
+}
+
+/*
+ * Turn on debug messages about the layout of rendered tables, as --debug_layout does
+ */
+void tables_set_debug_layout(int enabled) {
+    tables_debug_layout = enabled;
+}
+
+/*
+ * Pass the rendered tables to writer instead of stdout, NULL going back to stdout
+ */
+void tables_set_writer(TablesWriter writer, void *context) {
+    output_set_writer(writer, context);
+}
+
+/*
+ * Begin a table of the given layout, whose rows are then pushed with tables_push_row()
+ * The $() commands of the title and footer are started here, so they run while rows are pushed
+ */
+int tables_begin(TablesLayout *layout) {
+    TableConfig *config = &layout->config;
+    if (table_config != NULL) {
+        fprintf(stderr, "Error: tables_begin() called before the previous table ended\n");
+        return 1;
+    }
+    profile_add(PROFILE_TABLES, 1);
+    commands_start(config);
+    if (allocate_table_data(config, &table_data, TABLES_INITIAL_ROWS) != 0) {
+        release_run_memory();
+        return 1;
+    }
+    table_data.row_count = 0;
+    row_capacity = TABLES_INITIAL_ROWS;
+    push_failed = 0;
+    table_config = config;
+    return 0;
+}
+
+/*
+ * Helper function to make room for one more row, doubling the rows and the column store
+ */
+static int grow_rows(void) {
+    if (table_data.row_count < row_capacity) return 0;
+    int capacity = row_capacity * 2;
+    DataRow *rows = realloc(table_data.rows, capacity * sizeof(DataRow));
+    if (rows == NULL) {
+        fprintf(stderr, "Error: Memory reallocation failed for data rows\n");
+        return 1;
+    }
+    table_data.rows = rows;
+    if (grow_column_store(table_config, &table_data, capacity) != 0) return 1;
+    row_capacity = capacity;
+    return 0;
+}
+
+/*
+ * Add a row to the table begun, values holding count strings in the order of the layout's columns
+ * The values are copied, NULL values and missing columns are shown as null values
+ */
+int tables_push_row(const char *const values[], int count) {
+    if (table_config == NULL) {
+        fprintf(stderr, "Error: tables_push_row() called without a table begun\n");
+        return 1;
+    }
+    ProfilePhase previous = profile_switch(PROFILE_LOAD);
+    DataRow *row = NULL;
+    if (grow_rows() == 0) {
+        row = &table_data.rows[table_data.row_count];
+        if (load_row_strings(table_config, values, count, row) != 0) row = NULL;
+    }
+    if (row == NULL) {
+        profile_switch(previous);
+        push_failed = 1;
+        return 1;
+    }
+    store_row_values(table_config, &table_data, table_data.row_count, row);
+    table_data.row_count++;
+    profile_switch(previous);
+    return 0;
+}
+
+/*
+ * Sort, summarize and render the rows pushed since tables_begin(), then release them
+ * Returns 1 without rendering if a row could not be added
+ */
+int tables_end(void) {
+    if (table_config == NULL) {
+        fprintf(stderr, "Error: tables_end() called without a table begun\n");
+        return 1;
+    }
+    TableConfig *config = table_config;
+    int status = push_failed;
+    if (status == 0) {
+        if (tables_debug_mode) {
+            fprintf(stderr, "Debug: %d rows pushed\n", table_data.row_count);
+        }
+
+        // Rows past the limit still count in the summaries when the layout asks for it
+        int limit = select_row_limit(config);
+        if (limit > 0 && table_data.row_count > limit && select_summarizes_all(config)) {
+            for (int i = 0; i < table_data.row_count; i++) {
+                accumulate_row_summaries(config, &table_data, &table_data.rows[i]);
+            }
+            table_data.summarized = 1;
+        }
+
+        profile_switch(PROFILE_SORT);
+        sort_data(config, &table_data);
+        if (limit > 0 && table_data.row_count > limit) {
+            table_data.row_count = limit;
+        }
+
+        profile_switch(PROFILE_PROCESS);
+        process_data_rows(config, &table_data);
+        render_table(config, &table_data);
+        profile_switch(PROFILE_NONE);
+    }
+
+    free_table_data(&table_data, config->column_count);
+    row_capacity = 0;
+    table_config = NULL;
+    release_run_memory();
+    return status;
+}
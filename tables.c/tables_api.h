@@ -0,0 +1,33 @@
+/*
+ * tables_api.h - Header file for rendering tables from rows held in memory
+ * This is the interface of libtables (make lib) for programs that collect their own rows: a
+ * layout is parsed once, then each table is begun, given its rows one at a time as strings in
+ * the order of the layout's columns, and rendered when it ends. The rows go through the same
+ * sorting, limits, summaries and rendering as data read from JSON, without writing or parsing
+ * any JSON. The rendered table is passed to a writer function, or written to stdout.
+ * Everything the interface declares is prefixed with tables_, and the layout is opaque, so
+ * this header needs nothing beyond the C library.
+ */
+
+#ifndef TABLES_API_H
+#define TABLES_API_H
+
+#include <stddef.h>
+
+/* Layout parsed from a layout file together with its theme */
+typedef struct TablesLayout TablesLayout;
+
+/* Receives each block of the rendered table, NULL writing to stdout */
+typedef void (*TablesWriter)(void *context, const char *data, size_t length);
+
+/* Function prototypes */
+TablesLayout *tables_load_layout(const char *filename);
+void tables_free_layout(TablesLayout *layout);
+void tables_set_debug(int enabled);
+void tables_set_debug_layout(int enabled);
+void tables_set_writer(TablesWriter writer, void *context);
+int tables_begin(TablesLayout *layout);
+int tables_push_row(const char *const values[], int count);
+int tables_end(void);
+
+#endif /* TABLES_API_H */
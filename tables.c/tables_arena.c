@@ -0,0 +1,227 @@
+/*
+ * tables_arena.c - Implementation of the arena allocator used for per-run table strings
+ * Memory is handed out from large chunks by bumping an offset. Nothing is freed individually:
+ * a mark/reset pair drops everything allocated in between (used per row when streaming),
+ * and arena_release returns all chunks at the end of the run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "tables_arena.h"
+
+/* Alignment used for allocations that may hold pointers or numbers */
+#define ARENA_ALIGNMENT sizeof(void *)
+
+static Arena default_arena;
+static ArenaTotals released_usage;  /* Usage of the arenas released so far */
+
+/* Each thread selects its own arena, threads processing row blocks never use the default one */
+static __thread Arena *current_arena = &default_arena;
+
+/*
+ * Select the arena used by subsequent allocations of the calling thread, returning the previously selected one
+ * Passing NULL selects the default arena
+ */
+Arena *arena_use(Arena *arena) {
+    Arena *previous = current_arena;
+    current_arena = arena ? arena : &default_arena;
+    return previous;
+}
+
+/*
+ * Return the arena allocations are currently served from
+ */
+Arena *arena_current(void) {
+    return current_arena;
+}
+
+/*
+ * Helper function to make a chunk with at least size bytes current
+ * Chunks left over from an earlier reset are reused when large enough
+ */
+static ArenaChunk *arena_next_chunk(Arena *arena, size_t size) {
+    ArenaChunk *next = arena->current ? arena->current->next : arena->first;
+    if (next && next->size >= size) {
+        next->used = 0;
+        arena->current = next;
+        return next;
+    }
+
+    size_t chunk_size = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+    ArenaChunk *chunk = malloc(sizeof(ArenaChunk) + chunk_size);
+    if (chunk == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for arena chunk of %zu bytes\n", chunk_size);
+        return NULL;
+    }
+    chunk->size = chunk_size;
+    chunk->used = 0;
+    chunk->next = next;
+    if (arena->current) {
+        arena->current->next = chunk;
+    } else {
+        arena->first = chunk;
+    }
+    arena->current = chunk;
+    arena->bytes_reserved += chunk_size;
+    arena->chunk_count++;
+    return chunk;
+}
+
+/*
+ * Helper function to hand out size bytes from the current arena at the given alignment
+ */
+static void *arena_take(size_t size, size_t alignment) {
+    Arena *arena = current_arena;
+    ArenaChunk *chunk = arena->current;
+    size_t offset = 0;
+    if (chunk) {
+        offset = (chunk->used + alignment - 1) & ~(alignment - 1);
+    }
+    if (chunk == NULL || offset + size > chunk->size) {
+        chunk = arena_next_chunk(arena, size);
+        if (chunk == NULL) return NULL;
+        offset = 0;
+    }
+    arena->bytes_used += (offset - chunk->used) + size;
+    if (arena->bytes_used > arena->peak_bytes) arena->peak_bytes = arena->bytes_used;
+    arena->allocations++;
+    arena->bytes_allocated += size;
+    chunk->used = offset + size;
+    return chunk->data + offset;
+}
+
+/*
+ * Allocate memory from the current arena, aligned for pointers and numbers
+ */
+void *arena_alloc(size_t size) {
+    return arena_take(size, ARENA_ALIGNMENT);
+}
+
+/*
+ * Allocate zeroed memory for an array from the current arena
+ */
+void *arena_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void *ptr = arena_alloc(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+/*
+ * Grow an arena allocation, extending it in place when it is the most recent one
+ */
+void *arena_realloc(void *ptr, size_t old_size, size_t new_size) {
+    if (ptr == NULL) return arena_alloc(new_size);
+    if (new_size <= old_size) return ptr;
+
+    Arena *arena = current_arena;
+    ArenaChunk *chunk = arena->current;
+    if (chunk && (char *)ptr + old_size == chunk->data + chunk->used &&
+        (size_t)((char *)ptr - chunk->data) + new_size <= chunk->size) {
+        arena->bytes_used += new_size - old_size;
+        if (arena->bytes_used > arena->peak_bytes) arena->peak_bytes = arena->bytes_used;
+        arena->bytes_allocated += new_size - old_size;
+        chunk->used += new_size - old_size;
+        return ptr;
+    }
+
+    void *new_ptr = arena_alloc(new_size);
+    if (new_ptr) memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+/*
+ * Duplicate a string into the current arena, returning NULL if input is NULL
+ */
+char *arena_strdup(const char *str) {
+    if (str == NULL) return NULL;
+    return arena_strndup(str, strlen(str));
+}
+
+/*
+ * Duplicate the first length bytes of a string into the current arena
+ */
+char *arena_strndup(const char *str, size_t length) {
+    char *dup = arena_take(length + 1, 1);
+    if (dup == NULL) return NULL;
+    memcpy(dup, str, length);
+    dup[length] = '\0';
+    return dup;
+}
+
+/*
+ * Remember the current position of the current arena
+ */
+ArenaMark arena_mark(void) {
+    ArenaMark mark;
+    mark.chunk = current_arena->current;
+    mark.used = mark.chunk ? mark.chunk->used : 0;
+    mark.bytes_used = current_arena->bytes_used;
+    return mark;
+}
+
+/*
+ * Release everything allocated in the current arena since the mark was taken
+ * The chunks stay allocated and are reused by later allocations
+ */
+void arena_reset(ArenaMark mark) {
+    Arena *arena = current_arena;
+    if (mark.chunk == NULL) {
+        arena->current = NULL;
+        if (arena->first) {
+            // Start over in the first chunk
+            arena->current = arena->first;
+            arena->first->used = 0;
+        }
+    } else {
+        arena->current = mark.chunk;
+        mark.chunk->used = mark.used;
+    }
+    arena->bytes_used = mark.bytes_used;
+}
+
+/*
+ * Helper function to add the usage of an arena to totals
+ */
+static void add_arena_usage(ArenaTotals *totals, const Arena *arena) {
+    totals->allocations += arena->allocations;
+    totals->bytes_allocated += arena->bytes_allocated;
+    totals->bytes_reserved += arena->bytes_reserved;
+    totals->chunk_count += arena->chunk_count;
+    if (arena->peak_bytes > totals->peak_bytes) totals->peak_bytes = arena->peak_bytes;
+}
+
+/*
+ * Free all chunks of an arena, keeping its usage for arena_totals()
+ */
+void arena_release(Arena *arena) {
+    if (arena == NULL) arena = current_arena;
+    add_arena_usage(&released_usage, arena);
+    ArenaChunk *chunk = arena->first;
+    while (chunk) {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    memset(arena, 0, sizeof(Arena));
+}
+
+/*
+ * Print arena usage statistics to stderr, used to size ARENA_CHUNK_SIZE
+ */
+void arena_report(Arena *arena, const char *label) {
+    if (arena == NULL) arena = current_arena;
+    fprintf(stderr, "Debug: Arena %s: %zu bytes in use, peak %zu bytes, %zu bytes reserved in %d chunks\n",
+            label ? label : "usage", arena->bytes_used, arena->peak_bytes, arena->bytes_reserved, arena->chunk_count);
+}
+
+/*
+ * Add up the usage of every arena released so far and of the current arena
+ * Arenas are released by the thread that owns them or once their threads are done
+ */
+void arena_totals(ArenaTotals *totals) {
+    *totals = released_usage;
+    add_arena_usage(totals, current_arena);
+}
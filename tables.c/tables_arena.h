@@ -0,0 +1,65 @@
+/*
+ * tables_arena.h - Header file for the arena allocator used for per-run table strings
+ * Defines the arena structures and the allocation functions that replace malloc/strdup/free
+ * for row values and formatted text. Everything is released in one go at the end of a run.
+ */
+
+#ifndef TABLES_ARENA_H
+#define TABLES_ARENA_H
+
+#include <stddef.h>
+
+/* Default size of a chunk, larger allocations get a chunk of their own */
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+/* Structure holding one block of arena memory */
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;    /* Next chunk, kept after a reset so it can be reused */
+    size_t size;                /* Usable size of data */
+    size_t used;                /* Number of bytes handed out from data */
+    char data[];                /* Chunk memory */
+} ArenaChunk;
+
+/* Structure holding the state of an arena */
+typedef struct {
+    ArenaChunk *first;          /* First chunk in the list */
+    ArenaChunk *current;        /* Chunk allocations are currently served from */
+    size_t bytes_used;          /* Bytes currently handed out */
+    size_t peak_bytes;          /* Largest value bytes_used reached */
+    size_t bytes_reserved;      /* Total size of all chunks */
+    int chunk_count;            /* Number of chunks allocated */
+    size_t allocations;         /* Number of allocations served */
+    size_t bytes_allocated;     /* Total bytes of all allocations served */
+} Arena;
+
+/* Structure adding up the usage of every arena released so far and of the current one */
+typedef struct {
+    size_t allocations;         /* Number of allocations served */
+    size_t bytes_allocated;     /* Total bytes of all allocations served */
+    size_t bytes_reserved;      /* Total size of all chunks */
+    size_t peak_bytes;          /* Largest peak of any arena */
+    int chunk_count;            /* Number of chunks allocated */
+} ArenaTotals;
+
+/* Position in an arena that it can be reset to, releasing everything allocated after it */
+typedef struct {
+    ArenaChunk *chunk;          /* Chunk that was current when the mark was taken */
+    size_t used;                /* Bytes used in that chunk */
+    size_t bytes_used;          /* Bytes used in the whole arena */
+} ArenaMark;
+
+/* Function prototypes */
+Arena *arena_use(Arena *arena);
+Arena *arena_current(void);
+void *arena_alloc(size_t size);
+void *arena_calloc(size_t count, size_t size);
+void *arena_realloc(void *ptr, size_t old_size, size_t new_size);
+char *arena_strdup(const char *str);
+char *arena_strndup(const char *str, size_t length);
+ArenaMark arena_mark(void);
+void arena_reset(ArenaMark mark);
+void arena_release(Arena *arena);
+void arena_report(Arena *arena, const char *label);
+void arena_totals(ArenaTotals *totals);
+
+#endif /* TABLES_ARENA_H */
@@ -0,0 +1,451 @@
+/*
+ * tables_commands.c - Implementation of running the $() commands of titles and footers
+ * Commands are started with posix_spawn(), so no copy of this process is made. A command without
+ * shell syntax is run directly as its words, others and commands that are not programs (such as
+ * shell builtins) are run by /bin/sh. Each has stdin from /dev/null and stdout read through a
+ * pipe, and all run at once, each in a process group of its own, so a command exceeding
+ * "command_timeout" can be stopped along with anything it started. Cached output is stored under
+ * $XDG_CACHE_HOME/tables or ~/.cache/tables, in one file per command holding the command and its output.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "tables_commands.h"
+#include "tables_profile.h"
+
+extern int tables_debug_mode;
+extern char **environ;
+
+/* Characters that give a command shell syntax, so it has to be run by /bin/sh */
+#define SHELL_SYNTAX "|&;<>()$`\\\"'*?[]#~={}!\n"
+
+/* Words a command run without the shell may have, longer commands are run by /bin/sh */
+#define COMMAND_MAX_WORDS 64
+
+/* Structure holding one distinct command and what is known of its output */
+typedef struct {
+    char *command;          /* Command text found between $( and ) */
+    char *output;           /* Output without its trailing newline, or output read so far */
+    size_t length;          /* Bytes of output */
+    size_t capacity;        /* Allocated size of output */
+    pid_t pid;              /* Process running the command while fd is open */
+    int fd;                 /* Read end of the pipe, -1 once the command is done */
+    double deadline;        /* Time the command is stopped at, 0 for no limit */
+} DynamicCommand;
+
+static DynamicCommand *commands = NULL; /* Distinct commands seen in this run */
+static int command_count = 0;
+static int command_capacity = 0;
+static double command_timeout = 0;      /* Seconds a command may run, 0 for no limit */
+static int cache_seconds = 0;           /* Seconds cached output stays valid, 0 for no cache */
+
+/*
+ * Helper function to return the current time in seconds
+ */
+static double now_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*
+ * Build the path of a file in the cache directory, named by a hash of name plus suffix
+ * Returns 0 on success. When dir is given, it receives the directory holding the file
+ */
+int cache_file_path(const char *name, const char *suffix, char *path, size_t size, char *dir) {
+    char base[4096];
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    if (xdg && *xdg) {
+        snprintf(base, sizeof(base), "%s/tables", xdg);
+    } else if (home && *home) {
+        snprintf(base, sizeof(base), "%s/.cache/tables", home);
+    } else {
+        return 1;
+    }
+
+    // FNV-1a hash of the name names the file, which also stores the name itself
+    unsigned long long hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        hash = (hash ^ *p) * 1099511628211ULL;
+    }
+    if (dir) strcpy(dir, base);
+    return snprintf(path, size, "%s/%016llx%s", base, hash, suffix) >= (int)size;
+}
+
+/*
+ * Create the cache directory returned by cache_file_path() and its parent (~/.cache) when missing
+ */
+void cache_create_directory(char *dir) {
+    char *slash = strrchr(dir, '/');
+    if (slash && slash != dir) {
+        *slash = '\0';
+        mkdir(dir, 0700);
+        *slash = '/';
+    }
+    mkdir(dir, 0700);
+}
+
+/*
+ * Helper function to load the cached output of a command, returning 0 if it is still valid
+ */
+static int cache_read(DynamicCommand *cmd) {
+    char path[4200];
+    struct stat info;
+    if (cache_file_path(cmd->command, "", path, sizeof(path), NULL) != 0) return 1;
+    if (stat(path, &info) != 0 || time(NULL) - info.st_mtime >= cache_seconds) return 1;
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) return 1;
+    size_t command_length = strlen(cmd->command) + 1;
+    size_t size = (size_t)info.st_size;
+    char *contents = malloc(size + 1);
+    int status = 1;
+    if (contents && size >= command_length && fread(contents, 1, size, fp) == size &&
+        memcmp(contents, cmd->command, command_length) == 0) {
+        memmove(contents, contents + command_length, size - command_length);
+        contents[size - command_length] = '\0';
+        cmd->output = contents;
+        cmd->length = size - command_length;
+        contents = NULL;
+        status = 0;
+    }
+    free(contents);
+    fclose(fp);
+    if (status == 0 && tables_debug_mode) {
+        fprintf(stderr, "Debug: Using cached output of command '%s'\n", cmd->command);
+    }
+    return status;
+}
+
+/*
+ * Helper function to store the output of a command in the cache, replacing the file at once
+ */
+static void cache_write(const DynamicCommand *cmd) {
+    char path[4200], dir[4096], temp[4300];
+    if (cache_file_path(cmd->command, "", path, sizeof(path), dir) != 0) return;
+    cache_create_directory(dir);
+
+    snprintf(temp, sizeof(temp), "%s.%ld", path, (long)getpid());
+    FILE *fp = fopen(temp, "wb");
+    if (fp == NULL) {
+        if (tables_debug_mode) fprintf(stderr, "Debug: Cannot write command cache %s\n", temp);
+        return;
+    }
+    int failed = fwrite(cmd->command, 1, strlen(cmd->command) + 1, fp) != strlen(cmd->command) + 1 ||
+                 fwrite(cmd->output, 1, cmd->length, fp) != cmd->length;
+    if (fclose(fp) != 0 || failed || rename(temp, path) != 0) {
+        if (tables_debug_mode) fprintf(stderr, "Debug: Cannot write command cache %s\n", path);
+        unlink(temp);
+    }
+}
+
+/*
+ * Helper function to split a command without shell syntax into its words, returning the count
+ * Returns 0 when the command has shell syntax or too many words, and has to be run by /bin/sh
+ */
+static int split_command(char *words, char **argv) {
+    if (strpbrk(words, SHELL_SYNTAX) != NULL) return 0;
+    int count = 0;
+    for (char *word = strtok(words, " \t"); word; word = strtok(NULL, " \t")) {
+        if (count == COMMAND_MAX_WORDS) return 0;
+        argv[count++] = word;
+    }
+    argv[count] = NULL;
+    return count;
+}
+
+/*
+ * Helper function to start a command with its output connected to a pipe
+ * A command that cannot be started is treated as having no output
+ */
+static void spawn_command(DynamicCommand *cmd) {
+    int fds[2];
+    if (pipe(fds) != 0) return;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+    // The command gets stdin from /dev/null, the pipe as stdout, and signals as a shell would
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attributes;
+    sigset_t no_signals, default_signals;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    sigemptyset(&no_signals);
+    posix_spawnattr_setsigmask(&attributes, &no_signals);
+    sigemptyset(&default_signals);
+    sigaddset(&default_signals, SIGPIPE);
+    sigaddset(&default_signals, SIGCHLD);
+    posix_spawnattr_setsigdefault(&attributes, &default_signals);
+
+    pid_t pid = -1;
+    int direct = 0;
+    char *words = strdup(cmd->command);
+    char *argv[COMMAND_MAX_WORDS + 1];
+    if (words && split_command(words, argv) > 0) {
+        direct = posix_spawnp(&pid, argv[0], &actions, &attributes, argv, environ) == 0;
+    }
+    if (!direct) {
+        char *shell_argv[] = { "sh", "-c", cmd->command, NULL };
+        if (posix_spawn(&pid, "/bin/sh", &actions, &attributes, shell_argv, environ) != 0) pid = -1;
+    }
+    free(words);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        return;
+    }
+    profile_add(PROFILE_COMMANDS_RUN, 1);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Running command '%s' as process %ld%s\n", cmd->command, (long)pid, direct ? "" : " of /bin/sh");
+    }
+    cmd->pid = pid;
+    cmd->fd = fds[0];
+    cmd->deadline = command_timeout > 0 ? now_seconds() + command_timeout : 0;
+}
+
+/*
+ * Helper function to finish a command once its output is complete, or stop it when timed_out
+ * A stopped command is treated as having no output
+ */
+static void finish_command(DynamicCommand *cmd, int timed_out) {
+    int status = 0;
+    close(cmd->fd);
+    cmd->fd = -1;
+    if (timed_out) {
+        kill(-cmd->pid, SIGKILL);
+        kill(cmd->pid, SIGKILL);
+    }
+    while (waitpid(cmd->pid, &status, 0) < 0 && errno == EINTR) {
+    }
+
+    if (timed_out) {
+        cmd->length = 0;
+    } else if (cmd->length > 0 && cmd->output[cmd->length - 1] == '\n') {
+        cmd->length--;
+    }
+    if (cmd->output) {
+        cmd->output[cmd->length] = '\0';
+    }
+    if (!timed_out && cache_seconds > 0 && cmd->output && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        cache_write(cmd);
+    }
+}
+
+/*
+ * Helper function to read whatever output a command has available
+ */
+static void read_command(DynamicCommand *cmd) {
+    if (cmd->capacity - cmd->length < 1025) {
+        size_t capacity = cmd->capacity ? cmd->capacity * 2 : 4096;
+        char *output = realloc(cmd->output, capacity);
+        if (output == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for command output\n");
+            finish_command(cmd, 1);
+            return;
+        }
+        cmd->output = output;
+        cmd->capacity = capacity;
+    }
+    ssize_t count = read(cmd->fd, cmd->output + cmd->length, cmd->capacity - cmd->length - 1);
+    if (count > 0) {
+        cmd->length += (size_t)count;
+    } else if (count == 0 || (errno != EINTR && errno != EAGAIN)) {
+        finish_command(cmd, 0);
+    }
+}
+
+/*
+ * Helper function to read the output of all running commands until target is done
+ * Other commands keep running, and are read from while waiting so their pipes never fill up
+ */
+static void wait_for_command(DynamicCommand *target) {
+    struct pollfd *fds = malloc(command_count * sizeof(struct pollfd));
+    int *owners = malloc(command_count * sizeof(int));
+    if (fds == NULL || owners == NULL) {
+        free(fds);
+        free(owners);
+        finish_command(target, 1);
+        return;
+    }
+    ProfilePhase previous = profile_switch(PROFILE_COMMANDS);
+
+    while (target->fd >= 0) {
+        int count = 0;
+        double deadline = 0;
+        for (int i = 0; i < command_count; i++) {
+            if (commands[i].fd < 0) continue;
+            fds[count].fd = commands[i].fd;
+            fds[count].events = POLLIN;
+            fds[count].revents = 0;
+            owners[count++] = i;
+            if (commands[i].deadline > 0 && (deadline == 0 || commands[i].deadline < deadline)) {
+                deadline = commands[i].deadline;
+            }
+        }
+
+        int wait_ms = -1;
+        if (deadline > 0) {
+            double remaining = deadline - now_seconds();
+            if (remaining > 3600) remaining = 3600;
+            wait_ms = remaining > 0 ? (int)(remaining * 1000) + 1 : 0;
+        }
+        int ready = poll(fds, count, wait_ms);
+        if (ready < 0 && errno != EINTR) break;
+
+        double now = now_seconds();
+        for (int i = 0; i < count; i++) {
+            DynamicCommand *cmd = &commands[owners[i]];
+            if (ready > 0 && fds[i].revents) {
+                read_command(cmd);
+            } else if (cmd->deadline > 0 && now >= cmd->deadline) {
+                fprintf(stderr, "Warning: Command '%s' stopped after %g seconds\n", cmd->command, command_timeout);
+                finish_command(cmd, 1);
+            }
+        }
+    }
+    free(fds);
+    free(owners);
+    if (target->fd >= 0) finish_command(target, 1);
+    profile_switch(previous);
+}
+
+/*
+ * Helper function to find a command, adding it when it has not been seen yet
+ */
+static DynamicCommand *find_command(const char *command, size_t length, int *added) {
+    for (int i = 0; i < command_count; i++) {
+        if (strncmp(commands[i].command, command, length) == 0 && commands[i].command[length] == '\0') {
+            *added = 0;
+            return &commands[i];
+        }
+    }
+
+    if (command_count == command_capacity) {
+        int capacity = command_capacity ? command_capacity * 2 : 8;
+        DynamicCommand *grown = realloc(commands, capacity * sizeof(DynamicCommand));
+        if (grown == NULL) return NULL;
+        commands = grown;
+        command_capacity = capacity;
+    }
+    DynamicCommand *cmd = &commands[command_count];
+    memset(cmd, 0, sizeof(DynamicCommand));
+    cmd->fd = -1;
+    cmd->command = malloc(length + 1);
+    if (cmd->command == NULL) return NULL;
+    memcpy(cmd->command, command, length);
+    cmd->command[length] = '\0';
+    command_count++;
+    *added = 1;
+    return cmd;
+}
+
+/*
+ * Helper function to add a command, starting it unless its cached output is still valid
+ */
+static DynamicCommand *add_command(const char *command, size_t length) {
+    int added = 0;
+    DynamicCommand *cmd = find_command(command, length, &added);
+    if (cmd && added && (cache_seconds <= 0 || cache_read(cmd) != 0)) {
+        spawn_command(cmd);
+    }
+    return cmd;
+}
+
+/*
+ * Start every distinct command found in the title and footer, to be collected when rendered
+ * Commands are found the same way evaluate_dynamic_string() finds them, from $( to the next )
+ */
+void commands_start(const TableConfig *config) {
+    command_timeout = config->command_timeout;
+    cache_seconds = config->cache_seconds;
+
+    const char *texts[] = { config->title, config->footer };
+    for (int t = 0; t < 2; t++) {
+        const char *current = texts[t];
+        while (current && *current) {
+            const char *start = strstr(current, "$(");
+            if (start == NULL) break;
+            const char *end = strchr(start + 2, ')');
+            if (end == NULL) break;
+            add_command(start + 2, end - start - 2);
+            current = end + 1;
+        }
+    }
+}
+
+/*
+ * Return the output of a command, waiting for it to finish if it is still running
+ * Commands not seen by commands_start() are run now, and every output is kept for the run
+ */
+const char *commands_output(const char *command) {
+    DynamicCommand *cmd = add_command(command, strlen(command));
+    if (cmd == NULL) return "";
+    if (cmd->fd >= 0) {
+        wait_for_command(cmd);
+    }
+    return cmd->output ? cmd->output : "";
+}
+
+/*
+ * Return the value of a ${name} variable of a title or footer, without running any process
+ * Variables of the layout's "vars" were replaced when it was parsed. Others are looked up in the
+ * environment, then HOSTNAME, DATE and TIME are the host name and the local date and time, and
+ * any other name is empty, as in the shell. The value is valid until the next call
+ */
+const char *commands_variable(const char *name) {
+    static char value[256];
+    const char *environment = getenv(name);
+    if (environment) return environment;
+
+    time_t now = time(NULL);
+    struct tm local;
+    value[0] = '\0';
+    if (strcmp(name, "HOSTNAME") == 0) {
+        if (gethostname(value, sizeof(value)) != 0) value[0] = '\0';
+        value[sizeof(value) - 1] = '\0';
+    } else if (strcmp(name, "DATE") == 0 && localtime_r(&now, &local)) {
+        strftime(value, sizeof(value), "%Y-%m-%d", &local);
+    } else if (strcmp(name, "TIME") == 0 && localtime_r(&now, &local)) {
+        strftime(value, sizeof(value), "%H:%M:%S", &local);
+    }
+    return value;
+}
+
+/*
+ * Stop commands whose output was never needed and release all stored output
+ */
+void commands_release(void) {
+    for (int i = 0; i < command_count; i++) {
+        if (commands[i].fd >= 0) {
+            close(commands[i].fd);
+            kill(-commands[i].pid, SIGKILL);
+            kill(commands[i].pid, SIGKILL);
+            while (waitpid(commands[i].pid, NULL, 0) < 0 && errno == EINTR) {
+            }
+        }
+        free(commands[i].command);
+        free(commands[i].output);
+    }
+    free(commands);
+    commands = NULL;
+    command_count = 0;
+    command_capacity = 0;
+}
@@ -0,0 +1,22 @@
+/*
+ * tables_commands.h - Header file for running the $() commands of titles and footers
+ * Every distinct command is run once per run, concurrently with the others and with loading the
+ * data, and its output is kept for all later evaluations. Output can also be cached on disk
+ * across runs for the number of seconds given by "cache_seconds" in the layout. ${name} variables
+ * are resolved in this process, so common values need no command at all.
+ */
+
+#ifndef TABLES_COMMANDS_H
+#define TABLES_COMMANDS_H
+
+#include "tables_config.h"
+
+/* Function prototypes */
+void commands_start(const TableConfig *config);
+const char *commands_output(const char *command);
+const char *commands_variable(const char *name);
+void commands_release(void);
+int cache_file_path(const char *name, const char *suffix, char *path, size_t size, char *dir);
+void cache_create_directory(char *dir);
+
+#endif /* TABLES_COMMANDS_H */
@@ -7,8 +7,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
+#include <unistd.h>
 #include <jansson.h>
 #include "tables_config.h"
+#include "tables_input.h"
+#include "tables_projection.h"
+#include "tables_layout_cache.h"
 
 /*
  * Helper function to duplicate a string, returning NULL if input is NULL
@@ -67,11 +72,63 @@ static SummaryType parse_summary_type(const char *str) {
     if (strcasecmp(str, "avg") == 0) return SUMMARY_AVG;
     if (strcasecmp(str, "count") == 0) return SUMMARY_COUNT;
     if (strcasecmp(str, "unique") == 0) return SUMMARY_UNIQUE;
+    if (strcasecmp(str, "unique~") == 0) return SUMMARY_UNIQUE_APPROX;
     if (strcasecmp(str, "blanks") == 0) return SUMMARY_BLANKS;
     if (strcasecmp(str, "nonblanks") == 0) return SUMMARY_NONBLANKS;
     return SUMMARY_NONE;
 }
 
+/*
+ * Helper function to replace each ${name} of the layout's "vars" in text, returning the length
+ * The result is written to out when given, so the length can be found first
+ */
+static size_t replace_layout_vars(const char *text, json_t *vars, char *out) {
+    size_t length = 0;
+    const char *p = text;
+    while (*p) {
+        const char *end = (p[0] == '$' && p[1] == '{') ? strchr(p + 2, '}') : NULL;
+        if (end) {
+            char name[128];
+            size_t name_length = end - p - 2;
+            json_t *var = NULL;
+            if (name_length > 0 && name_length < sizeof(name)) {
+                memcpy(name, p + 2, name_length);
+                name[name_length] = '\0';
+                var = json_object_get(vars, name);
+            }
+            if (json_is_string(var)) {
+                size_t value_length = strlen(json_string_value(var));
+                if (out) memcpy(out + length, json_string_value(var), value_length);
+                length += value_length;
+                p = end + 1;
+                continue;
+            }
+        }
+        if (out) out[length] = *p;
+        length++;
+        p++;
+    }
+    if (out) out[length] = '\0';
+    return length;
+}
+
+/*
+ * Helper function to copy a title or footer with the variables of the layout's "vars" replaced
+ * Other ${name} variables are kept, to be resolved when the text is rendered
+ */
+static char *expand_layout_vars(const char *text, json_t *vars) {
+    if (text == NULL) return NULL;
+    if (!json_is_object(vars) || strstr(text, "${") == NULL) return strdup_safe(text);
+
+    char *expanded = malloc(replace_layout_vars(text, vars, NULL) + 1);
+    if (expanded == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
+        return NULL;
+    }
+    replace_layout_vars(text, vars, expanded);
+    return expanded;
+}
+
 /*
  * Helper function to parse wrap mode string to enum
  */
@@ -94,163 +151,128 @@ static Position parse_position(const char *str) {
 }
 
 /*
- * Validate input files exist and are non-empty
+ * Validate input files exist and can be read, "-" standing for stdin
+ * Files are checked without opening them, so a named pipe is left for the actual read
  */
 int validate_input_files(const char *layout_file, const char *data_file) {
-    FILE *fp;
-    
-    fp = fopen(layout_file, "r");
-    if (fp == NULL) {
+    if (input_is_stdin(layout_file) && input_is_stdin(data_file)) {
+        fprintf(stderr, "Error: Only one of the layout and data files can be read from stdin\n");
+        return 1;
+    }
+    if (!input_is_stdin(layout_file) && access(layout_file, R_OK) != 0) {
         fprintf(stderr, "Error: Cannot open layout file %s\n", layout_file);
         return 1;
     }
-    fclose(fp);
-    
-    fp = fopen(data_file, "r");
-    if (fp == NULL) {
+    if (!input_is_stdin(data_file) && access(data_file, R_OK) != 0) {
         fprintf(stderr, "Error: Cannot open data file %s\n", data_file);
         return 1;
     }
-    fclose(fp);
     
     return 0;
 }
 
 /*
- * Parse layout JSON file into TableConfig structure
+ * Read and parse a layout JSON file, returning the root object or NULL on failure
+ * The caller releases the root with json_decref()
  */
-int parse_layout_file(const char *filename, TableConfig *config) {
+json_t *load_layout_file(const char *filename) {
     json_t *root;
     json_error_t error;
-    FILE *fp;
-    char *buffer = NULL;
-    size_t buffer_size = 0;
-    size_t total_read = 0;
-    size_t chunk_size = 1024;
-    extern int debug_mode;
+    size_t length = 0;
+    extern int tables_debug_mode;
     
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Starting to parse layout file %s\n", filename);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Starting to parse layout file %s\n", input_name(filename));
     }
     
-    fp = fopen(filename, "r");
-    if (fp == NULL) {
-        fprintf(stderr, "Error: Cannot open layout file %s\n", filename);
-        return 1;
-    }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Layout file %s opened successfully\n", filename);
-    }
-    
-    // Read file content into buffer
-    buffer = malloc(chunk_size + 1); // Extra byte for null terminator
+    char *buffer = read_input(filename, "layout", &length);
     if (buffer == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed for buffer\n");
-        fclose(fp);
-        return 1;
-    }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Allocated initial buffer of size %zu for layout file\n", chunk_size + 1);
-    }
-    buffer_size = chunk_size;
-    
-    while (1) {
-        size_t bytes_read = fread(buffer + total_read, 1, chunk_size, fp);
-        total_read += bytes_read;
-        if (debug_mode) {
-            fprintf(stderr, "Debug: Read %zu bytes, total read now %zu\n", bytes_read, total_read);
-        }
-        if (bytes_read < chunk_size) {
-            if (feof(fp)) {
-                if (debug_mode) {
-                    fprintf(stderr, "Debug: End of file reached\n");
-                }
-                break;
-            }
-            if (ferror(fp)) {
-                fprintf(stderr, "Error: Reading layout file %s\n", filename);
-                free(buffer);
-                fclose(fp);
-                return 1;
-            }
-        }
-        buffer_size += chunk_size;
-        char *new_buffer = realloc(buffer, buffer_size + 1); // Extra byte for null terminator
-        if (new_buffer == NULL) {
-            fprintf(stderr, "Error: Memory reallocation failed for buffer\n");
-            free(buffer);
-            fclose(fp);
-            return 1;
-        }
-        if (debug_mode) {
-            fprintf(stderr, "Debug: Reallocated buffer to size %zu for layout file\n", buffer_size + 1);
-        }
-        buffer = new_buffer;
-    }
-    fclose(fp);
-    
-    // Null-terminate the buffer
-    buffer[total_read] = '\0';
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Read %zu bytes from layout file, buffer null-terminated\n", total_read);
+        return NULL;
     }
     
     // Parse JSON
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Starting JSON parsing for layout file\n");
     }
-    root = json_loads(buffer, 0, &error);
-    if (debug_mode) {
+    root = json_loadb(buffer, length, 0, &error);
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: JSON parsing completed, freeing buffer\n");
     }
     free(buffer);
     if (root == NULL) {
-        fprintf(stderr, "Error: JSON parsing failed for %s: %s\n", filename, error.text);
-        return 1;
+        fprintf(stderr, "Error: JSON parsing failed for %s: %s\n", input_name(filename), error.text);
+        return NULL;
     }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: JSON layout parsed successfully from %s\n", filename);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: JSON layout parsed successfully from %s\n", input_name(filename));
     }
     
+    return root;
+}
+
+/*
+ * Parse a layout JSON root object into TableConfig structure
+ * The root is only read, so one parsed layout can configure several tables
+ */
+int parse_layout_json(json_t *root, TableConfig *config) {
+    extern int tables_debug_mode;
+
     // Initialize config structure
     memset(config, 0, sizeof(TableConfig));
     
     // Parse theme name
     json_t *theme_val = json_object_get(root, "theme");
     config->theme_name = strdup_safe(json_string_value(theme_val) ? json_string_value(theme_val) : "Red");
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Parsed theme_name as '%s'\n", config->theme_name ? config->theme_name : "NULL");
     }
     
+    // Variables of the layout, replaced in the title and footer now as they never change
+    json_t *vars = json_object_get(root, "vars");
+    if (vars && !json_is_object(vars)) {
+        fprintf(stderr, "Warning: \"vars\" is not an object of variable names and values, ignoring\n");
+    }
+    
     // Parse title and position
     json_t *title_val = json_object_get(root, "title");
-    config->title = strdup_safe(json_string_value(title_val));
-    if (debug_mode) {
+    config->title = expand_layout_vars(json_string_value(title_val), vars);
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Parsed title as '%s'\n", config->title ? config->title : "NULL");
     }
     json_t *title_pos_val = json_object_get(root, "title_position");
     config->title_pos = parse_position(json_string_value(title_pos_val));
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Parsed title_position as %d\n", config->title_pos);
     }
     
     // Parse footer and position
     json_t *footer_val = json_object_get(root, "footer");
-    config->footer = strdup_safe(json_string_value(footer_val));
-    if (debug_mode) {
+    config->footer = expand_layout_vars(json_string_value(footer_val), vars);
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Parsed footer as '%s'\n", config->footer ? config->footer : "NULL");
     }
     json_t *footer_pos_val = json_object_get(root, "footer_position");
     config->footer_pos = parse_position(json_string_value(footer_pos_val));
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Parsed footer_position as %d\n", config->footer_pos);
     }
+
+    // Parse the time limit and disk cache lifetime of $() commands in the title and footer
+    json_t *timeout_val = json_object_get(root, "command_timeout");
+    config->command_timeout = json_is_number(timeout_val) ? json_number_value(timeout_val) : 0;
+    if (config->command_timeout < 0) config->command_timeout = 0;
+    json_t *cache_val = json_object_get(root, "cache_seconds");
+    config->cache_seconds = json_is_integer(cache_val) && json_integer_value(cache_val) > 0 ?
+                            (int)json_integer_value(cache_val) : 0;
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Parsed command_timeout as %g and cache_seconds as %d\n",
+                config->command_timeout, config->cache_seconds);
+    }
     
     // Parse columns array
     json_t *columns_array = json_object_get(root, "columns");
     if (!json_is_array(columns_array) || json_array_size(columns_array) == 0) {
         fprintf(stderr, "Error: No columns defined in layout JSON\n");
-        json_decref(root);
         free_table_config(config);
         return 1;
     }
@@ -260,14 +282,13 @@ int parse_layout_file(const char *filename, TableConfig *config) {
         fprintf(stderr, "Warning: Too many columns, truncating to %d\n", MAX_COLUMNS);
         config->column_count = MAX_COLUMNS;
     }
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Configured %d columns for layout\n", config->column_count);
     }
     
     config->columns = malloc(config->column_count * sizeof(ColumnConfig));
     if (config->columns == NULL) {
         fprintf(stderr, "Error: Memory allocation failed for columns\n");
-        json_decref(root);
         free_table_config(config);
         return 1;
     }
@@ -283,7 +304,6 @@ int parse_layout_file(const char *filename, TableConfig *config) {
         col->header = strdup_safe(json_string_value(header_val));
         if (col->header == NULL || strlen(col->header) == 0) {
             fprintf(stderr, "Error: Column %d has no header\n", i);
-            json_decref(root);
             free_table_config(config);
             return 1;
         }
@@ -295,7 +315,6 @@ int parse_layout_file(const char *filename, TableConfig *config) {
             char *derived_key = strdup(col->header);
             if (derived_key == NULL) {
                 fprintf(stderr, "Error: Memory allocation failed for derived key\n");
-                json_decref(root);
                 free_table_config(config);
                 return 1;
             }
@@ -326,6 +345,9 @@ int parse_layout_file(const char *filename, TableConfig *config) {
         json_t *summary_val = json_object_get(col_obj, "summary");
         col->summary = parse_summary_type(json_string_value(summary_val));
         
+        json_t *subtotal_val = json_object_get(col_obj, "subtotal");
+        col->subtotal = parse_summary_type(json_string_value(subtotal_val));
+        
         json_t *break_val = json_object_get(col_obj, "break");
         col->break_on_change = json_is_true(break_val);
         
@@ -356,7 +378,6 @@ int parse_layout_file(const char *filename, TableConfig *config) {
         config->sorts = malloc(config->sort_count * sizeof(SortConfig));
         if (config->sorts == NULL && config->sort_count > 0) {
             fprintf(stderr, "Error: Memory allocation failed for sort config\n");
-            json_decref(root);
             free_table_config(config);
             return 1;
         }
@@ -383,48 +404,84 @@ int parse_layout_file(const char *filename, TableConfig *config) {
         config->sorts = NULL;
     }
     
+    // Parse the number of rows shown and which rows the summaries cover
+    json_t *limit_val = json_object_get(root, "limit");
+    config->limit = json_is_integer(limit_val) && json_integer_value(limit_val) > 0 &&
+                    json_integer_value(limit_val) <= INT_MAX ? (int)json_integer_value(limit_val) : 0;
+    json_t *limit_summaries_val = json_object_get(root, "limit_summaries");
+    const char *limit_summaries_str = json_string_value(limit_summaries_val);
+    config->limit_summaries = !(limit_summaries_str && strcasecmp(limit_summaries_str, "shown") == 0);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Parsed limit as %d with summaries of %s rows\n",
+                config->limit, config->limit_summaries ? "all" : "shown");
+    }
+    
+    // Compile the column keys once for all the rows read with this layout
+    if (projection_compile(config) != 0) {
+        free_table_config(config);
+        return 1;
+    }
+    
+    return 0;
+}
+
+/*
+ * Parse layout JSON file into TableConfig structure
+ */
+int parse_layout_file(const char *filename, TableConfig *config) {
+    extern int tables_debug_mode;
+    json_t *root = load_layout_file(filename);
+    if (root == NULL) {
+        return 1;
+    }
+    int status = parse_layout_json(root, config);
     json_decref(root);
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: JSON layout root object freed\n");
     }
-    return 0;
+    return status;
 }
 
 /*
  * Free memory allocated for TableConfig structure
  */
 void free_table_config(TableConfig *config) {
-    extern int debug_mode;
-    if (debug_mode) {
+    extern int tables_debug_mode;
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Starting to free TableConfig structure\n");
     }
+    if (config->image) {
+        // Everything but the compiled keys and borders lives in the image
+        layout_cache_unmap(config);
+        return;
+    }
     if (config->theme_name) {
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: About to free theme_name at address %p\n", (void*)config->theme_name);
         }
         free(config->theme_name);
         config->theme_name = NULL; // Set to NULL after freeing to prevent double-free
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: Freed theme_name\n");
         }
     }
     if (config->title) {
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: About to free title at address %p\n", (void*)config->title);
         }
         free(config->title);
         config->title = NULL; // Set to NULL after freeing to prevent double-free
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: Freed title\n");
         }
     }
     if (config->footer) {
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: About to free footer at address %p\n", (void*)config->footer);
         }
         free(config->footer);
         config->footer = NULL; // Set to NULL after freeing to prevent double-free
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: Freed footer\n");
         }
     }
@@ -434,31 +491,31 @@ void free_table_config(TableConfig *config) {
             ColumnConfig *col = &config->columns[i];
             if (col->header) {
                 free(col->header);
-                if (debug_mode) {
+                if (tables_debug_mode) {
                     fprintf(stderr, "Debug: Freed header for column %d\n", i);
                 }
             }
             if (col->key) {
                 free(col->key);
-                if (debug_mode) {
+                if (tables_debug_mode) {
                     fprintf(stderr, "Debug: Freed key for column %d\n", i);
                 }
             }
             if (col->format) {
                 free(col->format);
-                if (debug_mode) {
+                if (tables_debug_mode) {
                     fprintf(stderr, "Debug: Freed format for column %d\n", i);
                 }
             }
             if (col->wrap_char) {
                 free(col->wrap_char);
-                if (debug_mode) {
+                if (tables_debug_mode) {
                     fprintf(stderr, "Debug: Freed wrap_char for column %d\n", i);
                 }
             }
         }
         free(config->columns);
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: Freed columns array\n");
         }
     }
@@ -468,21 +525,29 @@ void free_table_config(TableConfig *config) {
             SortConfig *sort = &config->sorts[i];
             if (sort->key) {
                 free(sort->key);
-                if (debug_mode) {
+                if (tables_debug_mode) {
                     fprintf(stderr, "Debug: Freed key for sort %d\n", i);
                 }
             }
         }
         free(config->sorts);
-        if (debug_mode) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: Freed sorts array\n");
         }
     }
     
+    projection_free(config);
+    free(config->top_border.text);
+    free(config->separator.text);
+    free(config->bottom_border.text);
+    config->top_border.text = NULL;
+    config->separator.text = NULL;
+    config->bottom_border.text = NULL;
+
     // Reset counts
     config->column_count = 0;
     config->sort_count = 0;
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Completed freeing TableConfig structure\n");
     }
 }
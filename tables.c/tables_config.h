@@ -6,6 +6,7 @@
 #ifndef TABLES_CONFIG_H
 #define TABLES_CONFIG_H
 
+#include <stddef.h>
 #include <jansson.h>
 
 /* Constants */
@@ -46,6 +47,7 @@ typedef enum {
     SUMMARY_AVG,
     SUMMARY_COUNT,
     SUMMARY_UNIQUE,
+    SUMMARY_UNIQUE_APPROX,
     SUMMARY_BLANKS,
     SUMMARY_NONBLANKS
 } SummaryType;
@@ -68,13 +70,14 @@ typedef enum {
 /* Structure for column configuration */
 typedef struct {
     char *header;           /* Column header text */
-    char *key;              /* JSON field name */
+    char *key;              /* JSON field name, or a dotted path to a field of nested objects */
     Justification justify;  /* Text alignment */
     DataType data_type;     /* Data type for validation/formatting */
     ValueDisplay null_val;  /* Display option for null values */
     ValueDisplay zero_val;  /* Display option for zero values */
     char *format;           /* Custom format string */
     SummaryType summary;    /* Summary calculation type */
+    SummaryType subtotal;   /* Summary shown for each group of rows between breaks */
     int break_on_change;    /* Insert separator on value change */
     int string_limit;       /* Maximum string length */
     WrapMode wrap_mode;     /* Text wrapping behavior */
@@ -92,6 +95,13 @@ typedef struct {
     int priority;           /* Sort priority (lower number = higher priority) */
 } SortConfig;
 
+/* Structure holding the byte length of each string of a theme, see ThemeConfig */
+typedef struct {
+    unsigned char border_color, caption_color, header_color, footer_color, summary_color, text_color;
+    unsigned char tl_corner, tr_corner, bl_corner, br_corner, h_line, v_line;
+    unsigned char t_junct, b_junct, l_junct, r_junct, cross;
+} ThemeLengths;
+
 /* Structure for theme configuration */
 typedef struct {
     char *border_color;     /* ANSI color for borders */
@@ -111,8 +121,17 @@ typedef struct {
     char *l_junct;          /* Left junction character */
     char *r_junct;          /* Right junction character */
     char *cross;            /* Cross junction character */
+    ThemeLengths lengths;   /* Byte length of each string, so they are written without strlen() */
 } ThemeConfig;
 
+/* Structure for a border line rendered once the column widths are known */
+typedef struct {
+    char *text;             /* Complete line including colors and newline (NULL until built) */
+    size_t length;          /* Length of text in bytes */
+} BorderLine;
+
+struct Projection;
+
 /* Structure for overall table configuration */
 typedef struct {
     char *theme_name;       /* Name of the theme to use */
@@ -120,15 +139,27 @@ typedef struct {
     Position title_pos;     /* Title position */
     char *footer;           /* Table footer text */
     Position footer_pos;    /* Footer position */
+    double command_timeout; /* Seconds a $() command in the title or footer may run, 0 for no limit */
+    int cache_seconds;      /* Seconds the output of a $() command is cached on disk, 0 for no cache */
     ColumnConfig *columns;  /* Array of column configurations */
     int column_count;       /* Number of columns */
     SortConfig *sorts;      /* Array of sort configurations */
     int sort_count;         /* Number of sort rules */
+    int limit;              /* Number of rows shown, the first ones in sort order, 0 for all */
+    int limit_summaries;    /* Flag if summaries cover every row rather than only the rows shown */
     ThemeConfig theme;      /* Active theme settings */
+    BorderLine top_border;  /* Top border used when there is no title */
+    BorderLine separator;   /* Line below the headers, at breaks and above the summaries */
+    BorderLine bottom_border; /* Bottom border used when there is no footer */
+    struct Projection *projection; /* Column keys compiled for reading rows, see tables_projection.h */
+    void *image;            /* Mapped layout cache image holding the strings and arrays, NULL when parsed */
+    size_t image_size;      /* Size of the mapped image */
 } TableConfig;
 
 /* Function prototypes */
 int parse_layout_file(const char *filename, TableConfig *config);
+json_t *load_layout_file(const char *filename);
+int parse_layout_json(json_t *root, TableConfig *config);
 void free_table_config(TableConfig *config);
 int validate_input_files(const char *layout_file, const char *data_file);
 
@@ -9,13 +9,20 @@
 #include <jansson.h>
 #include <stdbool.h>
 #include "tables_data.h"
+#include "tables_arena.h"
+#include "tables_parallel.h"
+#include "tables_input.h"
+#include "tables_reader.h"
+#include "tables_projection.h"
+#include "tables_select.h"
+#include "tables_commands.h"
 
 /*
  * Helper function to duplicate a string, returning NULL if input is NULL
  */
 static char *strdup_safe(const char *str) {
     if (str == NULL) return NULL;
-    char *dup = strdup(str);
+    char *dup = arena_strdup(str);
     if (dup == NULL) {
         fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
         return NULL;
@@ -23,98 +30,75 @@ static char *strdup_safe(const char *str) {
     return dup;
 }
 
+/* Structure shared by the threads processing blocks of rows */
+typedef struct {
+    TableConfig *config;
+    TableData *data;
+    SummaryStats *block_summaries;  /* Summaries of each block, column_count per block */
+} RowBlockContext;
+
+/*
+ * Helper function to parse the values of one block of loaded rows into the column store
+ */
+static void store_row_block(void *context, int block, int start, int end) {
+    RowBlockContext *ctx = context;
+    (void)block;
+    for (int i = start; i < end; i++) {
+        store_row_values(ctx->config, ctx->data, i, &ctx->data->rows[i]);
+    }
+}
+
 /*
  * Load and prepare data from JSON file
  */
 int prepare_data(const char *data_file, TableConfig *config, TableData *data) {
-    json_t *root;
-    json_error_t error;
-    FILE *fp;
-    char *buffer = NULL;
-    size_t buffer_size = 0;
-    size_t total_read = 0;
-    size_t chunk_size = 1024;
-    extern int debug_mode;
-    
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Starting to load data from %s\n", data_file);
-    }
-    
-    fp = fopen(data_file, "r");
-    if (fp == NULL) {
-        fprintf(stderr, "Error: Cannot open data file %s\n", data_file);
-        return 1;
-    }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Data file %s opened successfully\n", data_file);
-    }
+    size_t length = 0;
+    extern int tables_debug_mode;
     
-    // Read file content into buffer
-    buffer_size = chunk_size;
-    buffer = malloc(buffer_size + 1); // Extra byte for null terminator
-    if (buffer == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed for buffer\n");
-        fclose(fp);
-        return 1;
-    }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Initial buffer allocated for reading data\n");
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Starting to load data from %s\n", input_name(data_file));
     }
     
-    while (1) {
-        size_t bytes_read = fread(buffer + total_read, 1, chunk_size, fp);
-        total_read += bytes_read;
-        if (bytes_read < chunk_size) {
-            if (feof(fp)) break;
-            if (ferror(fp)) {
-                fprintf(stderr, "Error: Reading data file %s\n", data_file);
-                free(buffer);
-                fclose(fp);
-                return 1;
-            }
-        }
-        buffer_size += chunk_size;
-        char *new_buffer = realloc(buffer, buffer_size + 1); // Extra byte for null terminator
-        if (new_buffer == NULL) {
-            fprintf(stderr, "Error: Memory reallocation failed for buffer\n");
-            free(buffer);
-            fclose(fp);
+    // With a limit the rows are read one at a time, keeping only those that can be shown
+    if (select_row_limit(config) > 0) {
+        FILE *fp = input_open(data_file);
+        if (fp == NULL) {
+            fprintf(stderr, "Error: Cannot open data file %s\n", data_file);
             return 1;
         }
-        buffer = new_buffer;
-    }
-    fclose(fp);
-    
-    // Null-terminate the buffer
-    buffer[total_read] = '\0';
-    
-    // Parse JSON
-    root = json_loads(buffer, 0, &error);
-    free(buffer);
-    if (root == NULL) {
-        fprintf(stderr, "Error: JSON parsing failed for %s: %s\n", data_file, error.text);
-        return 1;
-    }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: JSON data parsed successfully from %s\n", data_file);
+        JsonArrayReader reader;
+        json_array_reader_init_file(&reader, fp);
+        int status = select_rows(&reader, input_name(data_file), config, data);
+        json_array_reader_free(&reader);
+        input_close(fp);
+        return status;
     }
     
-    if (!json_is_array(root)) {
-        fprintf(stderr, "Error: Data JSON root must be an array\n");
-        json_decref(root);
+    char *buffer = read_input(data_file, "data", &length);
+    if (buffer == NULL) {
         return 1;
     }
     
+    int status = prepare_data_buffer(buffer, length, input_name(data_file), config, data);
+    free(buffer);
+    return status;
+}
+
+/*
+ * Allocate the rows, summaries and column store of row_count rows
+ */
+int allocate_table_data(TableConfig *config, TableData *data, int row_count) {
+    extern int tables_debug_mode;
+
     // Initialize TableData structure
     memset(data, 0, sizeof(TableData));
-    data->row_count = json_array_size(root);
+    data->row_count = row_count;
     data->rows = malloc(data->row_count * sizeof(DataRow));
     if (data->rows == NULL && data->row_count > 0) {
         fprintf(stderr, "Error: Memory allocation failed for data rows\n");
-        json_decref(root);
         return 1;
     }
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Allocated memory for %d data rows\n", data->row_count);
     }
     
@@ -123,61 +107,344 @@ int prepare_data(const char *data_file, TableConfig *config, TableData *data) {
     if (data->summaries == NULL) {
         fprintf(stderr, "Error: Memory allocation failed for summaries\n");
         free(data->rows);
-        json_decref(root);
+        data->rows = NULL;
         return 1;
     }
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: Allocated memory for summaries of %d columns\n", config->column_count);
     }
     
     // Initialize summaries
     initialize_summaries(config, data);
+    if (init_column_store(config, data, data->row_count) != 0) {
+        free_table_data(data, config->column_count);
+        return 1;
+    }
+    return 0;
+}
+
+/* Structure shared by the threads loading blocks of rows from their JSON text */
+typedef struct {
+    TableConfig *config;
+    TableData *data;
+    const char **texts;     /* Text of each row, pointing into the data buffer */
+    size_t *lengths;        /* Length of each row's text */
+    int *failed;            /* First row of each block that could not be loaded, -1 if none */
+    json_error_t *errors;   /* Parse error of each block's failed row */
+} RowTextContext;
+
+/*
+ * Helper function to load one block of rows from their text, stopping at the first bad row
+ */
+static void load_row_text_block(void *context, int block, int start, int end) {
+    RowTextContext *ctx = context;
+    ctx->failed[block] = -1;
+    for (int i = start; i < end; i++) {
+        if (load_row_text(ctx->config, ctx->texts[i], ctx->lengths[i], &ctx->data->rows[i], &ctx->errors[block]) != 0) {
+            ctx->failed[block] = i;
+            return;
+        }
+        store_row_values(ctx->config, ctx->data, i, &ctx->data->rows[i]);
+    }
+}
+
+/*
+ * Helper function to load the rows of a JSON array or of NDJSON text
+ * The rows are found in one pass over the text and then loaded a block of rows per thread,
+ * each row scanned for the fields of the layout's columns only. Errors in a JSON array are
+ * left to the caller, which parses the whole document to report them
+ */
+static int prepare_row_texts(const char *buffer, size_t length, const char *source, int ndjson, TableConfig *config, TableData *data) {
+    extern int tables_debug_mode;
+    JsonArrayReader reader;
+    json_array_reader_init_buffer(&reader, buffer, length);
+    reader.quiet = !ndjson;
+
+    int capacity = 1024;
+    int count = 0;
+    const char **texts = malloc(capacity * sizeof(const char *));
+    size_t *lengths = malloc(capacity * sizeof(size_t));
+    long *lines = malloc(capacity * sizeof(long));
+    int status = texts && lengths && lines ? 0 : 1;
+    if (status) {
+        fprintf(stderr, "Error: Memory allocation failed for data rows\n");
+    }
+
+    // Find the text of every row
+    while (status == 0) {
+        const char *text;
+        size_t text_length;
+        int result = json_array_reader_next_raw(&reader, &text, &text_length);
+        if (result <= 0) {
+            if (result < 0) status = 1;
+            break;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            const char **grown_texts = realloc(texts, capacity * sizeof(const char *));
+            if (grown_texts) texts = grown_texts;
+            size_t *grown_lengths = realloc(lengths, capacity * sizeof(size_t));
+            if (grown_lengths) lengths = grown_lengths;
+            long *grown_lines = realloc(lines, capacity * sizeof(long));
+            if (grown_lines) lines = grown_lines;
+            if (!grown_texts || !grown_lengths || !grown_lines) {
+                fprintf(stderr, "Error: Memory reallocation failed for data rows\n");
+                status = 1;
+                break;
+            }
+        }
+        texts[count] = text;
+        lengths[count] = text_length;
+        lines[count] = reader.line;
+        count++;
+    }
+    json_array_reader_free(&reader);
+    if (status == 0 && tables_debug_mode) {
+        fprintf(stderr, "Debug: Found %d %s rows in %s\n", count, ndjson ? "NDJSON" : "JSON array", source);
+    }
+
+    if (status == 0) {
+        status = allocate_table_data(config, data, count);
+    }
+    if (status == 0) {
+        int block_count = parallel_block_count(count);
+        int failed[MAX_THREADS];
+        json_error_t errors[MAX_THREADS];
+        RowTextContext context = { config, data, texts, lengths, failed, errors };
+        if (block_count > 1) {
+            // Seed the hash function of JSON objects up front, rather than racing to on first use
+            json_object_seed(0);
+        }
+        parallel_run(count, block_count, load_row_text_block, &context);
+
+        // Report the first bad row, blocks hold rows in order
+        for (int b = 0; b < block_count && status == 0; b++) {
+            if (failed[b] >= 0) {
+                if (ndjson) {
+                    fprintf(stderr, "Error: JSON parsing failed for %s line %ld: %s\n",
+                            source, lines[failed[b]], errors[b].text);
+                }
+                free_table_data(data, config->column_count);
+                status = 1;
+            }
+        }
+    }
+
+    free(texts);
+    free(lengths);
+    free(lines);
+    return status;
+}
+
+/*
+ * Load and prepare data from JSON text already in memory, source names it in messages
+ */
+int prepare_data_buffer(const char *buffer, size_t length, const char *source, TableConfig *config, TableData *data) {
+    json_t *root;
+    json_error_t error;
+    extern int tables_debug_mode;
+
+    if (select_row_limit(config) > 0) {
+        JsonArrayReader reader;
+        json_array_reader_init_buffer(&reader, buffer, length);
+        return select_rows(&reader, source, config, data);
+    }
+    
+    int ndjson = data_format_is_ndjson(buffer, length);
+    if (prepare_row_texts(buffer, length, source, ndjson, config, data) == 0) {
+        return 0;
+    }
+    if (ndjson) {
+        return 1;
+    }
+
+    // The rows could not be read one at a time, so parse the whole document with jansson,
+    // which reports where it is broken
+    root = json_loadb(buffer, length, 0, &error);
+    if (root == NULL) {
+        fprintf(stderr, "Error: JSON parsing failed for %s: %s\n", source, error.text);
+        return 1;
+    }
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: JSON data parsed successfully from %s\n", source);
+    }
+    
+    if (!json_is_array(root)) {
+        fprintf(stderr, "Error: Data JSON root must be an array\n");
+        json_decref(root);
+        return 1;
+    }
+    
+    if (allocate_table_data(config, data, json_array_size(root)) != 0) {
+        json_decref(root);
+        return 1;
+    }
     
     // Process each row
     for (int i = 0; i < data->row_count; i++) {
         json_t *row_obj = json_array_get(root, i);
-        if (!json_is_object(row_obj)) continue;
-        
-        DataRow *row = &data->rows[i];
-        row->values = malloc(config->column_count * sizeof(char *));
-        if (row->values == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed for row values\n");
-            for (int j = 0; j < i; j++) {
-                for (int k = 0; k < config->column_count; k++) {
-                    if (data->rows[j].values[k]) free(data->rows[j].values[k]);
-                }
-                free(data->rows[j].values);
-            }
-            free(data->rows);
-            free(data->summaries);
+        if (load_row_values(config, row_obj, &data->rows[i]) != 0) {
+            free_table_data(data, config->column_count);
             json_decref(root);
             return 1;
         }
-        
-        for (int j = 0; j < config->column_count; j++) {
-            const char *key = config->columns[j].key;
-            json_t *val = json_object_get(row_obj, key);
-            if (json_is_string(val)) {
-                row->values[j] = strdup_safe(json_string_value(val));
-            } else if (json_is_number(val)) {
-                char buffer[32];
-                snprintf(buffer, sizeof(buffer), "%g", json_number_value(val));
-                row->values[j] = strdup_safe(buffer);
-            } else if (json_is_null(val)) {
-                row->values[j] = strdup_safe("null");
-            } else {
-                row->values[j] = strdup_safe("null");
-            }
-        }
     }
     
+    // Validate and parse the loaded values, one block of rows per thread
+    RowBlockContext context = { config, data, NULL };
+    parallel_run(data->row_count, parallel_block_count(data->row_count), store_row_block, &context);
+    
     json_decref(root);
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: JSON root object freed\n");
     }
     return 0;
 }
 
+/*
+ * Helper function to convert a JSON number to text without losing digits
+ * Integers are printed exactly, reals with the fewest digits that read back as the same value
+ */
+static void format_json_number(json_t *val, char *buffer, size_t size) {
+    if (json_is_integer(val)) {
+        snprintf(buffer, size, "%" JSON_INTEGER_FORMAT, json_integer_value(val));
+        return;
+    }
+    format_real_value(json_real_value(val), buffer, size);
+}
+
+/*
+ * Convert a real number to the fewest digits that read back as the same value
+ */
+void format_real_value(double number, char *buffer, size_t size) {
+    int digits = 1;
+    while (digits < 17) {
+        snprintf(buffer, size, "%.*e", digits - 1, number);
+        if (strtod(buffer, NULL) == number) break;
+        digits++;
+    }
+    // Keep whole numbers such as 750.0 in plain notation, as %g would with enough precision
+    snprintf(buffer, size, "%.*e", digits - 1, number);
+    int exponent = atoi(strchr(buffer, 'e') + 1);
+    if (exponent >= digits && exponent < 17) digits = exponent + 1;
+    snprintf(buffer, size, "%.*g", digits, number);
+}
+
+/*
+ * Helper function to look up the value of a column key in a row object
+ * A field named by the whole key comes first, then a dotted key is followed into nested objects
+ */
+static json_t *row_value(json_t *row_obj, const char *key) {
+    if (!json_is_object(row_obj) || key == NULL) return NULL;
+    json_t *val = json_object_get(row_obj, key);
+    if (val || strchr(key, '.') == NULL) return val;
+
+    char part[256];
+    while (json_is_object(row_obj)) {
+        const char *dot = strchr(key, '.');
+        size_t length = dot ? (size_t)(dot - key) : strlen(key);
+        if (length >= sizeof(part)) return NULL;
+        memcpy(part, key, length);
+        part[length] = '\0';
+        row_obj = json_object_get(row_obj, part);
+        if (dot == NULL) return row_obj;
+        key = dot + 1;
+    }
+    return NULL;
+}
+
+/*
+ * Extract the configured column values from a JSON row object into a DataRow
+ * Values that are missing or not strings or numbers are stored as "null"
+ */
+int load_row_values(TableConfig *config, json_t *row_obj, DataRow *row) {
+    row->values = arena_alloc(config->column_count * sizeof(char *));
+    if (row->values == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for row values\n");
+        return 1;
+    }
+    
+    for (int j = 0; j < config->column_count; j++) {
+        json_t *val = row_value(row_obj, config->columns[j].key);
+        if (json_is_string(val)) {
+            row->values[j] = strdup_safe(json_string_value(val));
+        } else if (json_is_number(val)) {
+            char buffer[32];
+            format_json_number(val, buffer, sizeof(buffer));
+            row->values[j] = strdup_safe(buffer);
+        } else if (json_is_null(val)) {
+            row->values[j] = strdup_safe("null");
+        } else {
+            row->values[j] = strdup_safe("null");
+        }
+    }
+    return 0;
+}
+
+/*
+ * Copy the values of a row given in column order into a DataRow
+ * NULL values and the columns past count are stored as "null", values past the last column are ignored
+ */
+int load_row_strings(TableConfig *config, const char *const *values, int count, DataRow *row) {
+    row->values = arena_alloc(config->column_count * sizeof(char *));
+    if (row->values == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for row values\n");
+        return 1;
+    }
+    
+    for (int j = 0; j < config->column_count; j++) {
+        const char *value = (j < count && values[j] != NULL) ? values[j] : "null";
+        row->values[j] = strdup_safe(value);
+        if (row->values[j] == NULL) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Extract the configured column values of a row from its JSON text into a DataRow
+ * The text is scanned for the columns' fields only, and rows the scan leaves alone are parsed with
+ * jansson. Returns 1 with error set if the row cannot be loaded
+ */
+int load_row_text(TableConfig *config, const char *text, size_t length, DataRow *row, json_error_t *error) {
+    if (project_row_values(config->projection, text, length, row) == 0) {
+        return 0;
+    }
+    json_t *row_obj = json_loadb(text, length, 0, error);
+    if (row_obj == NULL) {
+        return 1;
+    }
+    int status = load_row_values(config, row_obj, row);
+    json_decref(row_obj);
+    if (status != 0) {
+        snprintf(error->text, sizeof(error->text), "row could not be loaded");
+    }
+    return status;
+}
+
+/*
+ * Read the next row of a JSON array or NDJSON data into a DataRow
+ * Returns 1 when a row is available, 0 at the end of the data and -1 on error
+ */
+int read_next_row(JsonArrayReader *reader, TableConfig *config, DataRow *row) {
+    const char *text;
+    size_t length;
+    json_error_t error;
+
+    long line = reader->line;
+    int status = json_array_reader_next_raw(reader, &text, &length);
+    if (status <= 0) return status;
+    if (reader->lines) {
+        // The line break before an NDJSON value is only skipped by the read
+        line = reader->line;
+    }
+
+    if (load_row_text(config, text, length, row, &error) != 0) {
+        fprintf(stderr, "Error: JSON parsing failed for element near line %ld: %s\n", line, error.text);
+        return -1;
+    }
+    return 1;
+}
+
 /*
  * Initialize summaries for each column
  */
@@ -193,54 +460,605 @@ void initialize_summaries(TableConfig *config, TableData *data) {
     }
 }
 
+/*
+ * Convert a kmem value to the megabytes used for kmem summaries
+ */
+static double kmem_megabytes(const char *value) {
+    char *num_part = arena_strdup(value);
+    if (num_part == NULL) return 0.0;
+    double multiplier = 1.0;
+    
+    if (strstr(value, "Mi") != NULL) {
+        num_part[strlen(num_part) - 2] = '\0';
+        multiplier = 1.0;
+    } else if (strstr(value, "M") != NULL) {
+        num_part[strlen(num_part) - 1] = '\0';
+        multiplier = 1.0;
+    } else if (strstr(value, "Gi") != NULL) {
+        num_part[strlen(num_part) - 2] = '\0';
+        multiplier = 1000.0;
+    } else if (strstr(value, "G") != NULL) {
+        num_part[strlen(num_part) - 1] = '\0';
+        multiplier = 1000.0;
+    } else if (strstr(value, "Ki") != NULL) {
+        num_part[strlen(num_part) - 2] = '\0';
+        multiplier = 1.0 / 1000.0;
+    } else if (strstr(value, "K") != NULL) {
+        num_part[strlen(num_part) - 1] = '\0';
+        multiplier = 1.0 / 1000.0;
+    }
+    
+    return atof(num_part) * multiplier;
+}
+
+/*
+ * Allocate the column store for row_count rows
+ * Text columns only keep the value class, numeric columns also keep the parsed number
+ */
+int init_column_store(TableConfig *config, TableData *data, int row_count) {
+    size_t rows = row_count > 0 ? (size_t)row_count : 1;
+    data->store = calloc(config->column_count, sizeof(ColumnStore));
+    if (data->store == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for column store\n");
+        return 1;
+    }
+    data->store_rows = row_count;
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnStore *store = &data->store[j];
+        store->classes = malloc(rows);
+        store->placeholders = calloc((rows + 7) / 8, 1);
+        if (store->classes == NULL || store->placeholders == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for column store\n");
+            return 1;
+        }
+        if (config->columns[j].data_type == DATA_TEXT) continue;
+        store->numbers = malloc(rows * sizeof(double));
+        store->missing = calloc((rows + 7) / 8, 1);
+        store->unsummed = calloc((rows + 7) / 8, 1);
+        if (store->numbers == NULL || store->missing == NULL || store->unsummed == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for column store\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Grow the column store to hold row_count rows, keeping the rows it holds
+ */
+int grow_column_store(TableConfig *config, TableData *data, int row_count) {
+    if (row_count <= data->store_rows) return 0;
+    size_t old_bytes = ((size_t)data->store_rows + 7) / 8;
+    size_t bytes = ((size_t)row_count + 7) / 8;
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnStore *store = &data->store[j];
+        unsigned char *classes = realloc(store->classes, row_count);
+        if (classes) store->classes = classes;
+        unsigned char *placeholders = realloc(store->placeholders, bytes);
+        if (placeholders) store->placeholders = placeholders;
+        if (classes == NULL || placeholders == NULL) {
+            fprintf(stderr, "Error: Memory reallocation failed for column store\n");
+            return 1;
+        }
+        memset(store->placeholders + old_bytes, 0, bytes - old_bytes);
+        if (store->numbers == NULL) continue;
+        double *numbers = realloc(store->numbers, row_count * sizeof(double));
+        if (numbers) store->numbers = numbers;
+        unsigned char *missing = realloc(store->missing, bytes);
+        if (missing) store->missing = missing;
+        unsigned char *unsummed = realloc(store->unsummed, bytes);
+        if (unsummed) store->unsummed = unsummed;
+        if (numbers == NULL || missing == NULL || unsummed == NULL) {
+            fprintf(stderr, "Error: Memory reallocation failed for column store\n");
+            return 1;
+        }
+        memset(store->missing + old_bytes, 0, bytes - old_bytes);
+        memset(store->unsummed + old_bytes, 0, bytes - old_bytes);
+    }
+    data->store_rows = row_count;
+    return 0;
+}
+
+/*
+ * Parse the values of a loaded row into the column store at row_index
+ * Values are validated and numbers parsed here once, summaries, sorting and formatting reuse them
+ */
+void store_row_values(TableConfig *config, TableData *data, int row_index, DataRow *row) {
+    row->index = row_index;
+    ArenaMark mark = arena_mark();
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnStore *store = &data->store[j];
+        const char *value = row->values[j];
+        DataType data_type = config->columns[j].data_type;
+        ValueClass value_class = classify_display_value(value, data_type);
+        store->classes[row_index] = (unsigned char)value_class;
+        
+        // Only values or formats with a '{' need the renderer to replace color placeholders
+        const char *format = config->columns[j].format;
+        if ((value && strchr(value, '{')) || (format && strchr(format, '{'))) {
+            store->placeholders[row_index / 8] |= (unsigned char)(1 << (row_index % 8));
+        } else {
+            store->placeholders[row_index / 8] &= (unsigned char)~(1 << (row_index % 8));
+        }
+        if (store->numbers == NULL) continue;
+        
+        int has_number = 0;
+        int summed = 1;
+        double number = 0.0;
+        if (value != NULL && strcmp(value, "null") != 0) {
+            if (data_type == DATA_KCPU) {
+                // Millicores, with plain values counted as cores the way format_kcpu() shows them,
+                // though only millicore values are summed, as in tables.sh
+                if (strstr(value, "m") != NULL) {
+                    number = atof(value);
+                    has_number = 1;
+                } else if (value_class != VALUE_CLASS_NULL) {
+                    number = atof(value) * 1000.0;
+                    has_number = 1;
+                    summed = 0;
+                }
+            } else if (data_type == DATA_KMEM) {
+                number = kmem_megabytes(value);
+                has_number = 1;
+            } else {
+                number = atof(value);
+                has_number = 1;
+            }
+        }
+        store->numbers[row_index] = number;
+        if (has_number) {
+            store->missing[row_index / 8] &= (unsigned char)~(1 << (row_index % 8));
+        } else {
+            store->missing[row_index / 8] |= (unsigned char)(1 << (row_index % 8));
+        }
+        if (summed) {
+            store->unsummed[row_index / 8] &= (unsigned char)~(1 << (row_index % 8));
+        } else {
+            store->unsummed[row_index / 8] |= (unsigned char)(1 << (row_index % 8));
+        }
+    }
+    arena_reset(mark); // Drop the temporaries used to parse unit suffixes
+}
+
+/*
+ * Return the value class of a cell as stored when the row was loaded
+ */
+ValueClass stored_value_class(const TableData *data, int column, const DataRow *row) {
+    return (ValueClass)data->store[column].classes[row->index];
+}
+
+/*
+ * Return the parsed number of a cell, or NULL for text columns and values without a number
+ */
+const double *stored_number(const TableData *data, int column, const DataRow *row) {
+    const ColumnStore *store = &data->store[column];
+    if (store->numbers == NULL) return NULL;
+    if (store->missing[row->index / 8] & (1 << (row->index % 8))) return NULL;
+    return &store->numbers[row->index];
+}
+
+/*
+ * Return 1 if the number of a cell counts in sums, min and max, 0 for plain kcpu core values
+ */
+int stored_number_summed(const TableData *data, int column, const DataRow *row) {
+    const ColumnStore *store = &data->store[column];
+    if (store->numbers == NULL) return 0;
+    return !((store->unsummed[row->index / 8] >> (row->index % 8)) & 1);
+}
+
+/*
+ * Return 1 if the display value of a cell may hold color placeholders, as found when the row was loaded
+ */
+int stored_has_placeholders(const TableData *data, int column, const DataRow *row) {
+    return (data->store[column].placeholders[row->index / 8] >> (row->index % 8)) & 1;
+}
+
+/* Sort key precomputed for one row and one rule */
+typedef struct {
+    double number;          /* Normalised value for numeric columns */
+    char *text;             /* strxfrm() collation key for text columns */
+    int is_null;            /* Flag for null or blank values, which always sort last */
+} SortKey;
+
+/* Comparator context, qsort() has no user argument */
+static const SortRule *sort_rules;
+static const SortKey *sort_keys;
+static int sort_rule_count;
+
+/*
+ * Compare two row indexes by their precomputed keys, falling back to the original order
+ */
+static int compare_sort_rows(const void *a, const void *b) {
+    int row_a = *(const int *)a;
+    int row_b = *(const int *)b;
+    const SortKey *keys_a = &sort_keys[(size_t)row_a * sort_rule_count];
+    const SortKey *keys_b = &sort_keys[(size_t)row_b * sort_rule_count];
+    
+    for (int r = 0; r < sort_rule_count; r++) {
+        const SortKey *key_a = &keys_a[r];
+        const SortKey *key_b = &keys_b[r];
+        if (key_a->is_null || key_b->is_null) {
+            if (key_a->is_null && key_b->is_null) continue;
+            return key_a->is_null ? 1 : -1;
+        }
+        int result;
+        if (sort_rules[r].numeric) {
+            result = (key_a->number > key_b->number) - (key_a->number < key_b->number);
+        } else {
+            result = strcmp(key_a->text, key_b->text);
+        }
+        if (result != 0) {
+            return sort_rules[r].descending ? -result : result;
+        }
+    }
+    return (row_a > row_b) - (row_a < row_b); // Keep equal rows in input order
+}
+
+/*
+ * Helper function to check for null or blank values, which always sort last
+ */
+static int sort_value_is_null(const char *value, const double *number, int numeric) {
+    if (value == NULL || strcmp(value, "null") == 0) return 1;
+    return numeric && (value[0] == '\0' || number == NULL);
+}
+
+/*
+ * Compute the sort key of a single value
+ */
+static void make_sort_key(const char *value, const double *number, int numeric, SortKey *key) {
+    key->number = 0.0;
+    key->text = NULL;
+    key->is_null = sort_value_is_null(value, number, numeric);
+    if (key->is_null) return;
+    
+    if (numeric) {
+        key->number = *number;
+        return;
+    }
+    
+    size_t length = strxfrm(NULL, value, 0);
+    key->text = arena_alloc(length + 1);
+    if (key->text == NULL) {
+        key->text = (char *)value;
+    } else {
+        strxfrm(key->text, value, length + 1);
+    }
+}
+
+/*
+ * Resolve the sort configuration against the columns into rules in priority order
+ * Rules of equal priority keep the layout order, unusable sort items are skipped with a warning
+ * when warn is set. Returns the number of rules
+ */
+int resolve_sort_rules(TableConfig *config, SortRule *rules, int warn) {
+    int priorities[MAX_COLUMNS];
+    int rule_count = 0;
+    for (int i = 0; i < config->sort_count && rule_count < MAX_COLUMNS; i++) {
+        SortConfig *sort = &config->sorts[i];
+        if (sort->key == NULL || strlen(sort->key) == 0) {
+            if (warn) fprintf(stderr, "Warning: Sort item %d has no key, ignoring\n", i);
+            continue;
+        }
+        int column = -1;
+        for (int j = 0; j < config->column_count; j++) {
+            if (config->columns[j].key && strcmp(config->columns[j].key, sort->key) == 0) {
+                column = j;
+                break;
+            }
+        }
+        if (column < 0) {
+            if (warn) fprintf(stderr, "Warning: Sort key %s does not match any column, ignoring\n", sort->key);
+            continue;
+        }
+        DataType data_type = config->columns[column].data_type;
+        int pos = rule_count;
+        while (pos > 0 && priorities[pos - 1] > sort->priority) {
+            rules[pos] = rules[pos - 1];
+            priorities[pos] = priorities[pos - 1];
+            pos--;
+        }
+        rules[pos].column = column;
+        rules[pos].descending = sort->direction;
+        rules[pos].numeric = (data_type != DATA_TEXT);
+        priorities[pos] = sort->priority;
+        rule_count++;
+    }
+    return rule_count;
+}
+
+/*
+ * Compare two loaded rows by their values, returning 0 when the rules rank them equal
+ * Text is compared with strcoll(), which orders values the same way as their strxfrm() keys
+ */
+int compare_row_values(const SortRule *rules, int rule_count, const TableData *data, const DataRow *a, const DataRow *b) {
+    for (int r = 0; r < rule_count; r++) {
+        int column = rules[r].column;
+        const char *value_a = a->values[column];
+        const char *value_b = b->values[column];
+        const double *number_a = stored_number(data, column, a);
+        const double *number_b = stored_number(data, column, b);
+        int null_a = sort_value_is_null(value_a, number_a, rules[r].numeric);
+        int null_b = sort_value_is_null(value_b, number_b, rules[r].numeric);
+        if (null_a || null_b) {
+            if (null_a && null_b) continue;
+            return null_a ? 1 : -1;
+        }
+        int result;
+        if (rules[r].numeric) {
+            result = (*number_a > *number_b) - (*number_a < *number_b);
+        } else {
+            result = strcoll(value_a, value_b);
+            result = (result > 0) - (result < 0);
+        }
+        if (result != 0) {
+            return rules[r].descending ? -result : result;
+        }
+    }
+    return 0;
+}
+
 /*
  * Sort data rows based on sort configuration
+ * Keys are computed once per row so the comparator only compares numbers or collation keys
  */
 void sort_data(TableConfig *config, TableData *data) {
-    if (config->sort_count == 0) return;
+    extern int tables_debug_mode;
+    if (config->sort_count == 0 || data->row_count < 2) return;
+    
+    // Resolve the sort rules in priority order, keeping the layout order for equal priorities
+    SortRule rules[MAX_COLUMNS];
+    int rule_count = resolve_sort_rules(config, rules, 1);
+    if (rule_count == 0) return;
+    
+    // Keys and collation strings are only needed while sorting, rows keep their column store index
+    ArenaMark mark = arena_mark();
+    SortKey *keys = arena_alloc((size_t)data->row_count * rule_count * sizeof(SortKey));
+    int *order = malloc(data->row_count * sizeof(int));
+    DataRow *sorted_rows = malloc(data->row_count * sizeof(DataRow));
+    if (keys == NULL || order == NULL || sorted_rows == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for sorting\n");
+        free(order);
+        free(sorted_rows);
+        arena_reset(mark);
+        return;
+    }
     
-    // TODO: Implement sorting logic
-    // For now, just a placeholder to indicate sorting will be done here
-    // Note: 'data' parameter is currently unused but will be needed for sorting implementation
-    (void)data; // Suppress unused parameter warning
+    for (int i = 0; i < data->row_count; i++) {
+        order[i] = i;
+        for (int r = 0; r < rule_count; r++) {
+            int column = rules[r].column;
+            make_sort_key(data->rows[i].values[column], stored_number(data, column, &data->rows[i]),
+                          rules[r].numeric, &keys[(size_t)i * rule_count + r]);
+        }
+    }
+    
+    sort_rules = rules;
+    sort_keys = keys;
+    sort_rule_count = rule_count;
+    qsort(order, data->row_count, sizeof(int), compare_sort_rows);
+    sort_rules = NULL;
+    sort_keys = NULL;
+    
+    for (int i = 0; i < data->row_count; i++) {
+        sorted_rows[i] = data->rows[order[i]];
+    }
+    free(data->rows);
+    data->rows = sorted_rows;
+    free(order);
+    arena_reset(mark);
+    
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Sorted %d rows by %d sort keys\n", data->row_count, rule_count);
+    }
 }
 
 /*
- * Process data rows, update summaries and calculate widths
+ * Update the summaries of every column with the values of one row
  */
-void process_data_rows(TableConfig *config, TableData *data) {
-    data->max_lines = 1;
-    if (data->row_count == 0) return;
-    
+void accumulate_row_summaries(TableConfig *config, TableData *data, DataRow *row) {
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        update_summaries(j, row->values[j], stored_number(data, j, row), stored_number_summed(data, j, row), col->data_type, col->summary, &data->summaries[j]);
+    }
+}
+
+/*
+ * Release the unique values held by an array of summaries and reset them to no rows
+ */
+void clear_summaries(SummaryStats *stats, int column_count) {
+    for (int i = 0; i < column_count; i++) {
+        unique_set_free(&stats[i].unique_values);
+        free(stats[i].unique_estimate);
+        memset(&stats[i], 0, sizeof(SummaryStats));
+    }
+}
+
+/*
+ * Return the break column when some column has a subtotal, or -1 when there are no subtotals
+ * Subtotals are kept for the groups of rows between breaks, so they need a break column
+ */
+int subtotal_break_column(const TableConfig *config) {
+    int break_col = -1;
+    int subtotals = 0;
+    for (int j = 0; j < config->column_count; j++) {
+        if (config->columns[j].break_on_change && break_col < 0) break_col = j;
+        if (config->columns[j].subtotal != SUMMARY_NONE) subtotals = 1;
+    }
+    return subtotals ? break_col : -1;
+}
+
+/*
+ * Update the subtotals of the group a row belongs to with its values
+ */
+void accumulate_row_subtotals(TableConfig *config, TableData *data, DataRow *row, SummaryStats *stats) {
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        if (col->subtotal == SUMMARY_NONE) continue;
+        update_summaries(j, row->values[j], stored_number(data, j, row), stored_number_summed(data, j, row), col->data_type, col->subtotal, &stats[j]);
+    }
+}
+
+/*
+ * Helper function to gather the subtotals of each group of rows between breaks
+ * A group ends where a break separator is drawn, so the break values are compared the same way.
+ * Float subtotals use the decimal places of the whole column, so they line up with its rows
+ */
+static void summarize_groups(TableConfig *config, TableData *data) {
+    int break_col = subtotal_break_column(config);
+    if (break_col < 0 || data->row_count == 0) return;
+
+    int group_count = 1;
+    const char *previous = data->rows[0].values[break_col];
+    for (int i = 1; i < data->row_count; i++) {
+        const char *current = data->rows[i].values[break_col];
+        if (previous && current && strcmp(previous, current) != 0) group_count++;
+        previous = current;
+    }
+
+    data->group_summaries = calloc((size_t)group_count * config->column_count, sizeof(SummaryStats));
+    data->group_ends = malloc(group_count * sizeof(int));
+    if (data->group_summaries == NULL || data->group_ends == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for subtotals, leaving them out\n");
+        free(data->group_summaries);
+        free(data->group_ends);
+        data->group_summaries = NULL;
+        data->group_ends = NULL;
+        return;
+    }
+    data->group_count = group_count;
+
+    int group = 0;
+    previous = data->rows[0].values[break_col];
     for (int i = 0; i < data->row_count; i++) {
-        DataRow *row = &data->rows[i];
-        int line_count = 1;
-        
+        const char *current = data->rows[i].values[break_col];
+        if (i > 0 && previous && current && strcmp(previous, current) != 0) {
+            data->group_ends[group++] = i;
+        }
+        previous = current;
+        accumulate_row_subtotals(config, data, &data->rows[i], &data->group_summaries[group * config->column_count]);
+    }
+    data->group_ends[group] = data->row_count;
+
+    for (int g = 0; g < group_count; g++) {
         for (int j = 0; j < config->column_count; j++) {
-            ColumnConfig *col = &config->columns[j];
-            const char *value = row->values[j];
-            DataType data_type = col->data_type;
-            SummaryType summary_type = col->summary;
-            
-            // Update summaries
-            update_summaries(j, value, data_type, summary_type, &data->summaries[j]);
-            
-            // TODO: Calculate display width and update column widths if not specified
-            // TODO: Handle wrapping to determine line count
+            data->group_summaries[g * config->column_count + j].max_decimal_places = data->summaries[j].max_decimal_places;
         }
-        
-        if (line_count > data->max_lines) {
-            data->max_lines = line_count;
+    }
+}
+
+/*
+ * Combine the summaries of a later block of rows into those of the rows before it
+ * The summaries of the later block are released
+ */
+static void merge_summaries(SummaryStats *stats, SummaryStats *other) {
+    stats->sum += other->sum;
+    stats->count += other->count;
+    if (other->min_initialized && (!stats->min_initialized || other->min < stats->min)) {
+        stats->min = other->min;
+        stats->min_initialized = 1;
+    }
+    if (other->max_initialized && (!stats->max_initialized || other->max > stats->max)) {
+        stats->max = other->max;
+        stats->max_initialized = 1;
+    }
+    if (other->unique_values.count > 0) {
+        unique_set_merge(&stats->unique_values, &other->unique_values);
+        stats->unique_count = (int)stats->unique_values.count;
+    }
+    if (other->unique_estimate) {
+        if (stats->unique_estimate == NULL) {
+            stats->unique_estimate = other->unique_estimate;
+            other->unique_estimate = NULL;
+        } else {
+            hll_merge(stats->unique_estimate, other->unique_estimate);
+        }
+    }
+    stats->avg_sum += other->avg_sum;
+    stats->avg_count += other->avg_count;
+    if (other->max_decimal_places > stats->max_decimal_places) {
+        stats->max_decimal_places = other->max_decimal_places;
+    }
+    stats->blanks += other->blanks;
+    stats->nonblanks += other->nonblanks;
+
+    unique_set_free(&other->unique_values);
+    free(other->unique_estimate);
+    other->unique_estimate = NULL;
+}
+
+/*
+ * Helper function to update the summaries of one block of rows
+ */
+static void summarize_row_block(void *context, int block, int start, int end) {
+    RowBlockContext *ctx = context;
+    SummaryStats *summaries = &ctx->block_summaries[block * ctx->config->column_count];
+    for (int i = start; i < end; i++) {
+        DataRow *row = &ctx->data->rows[i];
+        for (int j = 0; j < ctx->config->column_count; j++) {
+            ColumnConfig *col = &ctx->config->columns[j];
+            update_summaries(j, row->values[j], stored_number(ctx->data, j, row), stored_number_summed(ctx->data, j, row), col->data_type, col->summary, &summaries[j]);
+        }
+    }
+}
+
+/*
+ * Helper function to gather the summaries of every column over all rows
+ * Blocks of rows are summarized by separate threads and merged in order. Sums are then added
+ * up again in row order, since the rounding of floating point sums depends on the order.
+ */
+static void summarize_rows(TableConfig *config, TableData *data) {
+    data->max_lines = 1;
+    if (data->row_count == 0 || data->summarized) return; // Summaries of rows left out by a limit are already in
+    
+    int block_count = parallel_block_count(data->row_count);
+    SummaryStats *block_summaries = NULL;
+    if (block_count > 1) {
+        block_summaries = calloc((size_t)block_count * config->column_count, sizeof(SummaryStats));
+    }
+    if (block_summaries == NULL) {
+        for (int i = 0; i < data->row_count; i++) {
+            accumulate_row_summaries(config, data, &data->rows[i]);
+        }
+        return;
+    }
+    
+    RowBlockContext context = { config, data, block_summaries };
+    parallel_run(data->row_count, block_count, summarize_row_block, &context);
+    for (int b = 0; b < block_count; b++) {
+        for (int j = 0; j < config->column_count; j++) {
+            merge_summaries(&data->summaries[j], &block_summaries[b * config->column_count + j]);
         }
     }
+    free(block_summaries);
     
-    // TODO: Update column widths based on summary values if summaries are present
+    for (int j = 0; j < config->column_count; j++) {
+        SummaryStats *stats = &data->summaries[j];
+        if (data->store[j].numbers == NULL) continue;
+        DataType data_type = config->columns[j].data_type;
+        int averaged = (data_type == DATA_INT || data_type == DATA_NUM || data_type == DATA_FLOAT);
+        stats->sum = 0.0;
+        stats->avg_sum = 0.0;
+        for (int i = 0; i < data->row_count; i++) {
+            const double *number = stored_number(data, j, &data->rows[i]);
+            if (number == NULL || !stored_number_summed(data, j, &data->rows[i])) continue;
+            stats->sum += *number;
+            if (averaged) stats->avg_sum += *number;
+        }
+    }
+}
+
+/*
+ * Process data rows and update summaries, and the subtotals of each group when there are any
+ */
+void process_data_rows(TableConfig *config, TableData *data) {
+    summarize_rows(config, data);
+    summarize_groups(config, data);
 }
 
 /*
  * Helper function to count decimal places in a string representation of a number
  */
-static int count_decimal_places(const char *value) {
+int count_decimal_places(const char *value) {
     const char *decimal_point = strchr(value, '.');
     if (decimal_point == NULL) {
         return 0;
@@ -254,37 +1072,19 @@ static int count_decimal_places(const char *value) {
 
 /*
  * Update summary statistics for a column
+ * number is the value parsed into the column store, NULL if the value has no number,
+ * and summed is 0 when it counts towards blanks but not towards sums, min and max
  */
-void update_summaries(int col_idx, const char *value, DataType data_type, SummaryType summary_type, SummaryStats *stats) {
-    extern int debug_mode;
+void update_summaries(int col_idx, const char *value, const double *number, int summed, DataType data_type, SummaryType summary_type, SummaryStats *stats) {
+    extern int tables_debug_mode;
     
     bool is_null = (value == NULL || strcmp(value, "null") == 0);
     bool is_blank = is_null || (value && strcmp(value, "") == 0);
+    bool is_numeric = (data_type == DATA_INT || data_type == DATA_NUM || data_type == DATA_FLOAT ||
+                       data_type == DATA_KCPU || data_type == DATA_KMEM);
     
-    if (!is_blank) {
-        double num_val = 0.0;
-        bool is_numeric = (data_type == DATA_INT || data_type == DATA_NUM || data_type == DATA_FLOAT ||
-                           data_type == DATA_KCPU || data_type == DATA_KMEM);
-        
-        if (is_numeric) {
-            if (data_type == DATA_KCPU && strstr(value, "m") != NULL) {
-                char *num_part = strdup(value);
-                num_part[strlen(num_part) - 1] = '\0';
-                num_val = atof(num_part);
-                free(num_part);
-            } else if (data_type == DATA_KMEM) {
-                char *num_part = strdup(value);
-                char *unit = strstr(num_part, "M") ? strstr(num_part, "M") :
-                             strstr(num_part, "G") ? strstr(num_part, "G") :
-                             strstr(num_part, "K") ? strstr(num_part, "K") : NULL;
-                if (unit) *unit = '\0';
-                num_val = atof(num_part);
-                free(num_part);
-            } else {
-                num_val = atof(value);
-            }
-            if (num_val == 0.0) is_blank = true;
-        }
+    if (!is_blank && is_numeric && (number == NULL || *number == 0.0)) {
+        is_blank = true;
     }
     
     if (is_blank) {
@@ -309,8 +1109,8 @@ void update_summaries(int col_idx, const char *value, DataType data_type, Summar
     stats->count++;
     
     // Process numeric values for sum, min, max, and avg calculations
-    if (data_type == DATA_INT || data_type == DATA_NUM || data_type == DATA_FLOAT) {
-        double num_val = atof(value);
+    if (is_numeric && number != NULL && summed) {
+        double num_val = *number;
         
         // Update sum
         stats->sum += num_val;
@@ -331,152 +1131,95 @@ void update_summaries(int col_idx, const char *value, DataType data_type, Summar
             stats->max = num_val;
         }
         
-        // Update avg
-        stats->avg_sum += num_val;
-        stats->avg_count++;
-        
-    } else if (data_type == DATA_KCPU && strstr(value, "m") != NULL) {
-        char *num_part = strdup(value);
-        if (num_part) {
-            num_part[strlen(num_part) - 1] = '\0'; // Remove 'm'
-            double num_val = atof(num_part);
-            free(num_part);
-            
-            // Update sum
-            stats->sum += num_val;
-            
-            // Update min
-            if (!stats->min_initialized) {
-                stats->min = num_val;
-                stats->min_initialized = 1;
-            } else if (num_val < stats->min) {
-                stats->min = num_val;
-            }
-            
-            // Update max
-            if (!stats->max_initialized) {
-                stats->max = num_val;
-                stats->max_initialized = 1;
-            } else if (num_val > stats->max) {
-                stats->max = num_val;
-            }
-        }
-        
-    } else if (data_type == DATA_KMEM) {
-        // Handle different memory units
-        char *num_part = strdup(value);
-        if (num_part) {
-            double multiplier = 1.0;
-            double num_val = 0.0;
-            
-            if (strstr(value, "Mi") != NULL) {
-                num_part[strlen(num_part) - 2] = '\0';
-                multiplier = 1.0;
-            } else if (strstr(value, "M") != NULL) {
-                num_part[strlen(num_part) - 1] = '\0';
-                multiplier = 1.0;
-            } else if (strstr(value, "Gi") != NULL) {
-                num_part[strlen(num_part) - 2] = '\0';
-                multiplier = 1000.0;
-            } else if (strstr(value, "G") != NULL) {
-                num_part[strlen(num_part) - 1] = '\0';
-                multiplier = 1000.0;
-            } else if (strstr(value, "Ki") != NULL) {
-                num_part[strlen(num_part) - 2] = '\0';
-                multiplier = 1.0 / 1000.0;
-            } else if (strstr(value, "K") != NULL) {
-                num_part[strlen(num_part) - 1] = '\0';
-                multiplier = 1.0 / 1000.0;
-            }
-            
-            num_val = atof(num_part) * multiplier;
-            free(num_part);
-            
-            // Update sum
-            stats->sum += num_val;
-            
-            // Update min
-            if (!stats->min_initialized) {
-                stats->min = num_val;
-                stats->min_initialized = 1;
-            } else if (num_val < stats->min) {
-                stats->min = num_val;
-            }
-            
-            // Update max
-            if (!stats->max_initialized) {
-                stats->max = num_val;
-                stats->max_initialized = 1;
-            } else if (num_val > stats->max) {
-                stats->max = num_val;
-            }
+        // Update avg (kcpu and kmem columns have no average)
+        if (data_type == DATA_INT || data_type == DATA_NUM || data_type == DATA_FLOAT) {
+            stats->avg_sum += num_val;
+            stats->avg_count++;
         }
     }
     
     // Handle unique values tracking (only when needed)
     if (summary_type == SUMMARY_UNIQUE) {
-        // Check if value is already in unique_values
-        for (int i = 0; i < stats->unique_count; i++) {
-            if (strcmp(stats->unique_values[i], value) == 0) {
-                if (debug_mode) {
-                    fprintf(stderr, "Debug: Value '%s' already in unique_values for column %d\n", value, col_idx);
-                }
-                return; // Already exists
+        int added = unique_set_add(&stats->unique_values, value);
+        if (added > 0) {
+            stats->unique_count = (int)stats->unique_values.count;
+            if (tables_debug_mode) {
+                fprintf(stderr, "Debug: Added new unique value '%s' for column %d, count is now %d\n", value, col_idx, stats->unique_count);
             }
+        } else if (added == 0 && tables_debug_mode) {
+            fprintf(stderr, "Debug: Value '%s' already in unique_values for column %d\n", value, col_idx);
         }
-        // Add new unique value
-        if (debug_mode) {
-            fprintf(stderr, "Debug: Adding new unique value '%s' for column %d, new count will be %d\n", value, col_idx, stats->unique_count + 1);
-        }
-        char **new_unique_values = realloc(stats->unique_values, (stats->unique_count + 1) * sizeof(char *));
-        if (new_unique_values == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed for unique values\n");
-            return;
-        }
-        stats->unique_values = new_unique_values;
-        stats->unique_values[stats->unique_count] = strdup_safe(value);
-        if (stats->unique_values[stats->unique_count] == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed for unique value string\n");
-        } else {
-            if (debug_mode) {
-                fprintf(stderr, "Debug: Successfully added unique value '%s' at index %d for column %d\n", value, stats->unique_count, col_idx);
-            }
+    } else if (summary_type == SUMMARY_UNIQUE_APPROX) {
+        if (stats->unique_estimate == NULL) {
+            stats->unique_estimate = hll_create();
+            if (stats->unique_estimate == NULL) return;
         }
-        stats->unique_count++;
+        hll_add(stats->unique_estimate, unique_hash(value));
+    }
+}
+
+/*
+ * Return the number of distinct values for the unique or unique~ summary of a column
+ */
+int estimate_unique_count(const SummaryStats *stats) {
+    if (stats->unique_estimate) {
+        return (int)(hll_estimate(stats->unique_estimate) + 0.5);
     }
+    return stats->unique_count;
 }
 
 /*
  * Free memory allocated for TableData structure
  */
 void free_table_data(TableData *data, int column_count) {
+    // Row values and cached cells live in the arena and are released with it
     if (data->rows) {
-        for (int i = 0; i < data->row_count; i++) {
-            DataRow *row = &data->rows[i];
-            if (row->values) {
-                for (int j = 0; j < column_count; j++) {
-                    if (row->values[j]) free(row->values[j]);
-                }
-                free(row->values);
-            }
-        }
         free(data->rows);
     }
     
     if (data->summaries) {
-        for (int i = 0; i < column_count; i++) {
-            SummaryStats *stats = &data->summaries[i];
-            if (stats->unique_values) {
-                for (int j = 0; j < stats->unique_count; j++) {
-                    if (stats->unique_values[j]) free(stats->unique_values[j]);
-                }
-                free(stats->unique_values);
-            }
-        }
+        clear_summaries(data->summaries, column_count);
         free(data->summaries);
     }
     
+    if (data->group_summaries) {
+        clear_summaries(data->group_summaries, data->group_count * column_count);
+        free(data->group_summaries);
+        data->group_summaries = NULL;
+    }
+    free(data->group_ends);
+    data->group_ends = NULL;
+    data->group_count = 0;
+    
+    if (data->store) {
+        for (int j = 0; j < column_count; j++) {
+            free(data->store[j].numbers);
+            free(data->store[j].missing);
+            free(data->store[j].unsummed);
+            free(data->store[j].classes);
+            free(data->store[j].placeholders);
+        }
+        free(data->store);
+        data->store = NULL;
+    }
+    
+    data->cells = NULL;
+    
     // Reset counts
     data->row_count = 0;
     data->max_lines = 0;
 }
+
+/*
+ * Release the arenas holding row values and formatted text, reporting usage in debug mode
+ * Also stops any $() command whose output was never needed
+ */
+void release_run_memory(void) {
+    extern int tables_debug_mode;
+    if (tables_debug_mode) {
+        arena_report(NULL, "usage");
+    }
+    arena_release(NULL);
+    parallel_release();
+    commands_release();
+}
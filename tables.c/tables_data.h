@@ -8,12 +8,24 @@
 
 #include "tables_config.h"
 #include "tables_datatypes.h"
+#include "tables_unique.h"
+#include "tables_reader.h"
 
 /* Structure to hold a single data row */
 typedef struct {
     char **values;          /* Array of string values for each column */
+    int index;              /* Row of the column store holding the parsed values */
 } DataRow;
 
+/* Structure to hold the values of one column parsed once when the data is loaded */
+typedef struct {
+    double *numbers;        /* Number of each row (kcpu in millicores, kmem in megabytes), NULL for text */
+    unsigned char *missing; /* Bitmap of rows without a number, bit (row % 8) of byte (row / 8) */
+    unsigned char *unsummed; /* Bitmap of rows whose number is left out of sums, min and max */
+    unsigned char *classes; /* ValueClass of each row, so values are validated only once */
+    unsigned char *placeholders; /* Bitmap of rows whose display value may hold color placeholders */
+} ColumnStore;
+
 /* Structure to hold summary statistics for a column */
 typedef struct {
     double sum;             /* Sum of values */
@@ -22,7 +34,8 @@ typedef struct {
     int min_initialized;    /* Flag to indicate if min has been initialized */
     double max;             /* Maximum value */
     int max_initialized;    /* Flag to indicate if max has been initialized */
-    char **unique_values;   /* Array of unique values */
+    UniqueSet unique_values;/* Set of distinct values for the unique summary */
+    HyperLogLog *unique_estimate; /* Sketch for the unique~ summary, NULL until used */
     int unique_count;       /* Number of unique values */
     double avg_sum;         /* Sum for calculating average */
     int avg_count;          /* Count for calculating average */
@@ -31,20 +44,63 @@ typedef struct {
     int nonblanks;          /* Count of non-blank or non-zero values */
 } SummaryStats;
 
+/* Structure to hold a cell formatted during the layout pass, reused by the renderer */
+typedef struct {
+    char *text;             /* Formatted display value, NULL if the cell was not cached */
+    int width;              /* Display width of text */
+} FormattedCell;
+
+/* Sort rule resolved against the column configuration */
+typedef struct {
+    int column;             /* Index of the column holding the sort values */
+    int descending;         /* Flag for descending order */
+    int numeric;            /* Flag if keys are numbers rather than collated text */
+} SortRule;
+
 /* Structure to hold table data */
 typedef struct {
     DataRow *rows;          /* Array of data rows */
     int row_count;          /* Number of rows */
     SummaryStats *summaries;/* Array of summary stats for each column */
     int max_lines;          /* Maximum number of lines per row after wrapping */
+    FormattedCell *cells;   /* Cells formatted while calculating widths (row_count x column_count), or NULL */
+    ColumnStore *store;     /* Parsed values of each column */
+    int store_rows;         /* Number of rows the column store holds */
+    int summarized;         /* Flag if the summaries were gathered while the rows were read */
+    SummaryStats *group_summaries; /* Subtotals of each group of rows between breaks, group_count x column_count */
+    int *group_ends;        /* Row after the last row of each group */
+    int group_count;        /* Number of groups, 0 without subtotals */
 } TableData;
 
 /* Function prototypes */
 int prepare_data(const char *data_file, TableConfig *config, TableData *data);
+int prepare_data_buffer(const char *buffer, size_t length, const char *source, TableConfig *config, TableData *data);
+int allocate_table_data(TableConfig *config, TableData *data, int row_count);
+int load_row_values(TableConfig *config, json_t *row_obj, DataRow *row);
+int load_row_strings(TableConfig *config, const char *const *values, int count, DataRow *row);
+int load_row_text(TableConfig *config, const char *text, size_t length, DataRow *row, json_error_t *error);
+int read_next_row(JsonArrayReader *reader, TableConfig *config, DataRow *row);
+void format_real_value(double number, char *buffer, size_t size);
+int init_column_store(TableConfig *config, TableData *data, int row_count);
+int grow_column_store(TableConfig *config, TableData *data, int row_count);
+void store_row_values(TableConfig *config, TableData *data, int row_index, DataRow *row);
+ValueClass stored_value_class(const TableData *data, int column, const DataRow *row);
+const double *stored_number(const TableData *data, int column, const DataRow *row);
+int stored_number_summed(const TableData *data, int column, const DataRow *row);
+int stored_has_placeholders(const TableData *data, int column, const DataRow *row);
+int resolve_sort_rules(TableConfig *config, SortRule *rules, int warn);
+int compare_row_values(const SortRule *rules, int rule_count, const TableData *data, const DataRow *a, const DataRow *b);
 void sort_data(TableConfig *config, TableData *data);
 void process_data_rows(TableConfig *config, TableData *data);
+void accumulate_row_summaries(TableConfig *config, TableData *data, DataRow *row);
 void initialize_summaries(TableConfig *config, TableData *data);
-void update_summaries(int col_idx, const char *value, DataType data_type, SummaryType summary_type, SummaryStats *stats);
+void clear_summaries(SummaryStats *stats, int column_count);
+int subtotal_break_column(const TableConfig *config);
+void accumulate_row_subtotals(TableConfig *config, TableData *data, DataRow *row, SummaryStats *stats);
+int count_decimal_places(const char *value);
+int estimate_unique_count(const SummaryStats *stats);
+void update_summaries(int col_idx, const char *value, const double *number, int summed, DataType data_type, SummaryType summary_type, SummaryStats *stats);
 void free_table_data(TableData *data, int column_count);
+void release_run_memory(void);
 
 #endif /* TABLES_DATA_H */
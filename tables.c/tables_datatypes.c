@@ -7,8 +7,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <regex.h>
 #include "tables_datatypes.h"
+#include "tables_arena.h"
 
 /*
  * Helper function to duplicate a string, returning NULL if input is NULL
@@ -25,11 +25,21 @@ static char *strdup_safe(const char *str) {
     return dup;
 }
 
+/*
+ * Helper function to skip the ASCII digits at the start of text, returning the first other byte
+ * Validation runs once for every value of a numeric column, so the patterns below are matched
+ * by scanning rather than by compiling a regular expression each time
+ */
+static inline const char *skip_digits(const char *text) {
+    while (*text >= '0' && *text <= '9') text++;
+    return text;
+}
+
 /*
  * Helper function to format a number with commas as thousands separators
  */
 char *format_with_commas(const char *num_str) {
-    if (num_str == NULL || strlen(num_str) == 0) return strdup("");
+    if (num_str == NULL || strlen(num_str) == 0) return arena_strdup("");
     
     // Find decimal point if it exists
     char *decimal_point = strchr(num_str, '.');
@@ -48,10 +58,10 @@ char *format_with_commas(const char *num_str) {
     int decimal_len = decimal_part ? strlen(decimal_part) : 0;
     int new_len = integer_len + comma_count + decimal_len;
     
-    char *result = malloc(new_len + 1);
+    char *result = arena_alloc(new_len + 1);
     if (result == NULL) {
         fprintf(stderr, "Error: Memory allocation failed for number formatting\n");
-        return strdup("");
+        return arena_strdup("");
     }
     
     // Process integer part (add commas from right to left)
@@ -92,7 +102,7 @@ int validate_text(const char *value) {
  */
 char *format_text(const char *value, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification) {
     if (value == NULL || strcmp(value, "null") == 0 || strlen(value) == 0) {
-        return strdup("");
+        return arena_strdup("");
     }
     // Suppress unused parameter warnings; these will be used in future implementations
     (void)format;
@@ -104,20 +114,20 @@ char *format_text(const char *value, const char *format, int string_limit, int w
     if (string_limit > 0 && strlen(value) > (size_t)string_limit) {
         if (wrap_mode == WRAP_WRAP && wrap_char != NULL && strlen(wrap_char) > 0) {
             // TODO: Implement wrapping with custom character
-            char *result = malloc(string_limit + 1);
-            if (result == NULL) return strdup("");
+            char *result = arena_alloc(string_limit + 1);
+            if (result == NULL) return arena_strdup("");
             strncpy(result, value, string_limit);
             result[string_limit] = '\0';
             return result;
         } else if (wrap_mode == WRAP_WRAP) {
-            char *result = malloc(string_limit + 1);
-            if (result == NULL) return strdup("");
+            char *result = arena_alloc(string_limit + 1);
+            if (result == NULL) return arena_strdup("");
             strncpy(result, value, string_limit);
             result[string_limit] = '\0';
             return result;
         } else {
-            char *result = malloc(string_limit + 1);
-            if (result == NULL) return strdup("");
+            char *result = arena_alloc(string_limit + 1);
+            if (result == NULL) return arena_strdup("");
             if (justification == JUSTIFY_RIGHT) {
                 strncpy(result, value + strlen(value) - string_limit, string_limit);
             } else if (justification == JUSTIFY_CENTER) {
@@ -131,7 +141,7 @@ char *format_text(const char *value, const char *format, int string_limit, int w
         }
     }
     
-    return strdup(value);
+    return arena_strdup(value);
 }
 
 /*
@@ -145,20 +155,15 @@ int validate_number(const char *value) {
         return 1;
     }
     
-    // Check if the value matches a number pattern (integer or decimal)
-    regex_t regex;
-    int reti = regcomp(&regex, "^[0-9]+(\\.[0-9]+)?$", REG_EXTENDED);
-    if (reti) {
-        fprintf(stderr, "Error: Could not compile regex for number validation\n");
-        return 0;
-    }
-    
-    reti = regexec(&regex, value, 0, NULL, 0);
-    regfree(&regex);
-    if (!reti) {
-        return 1;
-    }
-    return 0;
+    // Check if the value matches a number pattern (integer or decimal), ^[0-9]+(\.[0-9]+)?$
+    const char *end = skip_digits(value);
+    if (end == value) return 0;
+    if (*end == '.') {
+        const char *fraction = end + 1;
+        end = skip_digits(fraction);
+        if (end == fraction) return 0;
+    }
+    return *end == '\0';
 }
 
 /*
@@ -166,7 +171,7 @@ int validate_number(const char *value) {
  */
 char *format_number(const char *value, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification) {
     if (value == NULL || strcmp(value, "null") == 0 || strcmp(value, "0") == 0) {
-        return strdup("");
+        return arena_strdup("");
     }
     // Suppress unused parameter warnings; these will be used in future implementations
     (void)format;
@@ -178,7 +183,7 @@ char *format_number(const char *value, const char *format, int string_limit, int
     if (format != NULL && strlen(format) > 0) {
         char buffer[256];
         snprintf(buffer, sizeof(buffer), format, atof(value));
-        return strdup(buffer);
+        return arena_strdup(buffer);
     }
     
     // Apply thousands separators to all numbers
@@ -190,7 +195,7 @@ char *format_number(const char *value, const char *format, int string_limit, int
  */
 char *format_num(const char *value, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification) {
     if (value == NULL || strcmp(value, "null") == 0 || strcmp(value, "0") == 0) {
-        return strdup("");
+        return arena_strdup("");
     }
     // Suppress unused parameter warnings; these will be used in future implementations
     (void)format;
@@ -202,7 +207,7 @@ char *format_num(const char *value, const char *format, int string_limit, int wr
     if (format != NULL && strlen(format) > 0) {
         char buffer[256];
         snprintf(buffer, sizeof(buffer), format, atof(value));
-        return strdup(buffer);
+        return arena_strdup(buffer);
     }
     
     return format_with_commas(value);
@@ -219,16 +224,9 @@ int validate_kcpu(const char *value) {
         return 1;
     }
     
-    // Check for millicores format (e.g., 100m)
-    regex_t regex_m;
-    int reti = regcomp(&regex_m, "^[0-9]+m$", REG_EXTENDED);
-    if (reti) {
-        fprintf(stderr, "Error: Could not compile regex for kcpu validation (m)\n");
-        return 0;
-    }
-    reti = regexec(&regex_m, value, 0, NULL, 0);
-    regfree(&regex_m);
-    if (!reti) {
+    // Check for millicores format (e.g., 100m), ^[0-9]+m$
+    const char *end = skip_digits(value);
+    if (end != value && end[0] == 'm' && end[1] == '\0') {
         return 1;
     }
     
@@ -241,10 +239,10 @@ int validate_kcpu(const char *value) {
  */
 char *format_kcpu(const char *value, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification) {
     if (value == NULL || strcmp(value, "null") == 0) {
-        return strdup("");
+        return arena_strdup("");
     }
     if (strcmp(value, "0") == 0 || strcmp(value, "0m") == 0) {
-        return strdup("0m");
+        return arena_strdup("0m");
     }
     // Suppress unused parameter warnings; these will be used in future implementations
     (void)format;
@@ -254,26 +252,23 @@ char *format_kcpu(const char *value, const char *format, int string_limit, int w
     (void)justification;
     
     if (strstr(value, "m") != NULL) {
-        char *num_part = strdup(value);
+        char *num_part = arena_strdup(value);
         if (num_part == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for num_part in format_kcpu\n");
-            return strdup("");
+            return arena_strdup("");
         }
         num_part[strlen(num_part) - 1] = '\0'; // Remove 'm'
         char *formatted = format_with_commas(num_part);
-        free(num_part);
         if (formatted == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for formatted in format_kcpu\n");
-            return strdup("");
+            return arena_strdup("");
         }
-        char *result = malloc(strlen(formatted) + 2);
+        char *result = arena_alloc(strlen(formatted) + 2);
         if (result == NULL) {
-            free(formatted);
             fprintf(stderr, "Error: Memory allocation failed in format_kcpu\n");
-            return strdup("");
+            return arena_strdup("");
         }
         snprintf(result, strlen(formatted) + 2, "%sm", formatted);
-        free(formatted);
         return result;
     } else if (validate_number(value)) {
         double cores = atof(value);
@@ -281,19 +276,17 @@ char *format_kcpu(const char *value, const char *format, int string_limit, int w
         char buffer[32];
         snprintf(buffer, sizeof(buffer), "%ld", millicores);
         char *formatted = format_with_commas(buffer);
-        if (formatted == NULL) return strdup("");
-        char *result = malloc(strlen(formatted) + 2);
+        if (formatted == NULL) return arena_strdup("");
+        char *result = arena_alloc(strlen(formatted) + 2);
         if (result == NULL) {
-            free(formatted);
             fprintf(stderr, "Error: Memory allocation failed in format_kcpu\n");
-            return strdup("");
+            return arena_strdup("");
         }
         snprintf(result, strlen(formatted) + 2, "%sm", formatted);
-        free(formatted);
         return result;
     }
     
-    return strdup(value);
+    return arena_strdup(value);
 }
 
 /*
@@ -307,19 +300,12 @@ int validate_kmem(const char *value) {
         return 1;
     }
     
-    // Check for memory formats (e.g., 128M, 1G, 512Ki)
-    regex_t regex;
-    int reti = regcomp(&regex, "^[0-9]+[KMG]$|^[0-9]+(Mi|Gi|Ki)$", REG_EXTENDED);
-    if (reti) {
-        fprintf(stderr, "Error: Could not compile regex for kmem validation\n");
+    // Check for memory formats (e.g., 128M, 1G, 512Ki), ^[0-9]+[KMG]$|^[0-9]+(Mi|Gi|Ki)$
+    const char *end = skip_digits(value);
+    if (end == value || (end[0] != 'K' && end[0] != 'M' && end[0] != 'G')) {
         return 0;
     }
-    reti = regexec(&regex, value, 0, NULL, 0);
-    regfree(&regex);
-    if (!reti) {
-        return 1;
-    }
-    return 0;
+    return end[1] == '\0' || (end[1] == 'i' && end[2] == '\0');
 }
 
 /*
@@ -327,7 +313,7 @@ int validate_kmem(const char *value) {
  */
 char *format_kmem(const char *value, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification) {
     if (value == NULL || strcmp(value, "null") == 0) {
-        return strdup("");
+        return arena_strdup("");
     }
     // Suppress unused parameter warnings; these will be used in future implementations
     (void)format;
@@ -337,111 +323,99 @@ char *format_kmem(const char *value, const char *format, int string_limit, int w
     (void)justification;
     if (strstr(value, "0M") != NULL || strstr(value, "0G") != NULL || strstr(value, "0K") != NULL ||
         strstr(value, "0Mi") != NULL || strstr(value, "0Gi") != NULL || strstr(value, "0Ki") != NULL) {
-        return strdup("0M");
+        return arena_strdup("0M");
     }
     
     if (strstr(value, "Mi") != NULL) {
-        char *num_part = strdup(value);
+        char *num_part = arena_strdup(value);
         if (num_part == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for num_part in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         num_part[strlen(num_part) - 2] = '\0'; // Remove 'Mi'
         char *formatted = format_with_commas(num_part);
-        free(num_part);
         if (formatted == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for formatted in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
-        char *result = malloc(strlen(formatted) + 2);
+        char *result = arena_alloc(strlen(formatted) + 2);
         if (result == NULL) {
-            free(formatted);
             fprintf(stderr, "Error: Memory allocation failed in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         snprintf(result, strlen(formatted) + 2, "%sM", formatted);
-        free(formatted);
         return result;
     } else if (strstr(value, "Gi") != NULL) {
-        char *num_part = strdup(value);
+        char *num_part = arena_strdup(value);
         if (num_part == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for num_part in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         num_part[strlen(num_part) - 2] = '\0'; // Remove 'Gi'
         char *formatted = format_with_commas(num_part);
-        free(num_part);
         if (formatted == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for formatted in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
-        char *result = malloc(strlen(formatted) + 2);
+        char *result = arena_alloc(strlen(formatted) + 2);
         if (result == NULL) {
-            free(formatted);
             fprintf(stderr, "Error: Memory allocation failed in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         snprintf(result, strlen(formatted) + 2, "%sG", formatted);
-        free(formatted);
         return result;
     } else if (strstr(value, "Ki") != NULL) {
-        char *num_part = strdup(value);
+        char *num_part = arena_strdup(value);
         if (num_part == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for num_part in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         num_part[strlen(num_part) - 2] = '\0'; // Remove 'Ki'
         char *formatted = format_with_commas(num_part);
-        free(num_part);
         if (formatted == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for formatted in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
-        char *result = malloc(strlen(formatted) + 2);
+        char *result = arena_alloc(strlen(formatted) + 2);
         if (result == NULL) {
-            free(formatted);
             fprintf(stderr, "Error: Memory allocation failed in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         snprintf(result, strlen(formatted) + 2, "%sK", formatted);
-        free(formatted);
         return result;
     } else if (strstr(value, "M") != NULL || strstr(value, "G") != NULL || strstr(value, "K") != NULL) {
-        char *num_part = strdup(value);
+        char *num_part = arena_strdup(value);
         if (num_part == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for num_part in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         char unit = num_part[strlen(num_part) - 1];
         num_part[strlen(num_part) - 1] = '\0'; // Remove unit
         char *formatted = format_with_commas(num_part);
-        free(num_part);
         if (formatted == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for formatted in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
-        char *result = malloc(strlen(formatted) + 2);
+        char *result = arena_alloc(strlen(formatted) + 2);
         if (result == NULL) {
-            free(formatted);
             fprintf(stderr, "Error: Memory allocation failed in format_kmem\n");
-            return strdup("");
+            return arena_strdup("");
         }
         snprintf(result, strlen(formatted) + 2, "%s%c", formatted, unit);
-        free(formatted);
         return result;
     }
     
-    return strdup(value);
+    return arena_strdup(value);
 }
 
 /* Data type handlers array */
 static DataTypeHandler handlers[] = {
-    {"text", validate_text, format_text, "count unique"},
-    {"int", validate_number, format_number, "sum min max avg count unique"},
-    {"num", validate_number, format_num, "sum min max avg count unique"},
-    {"float", validate_number, format_number, "sum min max avg count unique"},
-    {"kcpu", validate_kcpu, format_kcpu, "sum min max avg count unique"},
-    {"kmem", validate_kmem, format_kmem, "sum min max avg count unique"}
+    {"text", validate_text, format_text, "count unique unique~"},
+    {"int", validate_number, format_number, "sum min max avg count unique unique~"},
+    {"num", validate_number, format_num, "sum min max avg count unique unique~"},
+    {"float", validate_number, format_number, "sum min max avg count unique unique~"},
+    {"kcpu", validate_kcpu, format_kcpu, "sum min max avg count unique unique~"},
+    {"kmem", validate_kmem, format_kmem, "sum min max avg count unique unique~"}
 };
 
 /*
@@ -454,35 +428,49 @@ DataTypeHandler *get_data_type_handler(DataType type) {
     return &handlers[DATA_TEXT]; // Default to text
 }
 
+/*
+ * Classify a raw value as null (or invalid), zero, or a value that goes through its type formatter
+ */
+ValueClass classify_display_value(const char *value, DataType data_type) {
+    DataTypeHandler *handler = get_data_type_handler(data_type);
+    if (!handler->validate(value) || value == NULL || strcmp(value, "null") == 0) {
+        return VALUE_CLASS_NULL;
+    }
+    if (strcmp(value, "0") == 0 || strcmp(value, "0m") == 0 || strcmp(value, "0M") == 0 || strcmp(value, "0G") == 0 || strcmp(value, "0K") == 0) {
+        return VALUE_CLASS_ZERO;
+    }
+    return VALUE_CLASS_FORMATTED;
+}
+
 /*
  * Format a value for display, considering null and zero value display options
  */
 char *format_display_value(const char *value, ValueDisplay null_value, ValueDisplay zero_value, DataType data_type, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification) {
     DataTypeHandler *handler = get_data_type_handler(data_type);
-    int is_valid = handler->validate(value);
+    ValueClass value_class = classify_display_value(value, data_type);
     char *display_value = NULL;
     
-    if (!is_valid || value == NULL || strcmp(value, "null") == 0) {
+    if (value_class == VALUE_CLASS_NULL) {
         switch (null_value) {
             case VALUE_ZERO:
-                display_value = strdup("0");
+                display_value = arena_strdup("0");
                 break;
             case VALUE_MISSING:
-                display_value = strdup("Missing");
+                display_value = arena_strdup("Missing");
                 break;
             default:
-                display_value = strdup("");
+                display_value = arena_strdup("");
         }
-    } else if (strcmp(value, "0") == 0 || strcmp(value, "0m") == 0 || strcmp(value, "0M") == 0 || strcmp(value, "0G") == 0 || strcmp(value, "0K") == 0) {
+    } else if (value_class == VALUE_CLASS_ZERO) {
         switch (zero_value) {
             case VALUE_ZERO:
-                display_value = strdup("0");
+                display_value = arena_strdup("0");
                 break;
             case VALUE_MISSING:
-                display_value = strdup("Missing");
+                display_value = arena_strdup("Missing");
                 break;
             default:
-                display_value = strdup("");
+                display_value = arena_strdup("");
         }
     } else {
         display_value = handler->format(value, format, string_limit, wrap_mode, wrap_char, justification);
@@ -495,31 +483,39 @@ char *format_display_value(const char *value, ValueDisplay null_value, ValueDisp
  * Format a value for display with decimal precision, considering null and zero value display options
  */
 char *format_display_value_with_precision(const char *value, ValueDisplay null_value, ValueDisplay zero_value, DataType data_type, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification, int max_decimal_places) {
+    ValueClass value_class = classify_display_value(value, data_type);
+    return format_classified_value(value, value_class, NULL, null_value, zero_value, data_type, format, string_limit, wrap_mode, wrap_char, justification, max_decimal_places);
+}
+
+/*
+ * Format a value whose class was already determined, as stored in the column store when loading
+ * number is the parsed value of numeric columns, or NULL to parse value again
+ */
+char *format_classified_value(const char *value, ValueClass value_class, const double *number, ValueDisplay null_value, ValueDisplay zero_value, DataType data_type, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification, int max_decimal_places) {
     DataTypeHandler *handler = get_data_type_handler(data_type);
-    int is_valid = handler->validate(value);
     char *display_value = NULL;
     
-    if (!is_valid || value == NULL || strcmp(value, "null") == 0) {
+    if (value_class == VALUE_CLASS_NULL) {
         switch (null_value) {
             case VALUE_ZERO:
-                display_value = strdup("0");
+                display_value = arena_strdup("0");
                 break;
             case VALUE_MISSING:
-                display_value = strdup("Missing");
+                display_value = arena_strdup("Missing");
                 break;
             default:
-                display_value = strdup("");
+                display_value = arena_strdup("");
         }
-    } else if (strcmp(value, "0") == 0 || strcmp(value, "0m") == 0 || strcmp(value, "0M") == 0 || strcmp(value, "0G") == 0 || strcmp(value, "0K") == 0) {
+    } else if (value_class == VALUE_CLASS_ZERO) {
         switch (zero_value) {
             case VALUE_ZERO:
-                display_value = strdup("0");
+                display_value = arena_strdup("0");
                 break;
             case VALUE_MISSING:
-                display_value = strdup("Missing");
+                display_value = arena_strdup("Missing");
                 break;
             default:
-                display_value = strdup("");
+                display_value = arena_strdup("");
         }
     } else {
         // For float data type, format with consistent decimal places
@@ -527,7 +523,7 @@ char *format_display_value_with_precision(const char *value, ValueDisplay null_v
             char format_str[16];
             snprintf(format_str, sizeof(format_str), "%%.%df", max_decimal_places);
             char buffer[256];
-            snprintf(buffer, sizeof(buffer), format_str, atof(value));
+            snprintf(buffer, sizeof(buffer), format_str, number ? *number : atof(value));
             // Apply thousands separators to the formatted float
             display_value = format_with_commas(buffer);
         } else {
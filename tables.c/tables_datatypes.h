@@ -16,6 +16,13 @@ typedef struct {
     const char *summary_types;      /* Supported summary types as space-separated string */
 } DataTypeHandler;
 
+/* Classification of a raw value for display purposes */
+typedef enum {
+    VALUE_CLASS_NULL,       /* Null or invalid for the data type, shown using null_value */
+    VALUE_CLASS_ZERO,       /* Zero, shown using zero_value */
+    VALUE_CLASS_FORMATTED   /* Passed to the data type's formatting function */
+} ValueClass;
+
 /* Function prototypes */
 int validate_text(const char *value);
 char *format_text(const char *value, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification);
@@ -27,8 +34,10 @@ char *format_kcpu(const char *value, const char *format, int string_limit, int w
 int validate_kmem(const char *value);
 char *format_kmem(const char *value, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification);
 DataTypeHandler *get_data_type_handler(DataType type);
+ValueClass classify_display_value(const char *value, DataType data_type);
 char *format_display_value(const char *value, ValueDisplay null_value, ValueDisplay zero_value, DataType data_type, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification);
 char *format_display_value_with_precision(const char *value, ValueDisplay null_value, ValueDisplay zero_value, DataType data_type, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification, int max_decimal_places);
+char *format_classified_value(const char *value, ValueClass value_class, const double *number, ValueDisplay null_value, ValueDisplay zero_value, DataType data_type, const char *format, int string_limit, int wrap_mode, const char *wrap_char, int justification, int max_decimal_places);
 char *format_with_commas(const char *num_str);
 
 #endif /* TABLES_DATATYPES_H */
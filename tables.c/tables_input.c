@@ -0,0 +1,139 @@
+/*
+ * tables_input.c - Implementation of reading layout and data files, pipes and stdin
+ * Regular files are read with a single allocation of their size. Pipes, stdin and other streams
+ * are read into a buffer that doubles whenever it fills up, so large inputs are copied a
+ * logarithmic number of times instead of once per fixed-size step.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "tables_input.h"
+
+extern int tables_debug_mode;
+
+/*
+ * Return 1 if filename stands for stdin
+ */
+int input_is_stdin(const char *filename) {
+    return filename && strcmp(filename, "-") == 0;
+}
+
+/*
+ * Return the name of an input to use in messages
+ */
+const char *input_name(const char *filename) {
+    return input_is_stdin(filename) ? "stdin" : filename;
+}
+
+/*
+ * Return 1 if the input is a regular file, which can be mapped or read more than once
+ */
+int input_is_regular(const char *filename) {
+    struct stat info;
+    if (input_is_stdin(filename)) {
+        return fstat(STDIN_FILENO, &info) == 0 && S_ISREG(info.st_mode);
+    }
+    return stat(filename, &info) == 0 && S_ISREG(info.st_mode);
+}
+
+/*
+ * Open an input as a stream, returning stdin for "-"
+ */
+FILE *input_open(const char *filename) {
+    return input_is_stdin(filename) ? stdin : fopen(filename, "r");
+}
+
+/*
+ * Close a stream opened with input_open(), leaving stdin open
+ */
+void input_close(FILE *fp) {
+    if (fp && fp != stdin) fclose(fp);
+}
+
+/*
+ * Helper function to double the size of a read buffer, releasing it when that fails
+ */
+static char *grow_buffer(char *buffer, size_t *capacity) {
+    char *grown = realloc(buffer, *capacity * 2);
+    if (grown == NULL) {
+        fprintf(stderr, "Error: Memory reallocation failed for buffer\n");
+        free(buffer);
+        return NULL;
+    }
+    *capacity *= 2;
+    return grown;
+}
+
+/*
+ * Read an input completely into memory, returning NUL terminated text or NULL on failure
+ * kind names the input in messages ("layout" or "data"), the caller frees the text
+ */
+char *read_input(const char *filename, const char *kind, size_t *length) {
+    int fd = input_is_stdin(filename) ? STDIN_FILENO : open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open %s file %s\n", kind, filename);
+        return NULL;
+    }
+
+    struct stat info;
+    int regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+    size_t expected = regular ? (size_t)info.st_size : 0;
+    size_t capacity = regular ? expected + 1 : INPUT_CHUNK_SIZE;
+    size_t used = 0;
+    int failed = 0;
+    char *buffer = malloc(capacity);
+    if (buffer == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for buffer\n");
+    }
+
+    while (buffer) {
+        if (used + 1 == capacity) {
+            if (regular && used == expected) {
+                // A regular file is complete once its size has been read, unless it grew meanwhile
+                char probe;
+                ssize_t count = read(fd, &probe, 1);
+                if (count == 0) break;
+                if (count < 0 && errno == EINTR) continue;
+                if (count < 0) {
+                    failed = 1;
+                    break;
+                }
+                buffer = grow_buffer(buffer, &capacity);
+                if (buffer) buffer[used++] = probe;
+                continue;
+            }
+            buffer = grow_buffer(buffer, &capacity);
+            continue;
+        }
+        ssize_t count = read(fd, buffer + used, capacity - used - 1);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) {
+            failed = 1;
+            break;
+        }
+        if (count == 0) break;
+        used += (size_t)count;
+    }
+    if (fd != STDIN_FILENO) close(fd);
+    if (failed) {
+        fprintf(stderr, "Error: Reading %s file %s\n", kind, input_name(filename));
+        free(buffer);
+        return NULL;
+    }
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    buffer[used] = '\0';
+    *length = used;
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Read %zu bytes from %s file %s into a buffer of %zu bytes\n",
+                used, kind, input_name(filename), capacity);
+    }
+    return buffer;
+}
@@ -0,0 +1,23 @@
+/*
+ * tables_input.h - Header file for reading layout and data files, pipes and stdin
+ * A file named "-" is read from stdin, and named pipes can be given like regular files.
+ */
+
+#ifndef TABLES_INPUT_H
+#define TABLES_INPUT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* Initial buffer size for inputs whose size is not known in advance, doubled when full */
+#define INPUT_CHUNK_SIZE (64 * 1024)
+
+/* Function prototypes */
+int input_is_stdin(const char *filename);
+const char *input_name(const char *filename);
+int input_is_regular(const char *filename);
+FILE *input_open(const char *filename);
+void input_close(FILE *fp);
+char *read_input(const char *filename, const char *kind, size_t *length);
+
+#endif /* TABLES_INPUT_H */
@@ -0,0 +1,320 @@
+/*
+ * tables_layout_cache.c - Implementation of caching parsed layouts as binary images
+ * Images are stored next to the command cache as <hash of the layout path>.layout. An image is
+ * mapped privately and writable, so relocating its pointers and the widths set while rendering
+ * only copy the pages they touch, and the file itself is never changed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tables_layout_cache.h"
+#include "tables_projection.h"
+#include "tables_commands.h"
+
+extern int tables_debug_mode;
+
+/* Structure at the start of an image, followed by the columns, sorts and strings */
+typedef struct {
+    char magic[8];          /* "TBLAYOUT" */
+    uint32_t format;        /* LAYOUT_CACHE_FORMAT */
+    uint32_t config_size;   /* sizeof(TableConfig) of the writer */
+    uint32_t column_size;   /* sizeof(ColumnConfig) of the writer */
+    uint32_t sort_size;     /* sizeof(SortConfig) of the writer */
+    char version[32];       /* Version of tables that wrote the image */
+    int64_t mtime_sec;      /* Modification time of the layout file */
+    int64_t mtime_nsec;
+    int64_t layout_size;    /* Size of the layout file */
+    uint64_t image_size;    /* Size of the whole image */
+    uint64_t checksum;      /* FNV-1a hash of the whole image with this field as 0 */
+    uint64_t path;          /* Offset of the absolute layout file path */
+    TableConfig config;     /* Parsed layout with its pointers stored as offsets */
+} LayoutImage;
+
+/* Structure holding an image while it is written */
+typedef struct {
+    char *data;             /* Image bytes */
+    size_t used;            /* Bytes used */
+    size_t capacity;        /* Bytes allocated */
+} ImageBuilder;
+
+/*
+ * Helper function to reserve aligned space in an image, returning its offset or 0 on failure
+ * The space may move as the image grows, so it is addressed by offset
+ */
+static size_t image_reserve(ImageBuilder *image, size_t size) {
+    size_t offset = (image->used + 7) & ~(size_t)7;
+    if (offset + size > image->capacity) {
+        size_t capacity = image->capacity ? image->capacity : 4096;
+        while (offset + size > capacity) capacity *= 2;
+        char *data = realloc(image->data, capacity);
+        if (data == NULL) return 0;
+        memset(data + image->capacity, 0, capacity - image->capacity);
+        image->data = data;
+        image->capacity = capacity;
+    }
+    image->used = offset + size;
+    return offset;
+}
+
+/*
+ * Helper function to copy a string into an image, returning it as a pointer field holding the offset
+ * Sets failed when there is no memory, NULL strings stay NULL
+ */
+static char *image_string(ImageBuilder *image, const char *text, int *failed) {
+    if (text == NULL) return NULL;
+    size_t length = strlen(text) + 1;
+    size_t offset = image_reserve(image, length);
+    if (offset == 0) {
+        *failed = 1;
+        return NULL;
+    }
+    memcpy(image->data + offset, text, length);
+    return (char *)(uintptr_t)offset;
+}
+
+/*
+ * Helper function to hash an image, so that damaged images are never used
+ */
+static uint64_t image_checksum(const char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+ * Helper function to write the image of a parsed layout to its cache file, replacing it at once
+ */
+static void write_layout_image(const TableConfig *config, const char *path_key, const struct stat *info,
+                               const char *version, const char *path, char *dir) {
+    ImageBuilder image = { NULL, 0, 0 };
+    image_reserve(&image, sizeof(LayoutImage));
+    int failed = image.data == NULL;
+    size_t columns = failed ? 0 : image_reserve(&image, config->column_count * sizeof(ColumnConfig) + 1);
+    size_t sorts = failed ? 0 : image_reserve(&image, config->sort_count * sizeof(SortConfig) + 1);
+    if (columns == 0 || sorts == 0) failed = 1;
+
+    // Strings are added before the structures are filled in, as growing the image moves them
+    char **strings = calloc(config->column_count * 4 + config->sort_count + 4, sizeof(char *));
+    if (strings == NULL) failed = 1;
+    int n = 0;
+    if (!failed) {
+        strings[n++] = image_string(&image, path_key, &failed);
+        strings[n++] = image_string(&image, config->theme_name, &failed);
+        strings[n++] = image_string(&image, config->title, &failed);
+        strings[n++] = image_string(&image, config->footer, &failed);
+        for (int i = 0; i < config->column_count; i++) {
+            strings[n++] = image_string(&image, config->columns[i].header, &failed);
+            strings[n++] = image_string(&image, config->columns[i].key, &failed);
+            strings[n++] = image_string(&image, config->columns[i].format, &failed);
+            strings[n++] = image_string(&image, config->columns[i].wrap_char, &failed);
+        }
+        for (int i = 0; i < config->sort_count; i++) {
+            strings[n++] = image_string(&image, config->sorts[i].key, &failed);
+        }
+    }
+    if (failed) {
+        free(strings);
+        free(image.data);
+        return;
+    }
+
+    LayoutImage *header = (LayoutImage *)image.data;
+    memcpy(header->magic, "TBLAYOUT", 8);
+    header->format = LAYOUT_CACHE_FORMAT;
+    header->config_size = sizeof(TableConfig);
+    header->column_size = sizeof(ColumnConfig);
+    header->sort_size = sizeof(SortConfig);
+    snprintf(header->version, sizeof(header->version), "%s", version);
+    header->mtime_sec = info->st_mtim.tv_sec;
+    header->mtime_nsec = info->st_mtim.tv_nsec;
+    header->layout_size = info->st_size;
+    header->image_size = image.used;
+
+    // Copy the scalars, leaving out what is set up again after loading
+    n = 0;
+    header->path = (uint64_t)(uintptr_t)strings[n++];
+    header->config = *config;
+    memset(&header->config.theme, 0, sizeof(ThemeConfig));
+    memset(&header->config.top_border, 0, sizeof(BorderLine));
+    memset(&header->config.separator, 0, sizeof(BorderLine));
+    memset(&header->config.bottom_border, 0, sizeof(BorderLine));
+    header->config.projection = NULL;
+    header->config.image = NULL;
+    header->config.image_size = 0;
+    header->config.theme_name = strings[n++];
+    header->config.title = strings[n++];
+    header->config.footer = strings[n++];
+    header->config.columns = (ColumnConfig *)(uintptr_t)columns;
+    header->config.sorts = (SortConfig *)(uintptr_t)sorts;
+    ColumnConfig *image_columns = (ColumnConfig *)(image.data + columns);
+    for (int i = 0; i < config->column_count; i++) {
+        image_columns[i] = config->columns[i];
+        image_columns[i].header = strings[n++];
+        image_columns[i].key = strings[n++];
+        image_columns[i].format = strings[n++];
+        image_columns[i].wrap_char = strings[n++];
+    }
+    SortConfig *image_sorts = (SortConfig *)(image.data + sorts);
+    for (int i = 0; i < config->sort_count; i++) {
+        image_sorts[i] = config->sorts[i];
+        image_sorts[i].key = strings[n++];
+    }
+    free(strings);
+    header->checksum = image_checksum(image.data, image.used);
+
+    char temp[4300];
+    cache_create_directory(dir);
+    snprintf(temp, sizeof(temp), "%s.%ld", path, (long)getpid());
+    FILE *fp = fopen(temp, "wb");
+    if (fp == NULL) {
+        if (tables_debug_mode) fprintf(stderr, "Debug: Cannot write layout cache %s\n", temp);
+        free(image.data);
+        return;
+    }
+    int write_failed = fwrite(image.data, 1, image.used, fp) != image.used;
+    if (fclose(fp) != 0 || write_failed || rename(temp, path) != 0) {
+        if (tables_debug_mode) fprintf(stderr, "Debug: Cannot write layout cache %s\n", path);
+        unlink(temp);
+    } else if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Wrote layout cache %s of %zu bytes\n", path, image.used);
+    }
+    free(image.data);
+}
+
+/*
+ * Helper function to turn a stored string offset back into a pointer, returning 1 if it is bad
+ */
+static int relocate_string(char *base, size_t size, char **field) {
+    size_t offset = (size_t)(uintptr_t)*field;
+    if (offset == 0) return 0;
+    if (offset < sizeof(LayoutImage) || offset >= size || memchr(base + offset, '\0', size - offset) == NULL) {
+        return 1;
+    }
+    *field = base + offset;
+    return 0;
+}
+
+/*
+ * Helper function to turn a stored array offset back into a pointer, returning NULL if it is bad
+ */
+static void *relocate_array(char *base, size_t size, void *field, size_t bytes) {
+    size_t offset = (size_t)(uintptr_t)field;
+    if (offset < sizeof(LayoutImage) || offset % 8 != 0 || offset > size || bytes > size - offset) return NULL;
+    return base + offset;
+}
+
+/*
+ * Helper function to map the cached image of a layout into config, returning 0 if it is valid
+ */
+static int read_layout_image(const char *path, const char *path_key, const struct stat *info,
+                             const char *version, TableConfig *config) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 1;
+    struct stat image_info;
+    if (fstat(fd, &image_info) != 0 || (size_t)image_info.st_size < sizeof(LayoutImage)) {
+        close(fd);
+        return 1;
+    }
+    size_t size = (size_t)image_info.st_size;
+    char *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 1;
+
+    // The image must be intact and come from this build and the layout file as it is now
+    LayoutImage *header = (LayoutImage *)base;
+    char *image_path = (char *)(uintptr_t)header->path;
+    uint64_t checksum = header->checksum;
+    header->checksum = 0;
+    int bad = image_checksum(base, size) != checksum ||
+              memcmp(header->magic, "TBLAYOUT", 8) != 0 || header->format != LAYOUT_CACHE_FORMAT ||
+              header->config_size != sizeof(TableConfig) || header->column_size != sizeof(ColumnConfig) ||
+              header->sort_size != sizeof(SortConfig) || header->image_size != size ||
+              strncmp(header->version, version, sizeof(header->version)) != 0 ||
+              header->mtime_sec != info->st_mtim.tv_sec || header->mtime_nsec != info->st_mtim.tv_nsec ||
+              header->layout_size != info->st_size ||
+              relocate_string(base, size, &image_path) != 0 || image_path == NULL ||
+              strcmp(image_path, path_key) != 0;
+
+    TableConfig *image = &header->config;
+    if (!bad) {
+        bad = image->column_count <= 0 || image->column_count > MAX_COLUMNS ||
+              image->sort_count < 0 || image->sort_count > 1000000 ||
+              relocate_string(base, size, &image->theme_name) != 0 ||
+              relocate_string(base, size, &image->title) != 0 ||
+              relocate_string(base, size, &image->footer) != 0;
+    }
+    if (!bad) {
+        image->columns = relocate_array(base, size, image->columns, image->column_count * sizeof(ColumnConfig));
+        image->sorts = relocate_array(base, size, image->sorts, image->sort_count * sizeof(SortConfig));
+        bad = image->columns == NULL || image->sorts == NULL;
+    }
+    for (int i = 0; !bad && i < image->column_count; i++) {
+        ColumnConfig *col = &image->columns[i];
+        bad = relocate_string(base, size, &col->header) != 0 || relocate_string(base, size, &col->key) != 0 ||
+              relocate_string(base, size, &col->format) != 0 || relocate_string(base, size, &col->wrap_char) != 0;
+    }
+    for (int i = 0; !bad && i < image->sort_count; i++) {
+        bad = relocate_string(base, size, &image->sorts[i].key) != 0;
+    }
+    if (bad) {
+        munmap(base, size);
+        return 1;
+    }
+
+    *config = *image;
+    if (config->sort_count == 0) config->sorts = NULL;
+    config->image = base;
+    config->image_size = size;
+    if (projection_compile(config) != 0) {
+        layout_cache_unmap(config);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Parse a layout file, using its cached image when there is one for the file as it is now
+ * Layouts that are not regular files are always parsed. On a miss the layout is parsed and the
+ * image written for the next run, a cache that cannot be written only costs the parse
+ */
+int parse_layout_cached(const char *filename, const char *version, TableConfig *config) {
+    struct stat info;
+    char path_key[4096], path[4200], dir[4096];
+    if (stat(filename, &info) != 0 || !S_ISREG(info.st_mode) || realpath(filename, path_key) == NULL ||
+        cache_file_path(path_key, ".layout", path, sizeof(path), dir) != 0) {
+        return parse_layout_file(filename, config);
+    }
+
+    if (read_layout_image(path, path_key, &info, version, config) == 0) {
+        if (tables_debug_mode) {
+            fprintf(stderr, "Debug: Read layout %s from cache %s\n", filename, path);
+        }
+        return 0;
+    }
+
+    if (parse_layout_file(filename, config) != 0) {
+        return 1;
+    }
+    write_layout_image(config, path_key, &info, version, path, dir);
+    return 0;
+}
+
+/*
+ * Release a layout read from a cached image, called by free_table_config()
+ */
+void layout_cache_unmap(TableConfig *config) {
+    projection_free(config);
+    free(config->top_border.text);
+    free(config->separator.text);
+    free(config->bottom_border.text);
+    munmap(config->image, config->image_size);
+    memset(config, 0, sizeof(TableConfig));
+}
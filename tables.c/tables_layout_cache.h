@@ -0,0 +1,21 @@
+/*
+ * tables_layout_cache.h - Header file for caching parsed layouts as binary images
+ * A parsed TableConfig is stored as one flat image with its pointers written as offsets into the
+ * image, so later runs map the file and relocate the pointers instead of parsing the layout JSON.
+ * An image is only used by the version of tables that wrote it, for the same layout file path,
+ * modification time and size, and is rebuilt whenever any of them differs.
+ */
+
+#ifndef TABLES_LAYOUT_CACHE_H
+#define TABLES_LAYOUT_CACHE_H
+
+#include "tables_config.h"
+
+/* Version of the image contents, raised whenever they change */
+#define LAYOUT_CACHE_FORMAT 4
+
+/* Function prototypes */
+int parse_layout_cached(const char *filename, const char *version, TableConfig *config);
+void layout_cache_unmap(TableConfig *config);
+
+#endif /* TABLES_LAYOUT_CACHE_H */
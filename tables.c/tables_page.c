@@ -0,0 +1,94 @@
+/*
+ * tables_page.c - Implementation of splitting the rows of a table into pages
+ * Rows are numbered in the order they are shown, after sorting and any limit, so the same page
+ * is picked whether the rows were loaded, streamed or read from a mapped file.
+ */
+
+#include <stdio.h>
+#include <limits.h>
+#include "tables_page.h"
+
+static int page_size = 0;       /* Rows per page from --page_size, 0 for one page of all rows */
+static int page_number = 0;     /* Page from --page, counting from 1, 0 to show every page */
+
+/*
+ * Set the number of rows per page from --page_size
+ */
+int page_set_size(long rows) {
+    if (rows <= 0 || rows > INT_MAX) {
+        fprintf(stderr, "Error: --page_size needs a positive number of rows\n");
+        return 1;
+    }
+    page_size = (int)rows;
+    return 0;
+}
+
+/*
+ * Set the only page shown from --page, counting from 1
+ */
+int page_set_number(long page) {
+    if (page <= 0 || page > INT_MAX) {
+        fprintf(stderr, "Error: --page needs a page number, counting from 1\n");
+        return 1;
+    }
+    page_number = (int)page;
+    return 0;
+}
+
+/*
+ * Check the paging options once they have all been read, returning 1 after printing an error
+ */
+int page_check_options(void) {
+    if (page_number > 0 && page_size == 0) {
+        fprintf(stderr, "Error: --page needs --page_size\n");
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Return 1 if the row with this position among the rows shown is on the page printed
+ */
+int page_row_shown(int row) {
+    if (page_number == 0) return 1;
+    return row / page_size == page_number - 1;
+}
+
+/*
+ * Return 1 if the column headers are repeated before this row, as it starts a page
+ * Only every page printed in turn repeats them, a single page has them at the top of the table
+ */
+int page_row_starts_page(int row) {
+    return page_size > 0 && page_number == 0 && row > 0 && row % page_size == 0;
+}
+
+/*
+ * Return 1 if this row and the rows after it are past the page printed
+ */
+int page_row_past_end(int row) {
+    return page_number > 0 && row / page_size >= page_number;
+}
+
+/*
+ * Set the range of rows from first up to end that are on the page printed
+ */
+void page_window(int row_count, int *first, int *end) {
+    *first = 0;
+    *end = row_count;
+    if (page_number == 0) return;
+    long start = (long)(page_number - 1) * page_size;
+    long stop = start + page_size;
+    *first = start < row_count ? (int)start : row_count;
+    *end = stop < row_count ? (int)stop : row_count;
+}
+
+/*
+ * Warn when the page printed is past the last page of the rows shown
+ */
+void page_check_rows(int row_count) {
+    if (page_number == 0) return;
+    int last_page = row_count > 0 ? (int)(((long)row_count + page_size - 1) / page_size) : 1;
+    if (page_number > last_page) {
+        fprintf(stderr, "Warning: --page %d is past the last page, %d\n", page_number, last_page);
+    }
+}
@@ -0,0 +1,21 @@
+/*
+ * tables_page.h - Header file for splitting the rows of a table into pages
+ * With --page_size the rows shown are split into pages of that many rows, with the column headers
+ * repeated at the top of every page. With --page only that page is formatted and printed, while
+ * the column widths and summaries still cover every row, so each page lines up with the others.
+ */
+
+#ifndef TABLES_PAGE_H
+#define TABLES_PAGE_H
+
+/* Function prototypes */
+int page_set_size(long rows);
+int page_set_number(long page);
+int page_check_options(void);
+int page_row_shown(int row);
+int page_row_starts_page(int row);
+int page_row_past_end(int row);
+void page_window(int row_count, int *first, int *end);
+void page_check_rows(int row_count);
+
+#endif /* TABLES_PAGE_H */
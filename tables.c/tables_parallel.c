@@ -0,0 +1,114 @@
+/*
+ * tables_parallel.c - Implementation of spreading row processing over several threads
+ * Each block runs on a thread of its own with its own arena selected, so formatted text can be
+ * allocated without locking. The arenas live until the end of the run, as formatted cells are
+ * kept for the renderer. Block boundaries are multiples of 8 rows, so the bitmaps of the column
+ * store are never written by two threads at once.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "tables_parallel.h"
+#include "tables_arena.h"
+
+extern int tables_debug_mode;
+
+static int thread_count = 0;            /* Threads to use, 0 until set or detected */
+static Arena block_arenas[MAX_THREADS]; /* Arena of each block */
+
+/* Structure describing one block handed to a thread */
+typedef struct {
+    ParallelWork work;
+    void *context;
+    int block;
+    int start;
+    int end;
+} ParallelBlock;
+
+/*
+ * Set the number of threads used for row processing, returning 1 if the count is not usable
+ */
+int parallel_set_threads(long count) {
+    if (count < 1 || count > MAX_THREADS) {
+        fprintf(stderr, "Error: --threads needs a number from 1 to %d\n", MAX_THREADS);
+        return 1;
+    }
+    thread_count = (int)count;
+    return 0;
+}
+
+/*
+ * Return the number of blocks row_count rows should be split into
+ * Defaults to one block per core, and debug output is kept in order by using a single block
+ */
+int parallel_block_count(int row_count) {
+    if (thread_count == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cores < 1 ? 1 : (cores > MAX_THREADS ? MAX_THREADS : (int)cores);
+    }
+    if (tables_debug_mode) return 1;
+
+    int blocks = row_count / PARALLEL_MIN_ROWS;
+    if (blocks > thread_count) blocks = thread_count;
+    return blocks < 1 ? 1 : blocks;
+}
+
+/*
+ * Helper function to process one block with its arena selected
+ */
+static void *parallel_block(void *arg) {
+    ParallelBlock *block = arg;
+    Arena *previous = arena_use(&block_arenas[block->block]);
+    block->work(block->context, block->block, block->start, block->end);
+    arena_use(previous);
+    return NULL;
+}
+
+/*
+ * Split row_count rows into block_count blocks and process each block on a thread of its own
+ * Returns once all blocks are done. A single block is processed directly in the current arena,
+ * and a block whose thread cannot be started is processed by the calling thread instead.
+ */
+void parallel_run(int row_count, int block_count, ParallelWork work, void *context) {
+    if (block_count > MAX_THREADS) block_count = MAX_THREADS;
+    if (block_count <= 1) {
+        work(context, 0, 0, row_count);
+        return;
+    }
+
+    ParallelBlock blocks[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    int started[MAX_THREADS];
+    int block_rows = (row_count + block_count - 1) / block_count;
+    block_rows = (block_rows + 7) & ~7;
+
+    for (int b = 0; b < block_count; b++) {
+        int start = b * block_rows;
+        int end = start + block_rows;
+        if (start > row_count) start = row_count;
+        if (end > row_count) end = row_count;
+        blocks[b].work = work;
+        blocks[b].context = context;
+        blocks[b].block = b;
+        blocks[b].start = start;
+        blocks[b].end = end;
+        started[b] = (pthread_create(&threads[b], NULL, parallel_block, &blocks[b]) == 0);
+        if (!started[b]) {
+            parallel_block(&blocks[b]);
+        }
+    }
+    for (int b = 0; b < block_count; b++) {
+        if (started[b]) pthread_join(threads[b], NULL);
+    }
+}
+
+/*
+ * Release the arenas of all blocks, called once the table is complete
+ */
+void parallel_release(void) {
+    for (int b = 0; b < MAX_THREADS; b++) {
+        if (block_arenas[b].first) arena_release(&block_arenas[b]);
+    }
+}
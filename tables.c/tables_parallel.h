@@ -0,0 +1,25 @@
+/*
+ * tables_parallel.h - Header file for spreading row processing over several threads
+ * Rows are split into contiguous blocks that are processed by one thread each, every block
+ * allocating from an arena of its own. Results are combined by the caller in block order.
+ */
+
+#ifndef TABLES_PARALLEL_H
+#define TABLES_PARALLEL_H
+
+/* Largest number of threads accepted by --threads */
+#define MAX_THREADS 256
+
+/* Smallest number of rows worth a thread of its own */
+#define PARALLEL_MIN_ROWS 256
+
+/* Work done for the rows start to end (exclusive) of one block */
+typedef void (*ParallelWork)(void *context, int block, int start, int end);
+
+/* Function prototypes */
+int parallel_set_threads(long count);
+int parallel_block_count(int row_count);
+void parallel_run(int row_count, int block_count, ParallelWork work, void *context);
+void parallel_release(void);
+
+#endif /* TABLES_PARALLEL_H */
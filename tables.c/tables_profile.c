@@ -0,0 +1,90 @@
+/*
+ * tables_profile.c - Implementation of the phase timings and counters reported by --profile
+ * Phases are switched from the main thread only. Counters can be added to from the threads
+ * formatting rows, so they are updated atomically, and only while profiling.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "tables_profile.h"
+#include "tables_arena.h"
+
+int profile_mode = 0;
+
+static const char *phase_names[PROFILE_PHASE_COUNT] = {
+    NULL, "validate", "parse", "theme", "load", "sort", "process", "widths", "format", "output", "commands"
+};
+
+static const char *counter_names[PROFILE_COUNTER_COUNT] = {
+    "tables", "rows", "cells", "commands_run", "bytes_written"
+};
+
+static double phase_ms[PROFILE_PHASE_COUNT]; /* Time spent in each phase */
+static long counters[PROFILE_COUNTER_COUNT];
+static ProfilePhase current_phase = PROFILE_NONE;
+static double phase_start_ms = 0;           /* Time the current phase was switched to */
+static double run_start_ms = 0;             /* Time profiling was enabled */
+
+/*
+ * Helper function to return the current time in milliseconds
+ */
+static double now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+/*
+ * Start profiling the run, from --profile
+ */
+void profile_enable(void) {
+    profile_mode = 1;
+    run_start_ms = now_ms();
+    phase_start_ms = run_start_ms;
+}
+
+/*
+ * Switch to another phase, returning the phase that was running so it can be switched back to
+ * Does nothing unless profiling
+ */
+ProfilePhase profile_switch(ProfilePhase phase) {
+    if (!profile_mode) return PROFILE_NONE;
+    double now = now_ms();
+    ProfilePhase previous = current_phase;
+    phase_ms[previous] += now - phase_start_ms;
+    phase_start_ms = now;
+    current_phase = phase;
+    return previous;
+}
+
+/*
+ * Add to a counter, does nothing unless profiling
+ */
+void profile_add(ProfileCounter counter, long amount) {
+    if (!profile_mode) return;
+    __atomic_fetch_add(&counters[counter], amount, __ATOMIC_RELAXED);
+}
+
+/*
+ * Print the timings and counters as one line of JSON on stderr
+ * Arena figures cover every arena used in the run: allocations and bytes handed out, and the
+ * chunks behind them, which are the heap allocations made for row values and formatted text
+ */
+void profile_report(void) {
+    if (!profile_mode) return;
+    profile_switch(PROFILE_NONE);
+
+    ArenaTotals arenas;
+    arena_totals(&arenas);
+    fprintf(stderr, "{\"profile\":{\"total_ms\":%.3f,\"phases_ms\":{", now_ms() - run_start_ms);
+    for (int p = PROFILE_NONE + 1; p < PROFILE_PHASE_COUNT; p++) {
+        fprintf(stderr, "%s\"%s\":%.3f", p > PROFILE_NONE + 1 ? "," : "", phase_names[p], phase_ms[p]);
+    }
+    fprintf(stderr, "}");
+    for (int c = 0; c < PROFILE_COUNTER_COUNT; c++) {
+        fprintf(stderr, ",\"%s\":%ld", counter_names[c], counters[c]);
+    }
+    fprintf(stderr, ",\"arena_allocations\":%zu,\"arena_bytes\":%zu,\"arena_peak_bytes\":%zu,"
+            "\"arena_chunks\":%d,\"arena_chunk_bytes\":%zu}}\n",
+            arenas.allocations, arenas.bytes_allocated, arenas.peak_bytes, arenas.chunk_count, arenas.bytes_reserved);
+}
@@ -0,0 +1,47 @@
+/*
+ * tables_profile.h - Header file for the phase timings and counters reported by --profile
+ * The run is split into phases, and the monotonic clock time between two phase switches is
+ * added to the phase that was running, so nested work such as writing output or waiting for a
+ * command is taken out of the phase it interrupts. Counters are added up as the table is built.
+ * Everything is reported as one line of JSON on stderr at the end of the run.
+ */
+
+#ifndef TABLES_PROFILE_H
+#define TABLES_PROFILE_H
+
+/* Phases of a run, PROFILE_NONE being time outside any of them */
+typedef enum {
+    PROFILE_NONE,
+    PROFILE_VALIDATE,       /* Checking the input files */
+    PROFILE_PARSE,          /* Parsing the layout */
+    PROFILE_THEME,          /* Setting up the theme */
+    PROFILE_LOAD,           /* Reading the data, up to the summaries */
+    PROFILE_SORT,           /* Sorting the rows */
+    PROFILE_PROCESS,        /* Processing the rows and summaries */
+    PROFILE_WIDTHS,         /* Calculating the column widths */
+    PROFILE_FORMAT,         /* Formatting and laying out the rows and borders */
+    PROFILE_OUTPUT,         /* Writing the output */
+    PROFILE_COMMANDS,       /* Waiting for $() commands */
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+/* Counters of a run */
+typedef enum {
+    PROFILE_TABLES,         /* Tables rendered */
+    PROFILE_ROWS,           /* Data rows formatted */
+    PROFILE_CELLS,          /* Cells formatted */
+    PROFILE_COMMANDS_RUN,   /* $() commands started */
+    PROFILE_BYTES_WRITTEN,  /* Bytes of output written */
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+/* Flag set by --profile, checked before anything is counted */
+extern int profile_mode;
+
+/* Function prototypes */
+void profile_enable(void);
+ProfilePhase profile_switch(ProfilePhase phase);
+void profile_add(ProfileCounter counter, long amount);
+void profile_report(void);
+
+#endif /* TABLES_PROFILE_H */
@@ -0,0 +1,542 @@
+/*
+ * tables_projection.c - Implementation of extracting column values from row object text
+ * Rows are scanned by hand instead of being parsed into jansson values. The scan only accepts
+ * what jansson would, and gives up on anything it does not handle itself, such as integers out of
+ * range, so that the caller can parse those rows with jansson and report errors the same way.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "tables_projection.h"
+#include "tables_arena.h"
+
+/* Structure holding the state of the scan of one row */
+typedef struct {
+    const char *pos;        /* Next byte to scan */
+    const char *end;        /* End of the row text */
+    int depth;              /* Current nesting of objects and arrays */
+    char **values;          /* Values of the row's columns, NULL until found */
+    unsigned char *priorities; /* Priority of the target that set each value */
+} RowScan;
+
+/*
+ * Helper function to find or add the child of a node with the given name
+ * Returns NULL if memory runs out
+ */
+static ProjectionNode *projection_child(ProjectionNode *node, const char *name, size_t length) {
+    for (int i = 0; i < node->child_count; i++) {
+        ProjectionNode *child = &node->children[i];
+        if (child->name_length == length && memcmp(child->name, name, length) == 0) {
+            return child;
+        }
+    }
+    ProjectionNode *children = realloc(node->children, (node->child_count + 1) * sizeof(ProjectionNode));
+    if (children == NULL) return NULL;
+    node->children = children;
+    ProjectionNode *child = &children[node->child_count];
+    memset(child, 0, sizeof(ProjectionNode));
+    child->name = malloc(length + 1);
+    if (child->name == NULL) return NULL;
+    memcpy(child->name, name, length);
+    child->name[length] = '\0';
+    child->name_length = length;
+    node->child_count++;
+    return child;
+}
+
+/*
+ * Helper function to make a node show its value in a column
+ */
+static int projection_target(ProjectionNode *node, int column, int priority) {
+    ProjectionTarget *targets = realloc(node->targets, (node->target_count + 1) * sizeof(ProjectionTarget));
+    if (targets == NULL) return 1;
+    node->targets = targets;
+    targets[node->target_count].column = column;
+    targets[node->target_count].priority = priority;
+    node->target_count++;
+    return 0;
+}
+
+/*
+ * Compile the column keys of a layout into config->projection
+ */
+int projection_compile(TableConfig *config) {
+    Projection *projection = calloc(1, sizeof(Projection));
+    if (projection == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for column key lookup\n");
+        return 1;
+    }
+    projection->column_count = config->column_count;
+    config->projection = projection;
+
+    for (int j = 0; j < config->column_count; j++) {
+        const char *key = config->columns[j].key;
+        if (key == NULL) continue;
+
+        // The whole key names a field of the row
+        ProjectionNode *node = projection_child(&projection->root, key, strlen(key));
+        if (node == NULL || projection_target(node, j, 2) != 0) {
+            fprintf(stderr, "Error: Memory allocation failed for column key lookup\n");
+            return 1;
+        }
+
+        // A dotted key also names a field of nested objects, one object per part
+        if (strchr(key, '.') == NULL) continue;
+        node = &projection->root;
+        const char *part = key;
+        while (node) {
+            const char *dot = strchr(part, '.');
+            size_t length = dot ? (size_t)(dot - part) : strlen(part);
+            node = projection_child(node, part, length);
+            if (dot == NULL) break;
+            part = dot + 1;
+        }
+        if (node == NULL || projection_target(node, j, 1) != 0) {
+            fprintf(stderr, "Error: Memory allocation failed for column key lookup\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Helper function to free a node and everything below it
+ */
+static void projection_free_node(ProjectionNode *node) {
+    for (int i = 0; i < node->child_count; i++) {
+        projection_free_node(&node->children[i]);
+    }
+    free(node->children);
+    free(node->targets);
+    free(node->name);
+}
+
+/*
+ * Free the compiled column keys of a layout
+ */
+void projection_free(TableConfig *config) {
+    if (config->projection == NULL) return;
+    projection_free_node(&config->projection->root);
+    free(config->projection);
+    config->projection = NULL;
+}
+
+/*
+ * Helper function to skip JSON whitespace
+ */
+static void scan_whitespace(RowScan *scan) {
+    while (scan->pos < scan->end &&
+           (*scan->pos == ' ' || *scan->pos == '\t' || *scan->pos == '\n' || *scan->pos == '\r')) {
+        scan->pos++;
+    }
+}
+
+/*
+ * Helper function to return the next byte without consuming it, or -1 at the end
+ */
+static int scan_peek(RowScan *scan) {
+    return scan->pos < scan->end ? (unsigned char)*scan->pos : -1;
+}
+
+/*
+ * Helper function to check one UTF-8 encoded character, returning its length or 0 if invalid
+ * Overlong encodings, surrogates and code points above U+10FFFF are rejected as jansson does
+ */
+static size_t utf8_length(const unsigned char *s, const unsigned char *end) {
+    size_t length;
+    unsigned int code;
+    if (s[0] < 0x80) return 1;
+    if (s[0] >= 0xC2 && s[0] <= 0xDF) {
+        length = 2;
+        code = s[0] & 0x1F;
+    } else if (s[0] >= 0xE0 && s[0] <= 0xEF) {
+        length = 3;
+        code = s[0] & 0x0F;
+    } else if (s[0] >= 0xF0 && s[0] <= 0xF4) {
+        length = 4;
+        code = s[0] & 0x07;
+    } else {
+        return 0;
+    }
+    if ((size_t)(end - s) < length) return 0;
+    for (size_t i = 1; i < length; i++) {
+        if ((s[i] & 0xC0) != 0x80) return 0;
+        code = (code << 6) | (s[i] & 0x3F);
+    }
+    if ((length == 3 && code < 0x800) || (length == 4 && code < 0x10000)) return 0;
+    if ((code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF) return 0;
+    return length;
+}
+
+/*
+ * Helper function to read the four hex digits of a \u escape, returning -1 if they are not
+ */
+static long hex_value(const char *s) {
+    long value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = s[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return -1;
+    }
+    return value;
+}
+
+/*
+ * Helper function to scan a string whose opening quote is next
+ * Sets the raw text between the quotes and whether it holds escapes, returns 1 on bad text
+ */
+static int scan_string(RowScan *scan, const char **text, size_t *length, int *escaped) {
+    const char *s = ++scan->pos;
+    *escaped = 0;
+    while (s < scan->end) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"') {
+            *text = scan->pos;
+            *length = (size_t)(s - scan->pos);
+            scan->pos = s + 1;
+            return 0;
+        }
+        if (c < 0x20) return 1;
+        if (c == '\\') {
+            *escaped = 1;
+            if (s + 1 >= scan->end) return 1;
+            char e = s[1];
+            if (e == 'u') {
+                if (scan->end - s < 6 || hex_value(s + 2) < 0) return 1;
+                s += 6;
+            } else if (e == '"' || e == '\\' || e == '/' || e == 'b' || e == 'f' ||
+                       e == 'n' || e == 'r' || e == 't') {
+                s += 2;
+            } else {
+                return 1;
+            }
+            continue;
+        }
+        size_t step = utf8_length((const unsigned char *)s, (const unsigned char *)scan->end);
+        if (step == 0) return 1;
+        s += step;
+    }
+    return 1;
+}
+
+/*
+ * Helper function to decode the escapes of a scanned string into out, which holds length bytes
+ * A decoded string is never longer than its escaped text, and out can be NULL to only check the
+ * escapes. Returns 1 on escapes jansson rejects
+ */
+static int decode_string(const char *text, size_t length, char *out, size_t *out_length) {
+    const char *end = text + length;
+    size_t used = 0;
+    while (text < end) {
+        char unit[4];
+        size_t size = 1;
+        if (*text != '\\') {
+            unit[0] = *text++;
+        } else {
+            char e = text[1];
+            text += 2;
+            if (e == 'u') {
+                long code = hex_value(text);
+                text += 4;
+                if (code >= 0xDC00 && code <= 0xDFFF) return 1;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // A high surrogate needs the low surrogate of the pair right after it
+                    if (end - text < 6 || text[0] != '\\' || text[1] != 'u') return 1;
+                    long low = hex_value(text + 2);
+                    if (low < 0xDC00 || low > 0xDFFF) return 1;
+                    text += 6;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                if (code == 0) return 1;
+                if (code < 0x80) {
+                    unit[0] = (char)code;
+                } else if (code < 0x800) {
+                    unit[0] = (char)(0xC0 | (code >> 6));
+                    unit[1] = (char)(0x80 | (code & 0x3F));
+                    size = 2;
+                } else if (code < 0x10000) {
+                    unit[0] = (char)(0xE0 | (code >> 12));
+                    unit[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    unit[2] = (char)(0x80 | (code & 0x3F));
+                    size = 3;
+                } else {
+                    unit[0] = (char)(0xF0 | (code >> 18));
+                    unit[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                    unit[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    unit[3] = (char)(0x80 | (code & 0x3F));
+                    size = 4;
+                }
+            } else {
+                unit[0] = e == 'b' ? '\b' : e == 'f' ? '\f' : e == 'n' ? '\n' : e == 'r' ? '\r' : e == 't' ? '\t' : e;
+            }
+        }
+        if (out) memcpy(out + used, unit, size);
+        used += size;
+    }
+    *out_length = used;
+    return 0;
+}
+
+/*
+ * Helper function to scan a number, formatting it into buffer when buffer is not NULL
+ * The text is printed the way jansson's value would be, returns 1 on bad or out of range numbers
+ */
+static int scan_number(RowScan *scan, char *buffer, size_t size) {
+    const char *start = scan->pos;
+    const char *s = start;
+    int real = 0;
+    if (s < scan->end && *s == '-') s++;
+    if (s < scan->end && *s == '0') {
+        s++;
+    } else if (s < scan->end && *s >= '1' && *s <= '9') {
+        while (s < scan->end && *s >= '0' && *s <= '9') s++;
+    } else {
+        return 1;
+    }
+    if (s < scan->end && *s == '.') {
+        real = 1;
+        s++;
+        if (s >= scan->end || *s < '0' || *s > '9') return 1;
+        while (s < scan->end && *s >= '0' && *s <= '9') s++;
+    }
+    if (s < scan->end && (*s == 'e' || *s == 'E')) {
+        real = 1;
+        s++;
+        if (s < scan->end && (*s == '+' || *s == '-')) s++;
+        if (s >= scan->end || *s < '0' || *s > '9') return 1;
+        while (s < scan->end && *s >= '0' && *s <= '9') s++;
+    }
+    scan->pos = s;
+
+    // Convert a NUL terminated copy, as the row text may end right after the number
+    char digits[64];
+    size_t length = (size_t)(s - start);
+    if (length >= sizeof(digits)) return 1;
+    memcpy(digits, start, length);
+    digits[length] = '\0';
+    errno = 0;
+    if (real) {
+        double number = strtod(digits, NULL);
+        if (isinf(number)) return 1;
+        if (buffer) format_real_value(number, buffer, size);
+    } else {
+        long long number = strtoll(digits, NULL, 10);
+        if (errno == ERANGE) return 1;
+        if (buffer) snprintf(buffer, size, "%lld", number);
+    }
+    return 0;
+}
+
+/*
+ * Helper function to scan a literal such as true, returning 1 if the text is not that literal
+ */
+static int scan_literal(RowScan *scan, const char *literal) {
+    size_t length = strlen(literal);
+    if ((size_t)(scan->end - scan->pos) < length || memcmp(scan->pos, literal, length) != 0) return 1;
+    scan->pos += length;
+    return 0;
+}
+
+/*
+ * Helper function to store a value in the columns of a node's targets
+ */
+static int assign_value(RowScan *scan, const ProjectionNode *node, const char *text, size_t length) {
+    for (int i = 0; i < node->target_count; i++) {
+        const ProjectionTarget *target = &node->targets[i];
+        if (target->priority < scan->priorities[target->column]) continue;
+        char *value = arena_strndup(text, length);
+        if (value == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
+            return 1;
+        }
+        scan->values[target->column] = value;
+        scan->priorities[target->column] = (unsigned char)target->priority;
+    }
+    return 0;
+}
+
+static int scan_value(RowScan *scan, const ProjectionNode *node);
+
+/*
+ * Helper function to forget the values found below a node, as a later field of the same name
+ * replaces the earlier one in jansson
+ */
+static void clear_nested_values(RowScan *scan, const ProjectionNode *node) {
+    for (int i = 0; i < node->child_count; i++) {
+        const ProjectionNode *child = &node->children[i];
+        for (int t = 0; t < child->target_count; t++) {
+            int column = child->targets[t].column;
+            if (scan->priorities[column] == child->targets[t].priority) {
+                scan->values[column] = NULL;
+                scan->priorities[column] = 0;
+            }
+        }
+        clear_nested_values(scan, child);
+    }
+}
+
+/*
+ * Helper function to scan an object whose opening brace is next
+ * The fields are looked up among the children of node, or skipped when node is NULL
+ */
+static int scan_object(RowScan *scan, const ProjectionNode *node) {
+    if (++scan->depth > PROJECTION_MAX_DEPTH) return 1;
+    scan->pos++;
+    scan_whitespace(scan);
+    if (scan_peek(scan) == '}') {
+        scan->pos++;
+        scan->depth--;
+        return 0;
+    }
+    while (1) {
+        const char *name;
+        size_t name_length;
+        int escaped;
+        scan_whitespace(scan);
+        if (scan_peek(scan) != '"' || scan_string(scan, &name, &name_length, &escaped) != 0) return 1;
+
+        // Keys with escapes are compared once decoded
+        char decoded[256];
+        if (escaped) {
+            if (name_length > sizeof(decoded)) return 1;
+            if (decode_string(name, name_length, decoded, &name_length) != 0) return 1;
+            name = decoded;
+        }
+        const ProjectionNode *child = NULL;
+        for (int i = 0; node && i < node->child_count; i++) {
+            if (node->children[i].name_length == name_length &&
+                memcmp(node->children[i].name, name, name_length) == 0) {
+                child = &node->children[i];
+                break;
+            }
+        }
+
+        scan_whitespace(scan);
+        if (scan_peek(scan) != ':') return 1;
+        scan->pos++;
+        scan_whitespace(scan);
+        if (child && child->child_count > 0) clear_nested_values(scan, child);
+        if (scan_value(scan, child) != 0) return 1;
+        scan_whitespace(scan);
+        int c = scan_peek(scan);
+        scan->pos++;
+        if (c == '}') break;
+        if (c != ',') return 1;
+    }
+    scan->depth--;
+    return 0;
+}
+
+/*
+ * Helper function to skip an array whose opening bracket is next
+ */
+static int scan_array(RowScan *scan) {
+    if (++scan->depth > PROJECTION_MAX_DEPTH) return 1;
+    scan->pos++;
+    scan_whitespace(scan);
+    if (scan_peek(scan) == ']') {
+        scan->pos++;
+        scan->depth--;
+        return 0;
+    }
+    while (1) {
+        scan_whitespace(scan);
+        if (scan_value(scan, NULL) != 0) return 1;
+        scan_whitespace(scan);
+        int c = scan_peek(scan);
+        scan->pos++;
+        if (c == ']') break;
+        if (c != ',') return 1;
+    }
+    scan->depth--;
+    return 0;
+}
+
+/*
+ * Helper function to scan one value, storing it in the columns of node's targets
+ * Strings and numbers are stored as text and anything else as "null", like load_row_values()
+ */
+static int scan_value(RowScan *scan, const ProjectionNode *node) {
+    int wanted = node && node->target_count > 0;
+    int c = scan_peek(scan);
+    if (c == '"') {
+        const char *text;
+        size_t length;
+        int escaped;
+        if (scan_string(scan, &text, &length, &escaped) != 0) return 1;
+        if (!wanted) {
+            return escaped ? decode_string(text, length, NULL, &length) : 0;
+        }
+        if (!escaped) {
+            return assign_value(scan, node, text, length);
+        }
+        char *decoded = arena_alloc(length + 1);
+        if (decoded == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
+            return 1;
+        }
+        if (decode_string(text, length, decoded, &length) != 0) return 1;
+        return assign_value(scan, node, decoded, length);
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        char buffer[32];
+        if (scan_number(scan, wanted ? buffer : NULL, sizeof(buffer)) != 0) return 1;
+        return wanted ? assign_value(scan, node, buffer, strlen(buffer)) : 0;
+    }
+    int status;
+    if (c == '{') {
+        status = scan_object(scan, node && node->child_count > 0 ? node : NULL);
+    } else if (c == '[') {
+        status = scan_array(scan);
+    } else if (c == 't') {
+        status = scan_literal(scan, "true");
+    } else if (c == 'f') {
+        status = scan_literal(scan, "false");
+    } else if (c == 'n') {
+        status = scan_literal(scan, "null");
+    } else {
+        return 1;
+    }
+    if (status != 0) return 1;
+    return wanted ? assign_value(scan, node, "null", 4) : 0;
+}
+
+/*
+ * Extract the column values of one row object from its JSON text into a DataRow
+ * Returns 0 on success and 1 if the text has to be parsed with jansson instead, either because
+ * it is not valid JSON or because it is not an object or holds values the scan leaves to jansson
+ */
+int project_row_values(const Projection *projection, const char *text, size_t length, DataRow *row) {
+    int column_count = projection->column_count;
+    RowScan scan = { text, text + length, 0, NULL, NULL };
+    scan.values = arena_calloc(column_count, sizeof(char *));
+    scan.priorities = arena_calloc(column_count, 1);
+    if (scan.values == NULL || scan.priorities == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for row values\n");
+        return 1;
+    }
+
+    scan_whitespace(&scan);
+    if (scan_peek(&scan) != '{' || scan_object(&scan, &projection->root) != 0) return 1;
+    scan_whitespace(&scan);
+    if (scan.pos != scan.end) return 1;
+
+    // Fields missing from the row are shown as null
+    for (int j = 0; j < column_count; j++) {
+        if (scan.values[j] == NULL) {
+            scan.values[j] = arena_strndup("null", 4);
+            if (scan.values[j] == NULL) {
+                fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
+                return 1;
+            }
+        }
+    }
+    row->values = scan.values;
+    return 0;
+}
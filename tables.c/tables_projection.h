@@ -0,0 +1,47 @@
+/*
+ * tables_projection.h - Header file for extracting column values from row object text
+ * The column keys of a layout are compiled once into a tree of field names, and each row object
+ * is then scanned once, copying the values of those fields and skipping all others without
+ * building JSON values for them. A key such as "metadata.name" names the "name" field of the
+ * "metadata" object, unless the row has a field called "metadata.name" itself.
+ */
+
+#ifndef TABLES_PROJECTION_H
+#define TABLES_PROJECTION_H
+
+#include <stddef.h>
+#include "tables_config.h"
+#include "tables_data.h"
+
+/* Deepest nesting of objects and arrays scanned in a row, deeper rows are left to jansson */
+#define PROJECTION_MAX_DEPTH 2048
+
+/* Structure tying a field to a column, with the field matched by the column's whole key
+ * taking priority over one matched by following the dotted path */
+typedef struct {
+    int column;             /* Column showing the field's value */
+    int priority;           /* 2 for the whole key, 1 for a dotted path */
+} ProjectionTarget;
+
+/* Structure holding one field name of the compiled keys */
+typedef struct ProjectionNode {
+    char *name;             /* Field name, unescaped */
+    size_t name_length;     /* Length of name in bytes */
+    ProjectionTarget *targets; /* Columns showing the value of this field */
+    int target_count;       /* Number of targets */
+    struct ProjectionNode *children; /* Fields looked up when the value is an object */
+    int child_count;        /* Number of children */
+} ProjectionNode;
+
+/* Structure holding the compiled column keys of a layout */
+typedef struct Projection {
+    ProjectionNode root;    /* Unnamed node whose children are the fields of a row object */
+    int column_count;       /* Number of columns filled in by a row */
+} Projection;
+
+/* Function prototypes */
+int projection_compile(TableConfig *config);
+void projection_free(TableConfig *config);
+int project_row_values(const Projection *projection, const char *text, size_t length, DataRow *row);
+
+#endif /* TABLES_PROJECTION_H */
@@ -0,0 +1,253 @@
+/*
+ * tables_reader.c - Implementation of incremental reading of JSON data arrays
+ * Splits a top-level JSON array into its elements without parsing the whole document,
+ * so that rows can be parsed and rendered one at a time. NDJSON data, one value per line,
+ * is split the same way with the values taken as the elements.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jansson.h>
+#include "tables_reader.h"
+
+static DataFormat data_format = DATA_FORMAT_AUTO;
+
+/*
+ * Set the format of the data from the name given to --format, returning 1 if it is unknown
+ */
+int data_format_set(const char *name) {
+    if (name && strcmp(name, "json") == 0) {
+        data_format = DATA_FORMAT_JSON;
+    } else if (name && strcmp(name, "ndjson") == 0) {
+        data_format = DATA_FORMAT_NDJSON;
+    } else if (name && strcmp(name, "auto") == 0) {
+        data_format = DATA_FORMAT_AUTO;
+    } else {
+        fprintf(stderr, "Error: --format needs json, ndjson or auto\n");
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Helper function to decide the format from the first significant byte of the data
+ */
+static int first_byte_is_ndjson(int c) {
+    if (data_format == DATA_FORMAT_AUTO) return c == '{';
+    return data_format == DATA_FORMAT_NDJSON;
+}
+
+/*
+ * Return 1 if data held in memory is NDJSON rather than a JSON array
+ */
+int data_format_is_ndjson(const char *data, size_t size) {
+    size_t i = 0;
+    while (i < size && (data[i] == ' ' || data[i] == '\t' || data[i] == '\n' || data[i] == '\r')) i++;
+    return first_byte_is_ndjson(i < size ? (unsigned char)data[i] : EOF);
+}
+
+/*
+ * Initialize a reader that pulls elements from an open stream
+ */
+void json_array_reader_init_file(JsonArrayReader *reader, FILE *fp) {
+    memset(reader, 0, sizeof(JsonArrayReader));
+    reader->fp = fp;
+    reader->line = 1;
+}
+
+/*
+ * Initialize a reader over an in-memory buffer (for example a memory-mapped file)
+ * Elements are returned as slices of the buffer without copying
+ */
+void json_array_reader_init_buffer(JsonArrayReader *reader, const char *data, size_t size) {
+    memset(reader, 0, sizeof(JsonArrayReader));
+    reader->data = data;
+    reader->size = size;
+    reader->line = 1;
+}
+
+/*
+ * Restart an in-memory reader from the beginning of its buffer
+ */
+void json_array_reader_rewind(JsonArrayReader *reader) {
+    if (reader->fp) return; // Streams cannot be re-read
+    reader->pos = 0;
+    reader->started = 0;
+    reader->finished = 0;
+    reader->lines = 0;
+    reader->line = 1;
+}
+
+/*
+ * Helper function to fetch the next byte from the source
+ */
+static int reader_getc(JsonArrayReader *reader) {
+    int c;
+    if (reader->fp) {
+        c = getc(reader->fp);
+    } else {
+        c = (reader->pos < reader->size) ? (unsigned char)reader->data[reader->pos++] : EOF;
+    }
+    if (c == '\n') reader->line++;
+    return c;
+}
+
+/*
+ * Helper function to push back the last byte fetched from the source
+ */
+static void reader_ungetc(JsonArrayReader *reader, int c) {
+    if (c == EOF) return;
+    if (c == '\n') reader->line--;
+    if (reader->fp) {
+        ungetc(c, reader->fp);
+    } else {
+        reader->pos--;
+    }
+}
+
+/*
+ * Helper function to append a byte to the element buffer (stream sources only)
+ */
+static int reader_append(JsonArrayReader *reader, int c) {
+    if (reader->fp == NULL) return 0;
+    if (reader->buffer_len + 1 >= reader->buffer_cap) {
+        size_t new_cap = reader->buffer_cap ? reader->buffer_cap * 2 : 4096;
+        char *new_buffer = realloc(reader->buffer, new_cap);
+        if (new_buffer == NULL) {
+            fprintf(stderr, "Error: Memory reallocation failed for element buffer\n");
+            return 1;
+        }
+        reader->buffer = new_buffer;
+        reader->buffer_cap = new_cap;
+    }
+    reader->buffer[reader->buffer_len++] = (char)c;
+    return 0;
+}
+
+/*
+ * Helper function to skip whitespace and return the next significant byte
+ */
+static int reader_skip_whitespace(JsonArrayReader *reader) {
+    int c;
+    do {
+        c = reader_getc(reader);
+    } while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+    return c;
+}
+
+/*
+ * Return the raw text of the next array element
+ * Returns 1 when an element is available, 0 at the end of the array and -1 on error
+ * The returned pointer stays valid until the next call on the same reader
+ */
+int json_array_reader_next_raw(JsonArrayReader *reader, const char **element, size_t *length) {
+    if (reader->finished) return 0;
+
+    int c = reader_skip_whitespace(reader);
+    if (!reader->started) {
+        if (first_byte_is_ndjson(c)) {
+            reader->lines = 1;
+        } else if (c != '[') {
+            if (!reader->quiet) fprintf(stderr, "Error: Data JSON root must be an array\n");
+            return -1;
+        }
+        reader->started = 1;
+        if (!reader->lines) {
+            c = reader_skip_whitespace(reader);
+            if (c == ']') {
+                reader->finished = 1;
+                return 0;
+            }
+        }
+    }
+    if (c == EOF && reader->lines) {
+        reader->finished = 1;
+        return 0;
+    }
+    if (c == EOF) {
+        if (!reader->quiet) fprintf(stderr, "Error: Unexpected end of data at line %ld\n", reader->line);
+        return -1;
+    }
+
+    size_t start = reader->fp ? 0 : reader->pos - 1;
+    reader->buffer_len = 0;
+    if (reader_append(reader, c) != 0) return -1;
+
+    if (c == '{' || c == '[' || c == '"') {
+        // Track nesting and string state until the element closes
+        int depth = (c == '"') ? 0 : 1;
+        int in_string = (c == '"');
+        int escape = 0;
+        while (depth > 0 || in_string) {
+            c = reader_getc(reader);
+            if (c == EOF) {
+                if (!reader->quiet) fprintf(stderr, "Error: Unexpected end of data inside element at line %ld\n", reader->line);
+                return -1;
+            }
+            if (reader_append(reader, c) != 0) return -1;
+            if (in_string) {
+                if (escape) {
+                    escape = 0;
+                } else if (c == '\\') {
+                    escape = 1;
+                } else if (c == '"') {
+                    in_string = 0;
+                }
+            } else if (c == '"') {
+                in_string = 1;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                depth--;
+            }
+        }
+    } else {
+        // Bare scalar (number, true, false, null) runs until a delimiter
+        while (1) {
+            c = reader_getc(reader);
+            if (c == EOF || c == ',' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                reader_ungetc(reader, c);
+                break;
+            }
+            if (reader_append(reader, c) != 0) return -1;
+        }
+    }
+
+    if (reader->fp) {
+        if (reader_append(reader, '\0') != 0) return -1;
+        reader->buffer_len--;
+        *element = reader->buffer;
+        *length = reader->buffer_len;
+    } else {
+        *element = reader->data + start;
+        *length = reader->pos - start;
+    }
+
+    // NDJSON values are only separated by line breaks, which the next call skips
+    if (reader->lines) {
+        return 1;
+    }
+
+    // Consume the separator that follows the element
+    c = reader_skip_whitespace(reader);
+    if (c == ']') {
+        reader->finished = 1;
+    } else if (c != ',') {
+        if (!reader->quiet) fprintf(stderr, "Error: Expected ',' or ']' after array element at line %ld\n", reader->line);
+        return -1;
+    }
+    return 1;
+}
+
+/*
+ * Free memory held by the reader (the underlying stream or buffer is not closed)
+ */
+void json_array_reader_free(JsonArrayReader *reader) {
+    if (reader->buffer) {
+        free(reader->buffer);
+        reader->buffer = NULL;
+    }
+    reader->buffer_len = 0;
+    reader->buffer_cap = 0;
+}
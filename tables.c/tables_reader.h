@@ -0,0 +1,44 @@
+/*
+ * tables_reader.h - Header file for incremental reading of JSON data arrays
+ * Defines the reader used to pull one row object at a time out of a top-level JSON array.
+ */
+
+#ifndef TABLES_READER_H
+#define TABLES_READER_H
+
+#include <stdio.h>
+#include <jansson.h>
+
+/* Layout of the data, set with --format */
+typedef enum {
+    DATA_FORMAT_AUTO,       /* NDJSON when the data starts with an object, otherwise a JSON array */
+    DATA_FORMAT_JSON,       /* A JSON array of row objects */
+    DATA_FORMAT_NDJSON      /* One row object per line (JSON Lines) */
+} DataFormat;
+
+/* Structure holding the state of an incremental JSON array reader */
+typedef struct {
+    FILE *fp;               /* Source stream, NULL when reading from memory */
+    const char *data;       /* In-memory source, NULL when reading from a stream */
+    size_t size;            /* Size of the in-memory source */
+    size_t pos;             /* Current read offset within the in-memory source */
+    char *buffer;           /* Buffer holding the current element when reading from a stream */
+    size_t buffer_len;      /* Number of bytes used in buffer */
+    size_t buffer_cap;      /* Allocated size of buffer */
+    int started;            /* Flag set once the opening '[' has been consumed */
+    int finished;           /* Flag set once the closing ']' has been consumed */
+    int lines;              /* Flag set when the source holds one value per line instead of an array */
+    int quiet;              /* Flag set to leave reporting errors in the data to the caller */
+    long line;              /* Current line number, used for error messages */
+} JsonArrayReader;
+
+/* Function prototypes */
+int data_format_set(const char *name);
+int data_format_is_ndjson(const char *data, size_t size);
+void json_array_reader_init_file(JsonArrayReader *reader, FILE *fp);
+void json_array_reader_init_buffer(JsonArrayReader *reader, const char *data, size_t size);
+void json_array_reader_rewind(JsonArrayReader *reader);
+int json_array_reader_next_raw(JsonArrayReader *reader, const char **element, size_t *length);
+void json_array_reader_free(JsonArrayReader *reader);
+
+#endif /* TABLES_READER_H */
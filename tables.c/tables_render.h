@@ -15,6 +15,7 @@
 #include "tables_render_rows.h"
 #include "tables_render_summaries.h"
 #include "tables_render_footer.h"
+#include "tables_render_stream.h"
 
 // Main rendering function
 void render_table(TableConfig *config, TableData *data);
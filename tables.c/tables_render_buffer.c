@@ -0,0 +1,269 @@
+/*
+ * tables_render_buffer.c - Implementation of the buffered output writer used by table rendering
+ * Theme glyphs and text are copied into a single buffer that is written to stdout with write()
+ * when it fills up and when the table is complete. Horizontal rules are cut from a precomputed
+ * run of the rule glyph instead of being printed one glyph at a time.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include "tables_render_buffer.h"
+#include "tables_profile.h"
+
+static char *output_buffer = NULL;
+static size_t output_capacity = OUTPUT_BUFFER_SIZE;
+static size_t output_length = 0;
+static int output_fd = STDOUT_FILENO; /* Descriptor the buffer is written to */
+static OutputWriter output_writer = NULL; /* Function the buffer is passed to instead, NULL for output_fd */
+static void *output_writer_context = NULL;
+
+static int capturing = 0;           /* Writes go to capture_text instead of stdout */
+static int capture_failed = 0;
+static char *capture_text = NULL;
+static size_t capture_capacity = 0;
+static size_t capture_length = 0;
+
+static char *rule_text = NULL;      /* Glyph repeated rule_count times */
+static char *rule_glyph = NULL;     /* Glyph rule_text was built from */
+static int rule_count = 0;
+
+/*
+ * Set the size of the output buffer, returning 1 if the size is not usable
+ * Takes effect for the next table, pending output is flushed first
+ */
+int output_set_buffer_size(size_t size) {
+    if (size == 0) {
+        fprintf(stderr, "Error: Output buffer size must be at least 1 byte\n");
+        return 1;
+    }
+    output_finish();
+    output_capacity = size;
+    return 0;
+}
+
+/*
+ * Send the output of the following tables to fd instead of stdout, pending output is flushed first
+ */
+void output_set_fd(int fd) {
+    output_finish();
+    output_fd = fd;
+    output_writer = NULL;
+    output_writer_context = NULL;
+}
+
+/*
+ * Pass the output of the following tables to writer instead of a descriptor, NULL going back to stdout
+ * Pending output is flushed first
+ */
+void output_set_writer(OutputWriter writer, void *context) {
+    output_finish();
+    output_fd = STDOUT_FILENO;
+    output_writer = writer;
+    output_writer_context = context;
+}
+
+/*
+ * Pass the buffered output to the writer, or to write() retrying short writes
+ */
+void output_flush(void) {
+    size_t offset = 0;
+    ProfilePhase previous = profile_switch(PROFILE_OUTPUT);
+    fflush(stdout); // Keep anything printed through stdio in order
+    if (output_writer && output_length > 0) {
+        output_writer(output_writer_context, output_buffer, output_length);
+        offset = output_length;
+    }
+    while (offset < output_length) {
+        ssize_t written = write(output_fd, output_buffer + offset, output_length - offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            break; // Output closed, nothing more can be written
+        }
+        offset += (size_t)written;
+    }
+    profile_add(PROFILE_BYTES_WRITTEN, (long)offset);
+    profile_switch(previous);
+    output_length = 0;
+}
+
+/*
+ * Append bytes to the output buffer, flushing it when full
+ */
+void output_write(const char *data, size_t length) {
+    if (capturing) {
+        if (capture_failed) return;
+        if (capture_length + length + 1 > capture_capacity) {
+            size_t new_capacity = capture_capacity ? capture_capacity * 2 : 256;
+            while (capture_length + length + 1 > new_capacity) new_capacity *= 2;
+            char *new_text = realloc(capture_text, new_capacity);
+            if (new_text == NULL) {
+                capture_failed = 1;
+                return;
+            }
+            capture_text = new_text;
+            capture_capacity = new_capacity;
+        }
+        memcpy(capture_text + capture_length, data, length);
+        capture_length += length;
+        return;
+    }
+    if (output_buffer == NULL) {
+        output_buffer = malloc(output_capacity);
+        if (output_buffer == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for output buffer\n");
+            fwrite(data, 1, length, stdout);
+            return;
+        }
+    }
+    while (length > 0) {
+        if (output_length == output_capacity) output_flush();
+        size_t chunk = output_capacity - output_length;
+        if (chunk > length) chunk = length;
+        memcpy(output_buffer + output_length, data, chunk);
+        output_length += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+/*
+ * Start collecting output in memory instead of writing it to stdout
+ * Used to render lines that are printed many times, such as borders, only once
+ */
+void output_capture_begin(void) {
+    capturing = 1;
+    capture_failed = 0;
+    capture_text = NULL;
+    capture_capacity = 0;
+    capture_length = 0;
+}
+
+/*
+ * Stop collecting output and return what was written since output_capture_begin()
+ * The text is NUL terminated and owned by the caller, NULL is returned if memory ran out
+ */
+char *output_capture_end(size_t *length) {
+    capturing = 0;
+    if (capture_failed || capture_text == NULL) {
+        if (capture_failed) fprintf(stderr, "Error: Memory allocation failed for captured output\n");
+        free(capture_text);
+        capture_text = NULL;
+        *length = 0;
+        return NULL;
+    }
+    capture_text[capture_length] = '\0';
+    char *text = capture_text;
+    *length = capture_length;
+    capture_text = NULL;
+    return text;
+}
+
+/*
+ * Append a string to the output buffer
+ */
+void output_puts(const char *text) {
+    if (text) output_write(text, strlen(text));
+}
+
+/*
+ * Append formatted text to the output buffer
+ */
+void output_printf(const char *format, ...) {
+    char stack_text[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(stack_text, sizeof(stack_text), format, args);
+    va_end(args);
+    if (length < 0) return;
+    if ((size_t)length < sizeof(stack_text)) {
+        output_write(stack_text, (size_t)length);
+        return;
+    }
+
+    char *text = malloc((size_t)length + 1);
+    if (text == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for formatted output\n");
+        return;
+    }
+    va_start(args, format);
+    vsnprintf(text, (size_t)length + 1, format, args);
+    va_end(args);
+    output_write(text, (size_t)length);
+    free(text);
+}
+
+/*
+ * Append padding spaces, matching printf("%*s", count, "") which also pads for negative counts
+ */
+void output_spaces(int count) {
+    static const char spaces[] = "                                                                ";
+    if (count < 0) count = -count;
+    while (count > 0) {
+        int chunk = count < (int)(sizeof(spaces) - 1) ? count : (int)(sizeof(spaces) - 1);
+        output_write(spaces, (size_t)chunk);
+        count -= chunk;
+    }
+}
+
+/*
+ * Append a horizontal rule of count glyphs
+ * The glyph is repeated once into a run that is reused for every rule of that glyph, while a
+ * single-byte glyph, as in ASCII themes, is set directly in the output buffer
+ */
+void output_rule(const char *glyph, int count) {
+    if (glyph == NULL || count <= 0) return;
+    size_t glyph_length = strlen(glyph);
+    if (glyph_length == 0) return;
+
+    if (glyph_length == 1 && !capturing && output_buffer != NULL) {
+        while (count > 0) {
+            if (output_length == output_capacity) output_flush();
+            size_t chunk = output_capacity - output_length;
+            if (chunk > (size_t)count) chunk = (size_t)count;
+            memset(output_buffer + output_length, glyph[0], chunk);
+            output_length += chunk;
+            count -= (int)chunk;
+        }
+        return;
+    }
+
+    if (rule_glyph == NULL || strcmp(rule_glyph, glyph) != 0 || count > rule_count) {
+        int new_count = count > 256 ? count : 256;
+        char *new_text = malloc(glyph_length * new_count);
+        char *new_glyph = strdup(glyph);
+        if (new_text == NULL || new_glyph == NULL) {
+            free(new_text);
+            free(new_glyph);
+            for (int i = 0; i < count; i++) output_write(glyph, glyph_length);
+            return;
+        }
+        for (int i = 0; i < new_count; i++) {
+            memcpy(new_text + i * glyph_length, glyph, glyph_length);
+        }
+        free(rule_text);
+        free(rule_glyph);
+        rule_text = new_text;
+        rule_glyph = new_glyph;
+        rule_count = new_count;
+    }
+    output_write(rule_text, glyph_length * count);
+}
+
+/*
+ * Write out everything buffered so far and release the buffer, called once a table is complete
+ */
+void output_finish(void) {
+    if (output_buffer == NULL) return;
+    output_flush();
+    free(output_buffer);
+    output_buffer = NULL;
+    free(rule_text);
+    free(rule_glyph);
+    rule_text = NULL;
+    rule_glyph = NULL;
+    rule_count = 0;
+}
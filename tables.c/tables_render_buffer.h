@@ -0,0 +1,32 @@
+/*
+ * tables_render_buffer.h - Header file for the buffered output writer used by table rendering
+ * All render_* functions write into one buffer that is passed to write() when it fills up
+ * and once the table is complete, instead of printing each glyph with printf.
+ */
+
+#ifndef TABLES_RENDER_BUFFER_H
+#define TABLES_RENDER_BUFFER_H
+
+#include <stddef.h>
+
+/* Default size of the output buffer, can be changed with --buffer_size */
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/* Receives each block of buffered output instead of a descriptor, see output_set_writer() */
+typedef void (*OutputWriter)(void *context, const char *data, size_t length);
+
+/* Function prototypes */
+int output_set_buffer_size(size_t size);
+void output_set_fd(int fd);
+void output_set_writer(OutputWriter writer, void *context);
+void output_write(const char *data, size_t length);
+void output_puts(const char *text);
+void output_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void output_spaces(int count);
+void output_rule(const char *glyph, int count);
+void output_flush(void);
+void output_capture_begin(void);
+char *output_capture_end(size_t *length);
+void output_finish(void);
+
+#endif /* TABLES_RENDER_BUFFER_H */
@@ -6,11 +6,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tables_render_footer.h"
+#include "tables_render_buffer.h"
+#include "tables_arena.h"
 #include "tables_render_utils.h"
 #include "tables_render_layout.h"
 
 void render_bottom_border_with_footer(TableConfig *config, int total_width, int footer_present, int footer_padding, int box_width) {
-    printf("%s", config->theme.border_color);
+    output_puts(config->theme.border_color);
     int *column_positions = malloc((config->column_count - 1) * sizeof(int));
     int col_pos_count = 0;
     if (column_positions) {
@@ -49,29 +51,29 @@ void render_bottom_border_with_footer(TableConfig *config, int total_width, int
             }
 
             if (i == 0) {
-                printf("%s", (footer_start == 0) ? config->theme.l_junct : config->theme.bl_corner);
+                output_puts((footer_start == 0) ? config->theme.l_junct : config->theme.bl_corner);
             } else if (i == max_width - 1) {
                 if (footer_end > total_width - 1) {
-                    printf("%s", config->theme.tr_corner);  // Footer extends beyond table
+                    output_puts(config->theme.tr_corner);  // Footer extends beyond table
                 } else if (footer_end == total_width - 1) {
-                    printf("%s", config->theme.r_junct);    // Footer ends exactly at table edge
+                    output_puts(config->theme.r_junct);    // Footer ends exactly at table edge
                 } else {
-                    printf("%s", config->theme.br_corner);  // Normal bottom-right corner
+                    output_puts(config->theme.br_corner);  // Normal bottom-right corner
                 }
             } else if (i == total_width - 1 && footer_end > total_width - 1) {
-                printf("%s", config->theme.b_junct);  // Junction at table edge when footer extends beyond
+                output_puts(config->theme.b_junct);  // Junction at table edge when footer extends beyond
             } else if (i == footer_start) {
-                printf("%s", is_col_junct ? config->theme.cross : config->theme.t_junct);
+                output_puts(is_col_junct ? config->theme.cross : config->theme.t_junct);
             } else if (i == footer_end) {
-                printf("%s", is_col_junct ? config->theme.cross : config->theme.t_junct);
+                output_puts(is_col_junct ? config->theme.cross : config->theme.t_junct);
             } else if (i > footer_start && i < footer_end) {
-                printf("%s", is_col_junct ? config->theme.b_junct : config->theme.h_line);
+                output_puts(is_col_junct ? config->theme.b_junct : config->theme.h_line);
             } else {
-                printf("%s", is_col_junct ? config->theme.b_junct : config->theme.h_line);
+                output_puts(is_col_junct ? config->theme.b_junct : config->theme.h_line);
             }
         }
     } else {
-        printf("%s", config->theme.bl_corner);
+        output_puts(config->theme.bl_corner);
         for (int i = 1; i < total_width - 1; i++) {
             int is_col_junct = 0;
             if (column_positions) {
@@ -82,15 +84,15 @@ void render_bottom_border_with_footer(TableConfig *config, int total_width, int
                     }
                 }
             }
-            printf("%s", is_col_junct ? config->theme.b_junct : config->theme.h_line);
+            output_puts(is_col_junct ? config->theme.b_junct : config->theme.h_line);
         }
-        printf("%s", config->theme.br_corner);
+        output_puts(config->theme.br_corner);
     }
 
     if (column_positions) {
         free(column_positions);
     }
-    printf("%s\n", config->theme.text_color);
+    output_printf("%s\n", config->theme.text_color);
 }
 
 
@@ -104,7 +106,7 @@ void render_footer(TableConfig *config, int total_width) {
     char *evaluated_footer = evaluate_dynamic_string(config->footer);
     if (evaluated_footer == NULL) {
         fprintf(stderr, "Error: Failed to evaluate dynamic footer string\n");
-        evaluated_footer = strdup(config->footer ? config->footer : "");
+        evaluated_footer = arena_strdup(config->footer ? config->footer : "");
         if (evaluated_footer == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for footer string\n");
             return;
@@ -114,21 +116,19 @@ void render_footer(TableConfig *config, int total_width) {
     char *processed_footer = replace_color_placeholders(evaluated_footer);
     if (processed_footer == NULL) {
         fprintf(stderr, "Error: Failed to process color placeholders in footer\n");
-        processed_footer = strdup(evaluated_footer);
+        processed_footer = arena_strdup(evaluated_footer);
         if (processed_footer == NULL) {
             fprintf(stderr, "Error: Memory allocation failed for processed footer string\n");
-            free(evaluated_footer);
             return;
         }
     }
-    free(evaluated_footer);
 
     char *display_footer = processed_footer;
     int footer_width = get_display_width(display_footer);
     int box_width = footer_width + 4;
 
-    extern int debug_mode;
-    if (debug_mode) {
+    extern int tables_debug_mode;
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug Footer: Original footer text: '%s'\n", config->footer ? config->footer : "NULL");
         fprintf(stderr, "Debug Footer: Processed footer text: '%s'\n", display_footer);
         fprintf(stderr, "Debug Footer: Footer display width: %d\n", footer_width);
@@ -144,16 +144,13 @@ void render_footer(TableConfig *config, int total_width) {
         max_footer_width = total_width > 4 ? total_width - 4 : 0;
     }
 
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug Footer: Max footer width: %d\n", max_footer_width);
     }
 
     if (box_width > total_width && config->footer_pos != POSITION_NONE) {
         char *clipped_footer = clip_text(display_footer, max_footer_width, config->footer_pos);
         if (clipped_footer) {
-            if (display_footer != processed_footer) {
-                free(display_footer);
-            }
             display_footer = clipped_footer;
         }
     }
@@ -177,7 +174,7 @@ void render_footer(TableConfig *config, int total_width) {
         footer_padding = total_width - box_width;
     }
 
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug Footer: Final footer width: %d\n", footer_width);
         fprintf(stderr, "Debug Footer: Final box width: %d\n", box_width);
         fprintf(stderr, "Debug Footer: Footer padding: %d\n", footer_padding);
@@ -188,7 +185,7 @@ void render_footer(TableConfig *config, int total_width) {
     render_bottom_border_with_footer(config, total_width, footer_present, footer_padding, box_width);
 
     // Footer text
-    printf("%s%*s%s", config->theme.border_color, footer_padding, "", config->theme.v_line);
+    output_printf("%s%*s%s", config->theme.border_color, footer_padding, "", config->theme.v_line);
     int available_width = box_width - 2;
     char *clipped_text = clip_text(display_footer, available_width, config->footer_pos);
     
@@ -202,7 +199,6 @@ void render_footer(TableConfig *config, int total_width) {
         int effective_text_width = available_width - 2; // Reserve space for padding
         if (text_width > effective_text_width) {
             // Need to re-clip the text to leave room for padding
-            free(clipped_text);
             clipped_text = clip_text_to_width(display_footer, effective_text_width);
             text_width = get_display_width(clipped_text);
         }
@@ -211,19 +207,12 @@ void render_footer(TableConfig *config, int total_width) {
         right_padding = available_width - text_width - left_padding;
     }
 
-    printf("%*s%s%s%s%*s%s%s\n", left_padding, "", config->theme.footer_color, clipped_text, config->theme.text_color, right_padding, "", config->theme.border_color, config->theme.v_line);
+    output_printf("%*s%s%s%s%*s%s%s\n", left_padding, "", config->theme.footer_color, clipped_text, config->theme.text_color, right_padding, "", config->theme.border_color, config->theme.v_line);
     
-    free(clipped_text);
 
     // Bottom border of footer box
-    printf("%s%*s%s", config->theme.border_color, footer_padding, "", config->theme.bl_corner);
-    for (int i = 0; i < box_width - 2; i++) {
-        printf("%s", config->theme.h_line);
-    }
-    printf("%s%s\n", config->theme.br_corner, config->theme.text_color);
+    output_printf("%s%*s%s", config->theme.border_color, footer_padding, "", config->theme.bl_corner);
+    output_rule(config->theme.h_line, box_width - 2);
+    output_printf("%s%s\n", config->theme.br_corner, config->theme.text_color);
 
-    if (display_footer != processed_footer) {
-        free(display_footer);
-    }
-    free(processed_footer);
 }
@@ -6,13 +6,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tables_render_headers.h"
+#include "tables_render_buffer.h"
+#include "tables_arena.h"
 #include "tables_render_utils.h"
 
 /*
  * Render the table headers with proper alignment and padding
  */
 void render_headers(TableConfig *config) {
-    printf("%s%s", config->theme.border_color, config->theme.v_line);
+    output_printf("%s%s", config->theme.border_color, config->theme.v_line);
     for (int j = 0; j < config->column_count; j++) {
         if (!config->columns[j].visible) continue;
         ColumnConfig *col = &config->columns[j];
@@ -21,7 +23,7 @@ void render_headers(TableConfig *config) {
         int max_header_width = col->width - 2; // Account for minimum 1 space padding on each side
         char *display_header = header;
         if (header_width > max_header_width && max_header_width > 0) {
-            display_header = malloc(max_header_width + 1);
+            display_header = arena_alloc(max_header_width + 1);
             if (display_header) {
                 if (col->justify == JUSTIFY_RIGHT) {
                     // For right alignment, clip from the left
@@ -54,30 +56,30 @@ void render_headers(TableConfig *config) {
                 padding_right += remaining_padding;
             }
         }
-        printf("%s%*s%s%*s", config->theme.caption_color, padding_left, "", display_header, padding_right, "");
-        if (display_header != header) {
-            free(display_header);
-        }
-        free(header);
-        printf("%s%s", config->theme.border_color, config->theme.v_line);
+        output_printf("%s%*s%s%*s", config->theme.caption_color, padding_left, "", display_header, padding_right, "");
+        output_printf("%s%s", config->theme.border_color, config->theme.v_line);
     }
-    printf("%s\n", config->theme.text_color);
+    output_printf("%s\n", config->theme.text_color);
 }
 
 /*
  * Render the separator line below the headers
+ * The same line separates break groups and the summaries row, so once it has been
+ * built by build_table_borders() it is written as a single string
  */
 void render_header_separator(TableConfig *config) {
-    printf("%s", config->theme.border_color);
-    printf("%s", config->theme.l_junct);
+    if (config->separator.text) {
+        output_write(config->separator.text, config->separator.length);
+        return;
+    }
+    output_puts(config->theme.border_color);
+    output_puts(config->theme.l_junct);
     for (int j = 0; j < config->column_count; j++) {
         if (!config->columns[j].visible) continue;
-        for (int w = 0; w < config->columns[j].width; w++) {
-            printf("%s", config->theme.h_line);
-        }
+        output_rule(config->theme.h_line, config->columns[j].width);
         if (j < config->column_count - 1) {
-            printf("%s", config->theme.cross);
+            output_puts(config->theme.cross);
         }
     }
-    printf("%s%s\n", config->theme.r_junct, config->theme.text_color);
+    output_printf("%s%s\n", config->theme.r_junct, config->theme.text_color);
 }
@@ -13,7 +13,7 @@
 void render_headers(TableConfig *config);
 
 /*
- * Render the separator line below the headers
+ * Render the separator line below the headers, also used at breaks and above the summaries
  */
 void render_header_separator(TableConfig *config);
 
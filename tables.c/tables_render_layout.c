@@ -7,13 +7,217 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tables_render_layout.h"
+#include "tables_arena.h"
 #include "tables_datatypes.h"
 #include "tables_render_utils.h"
+#include "tables_parallel.h"
+#include "tables_page.h"
+
+/*
+ * Calculate the display width of a column's summary or subtotal value, or 0 if it has none
+ */
+static int summary_display_width(ColumnConfig *col, SummaryType type, SummaryStats *stats) {
+    if (type == SUMMARY_NONE) return 0;
+
+    ArenaMark mark = arena_mark();
+    char summary_text[256];
+    switch (type) {
+        case SUMMARY_SUM:
+            if (col->data_type == DATA_KCPU) {
+                snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
+                char *formatted = format_with_commas(summary_text);
+                snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
+            } else if (col->data_type == DATA_KMEM) {
+                snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
+                char *formatted = format_with_commas(summary_text);
+                snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
+            } else if (col->data_type == DATA_FLOAT) {
+                char format[16];
+                snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
+                snprintf(summary_text, sizeof(summary_text), format, stats->sum);
+                char *formatted = format_with_commas(summary_text);
+                strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                summary_text[sizeof(summary_text) - 1] = '\0';
+            } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
+                snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
+                char *formatted = format_with_commas(summary_text);
+                strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                summary_text[sizeof(summary_text) - 1] = '\0';
+            } else {
+                snprintf(summary_text, sizeof(summary_text), "%.2f", stats->sum);
+                char *formatted = format_with_commas(summary_text);
+                strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                summary_text[sizeof(summary_text) - 1] = '\0';
+            }
+            break;
+        case SUMMARY_MIN:
+            if (stats->count > 0) {
+                if (col->data_type == DATA_KCPU) {
+                    snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
+                    char *formatted = format_with_commas(summary_text);
+                    snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
+                } else if (col->data_type == DATA_KMEM) {
+                    snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
+                    char *formatted = format_with_commas(summary_text);
+                    snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
+                } else if (col->data_type == DATA_FLOAT) {
+                    char format[16];
+                    snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
+                    snprintf(summary_text, sizeof(summary_text), format, stats->min);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
+                    snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                } else {
+                    snprintf(summary_text, sizeof(summary_text), "%.2f", stats->min);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                }
+            } else {
+                summary_text[0] = '\0';
+            }
+            break;
+        case SUMMARY_MAX:
+            if (stats->count > 0) {
+                if (col->data_type == DATA_KCPU) {
+                    snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
+                    char *formatted = format_with_commas(summary_text);
+                    snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
+                } else if (col->data_type == DATA_KMEM) {
+                    snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
+                    char *formatted = format_with_commas(summary_text);
+                    snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
+                } else if (col->data_type == DATA_FLOAT) {
+                    char format[16];
+                    snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
+                    snprintf(summary_text, sizeof(summary_text), format, stats->max);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
+                    snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                } else {
+                    snprintf(summary_text, sizeof(summary_text), "%.2f", stats->max);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                }
+            } else {
+                summary_text[0] = '\0';
+            }
+            break;
+        case SUMMARY_AVG:
+            if (stats->avg_count > 0) {
+                double avg_result = stats->avg_sum / stats->avg_count;
+                if (col->data_type == DATA_FLOAT) {
+                    char format[16];
+                    snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
+                    snprintf(summary_text, sizeof(summary_text), format, avg_result);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
+                    snprintf(summary_text, sizeof(summary_text), "%.0f", avg_result);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                } else {
+                    snprintf(summary_text, sizeof(summary_text), "%.2f", avg_result);
+                    char *formatted = format_with_commas(summary_text);
+                    strncpy(summary_text, formatted, sizeof(summary_text) - 1);
+                    summary_text[sizeof(summary_text) - 1] = '\0';
+                }
+            } else {
+                snprintf(summary_text, sizeof(summary_text), "N/A");
+            }
+            break;
+        case SUMMARY_COUNT:
+            snprintf(summary_text, sizeof(summary_text), "%d", stats->count);
+            break;
+        case SUMMARY_UNIQUE:
+            snprintf(summary_text, sizeof(summary_text), "%d", stats->unique_count);
+            break;
+        case SUMMARY_UNIQUE_APPROX:
+            snprintf(summary_text, sizeof(summary_text), "~%d", estimate_unique_count(stats));
+            break;
+        default:
+            summary_text[0] = '\0';
+    }
+    arena_reset(mark);
+    return get_display_width(summary_text);
+}
+
+/* Structure shared by the threads measuring blocks of rows */
+typedef struct {
+    TableConfig *config;
+    TableData *data;
+    int *block_widths;      /* Widest formatted value of each column, column_count per block */
+} WidthBlockContext;
+
+/*
+ * Helper function to format and measure the columns without a configured width for one block of rows
+ */
+static void measure_row_block(void *context, int block, int start, int end) {
+    WidthBlockContext *ctx = context;
+    TableConfig *config = ctx->config;
+    TableData *data = ctx->data;
+    int *max_widths = &ctx->block_widths[block * config->column_count];
+
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        if (col->width_specified) continue; // Width already specified in config
+
+        int max_width = 0;
+        for (int i = start; i < end; i++) {
+            DataRow *row = &data->rows[i];
+            ArenaMark mark = arena_mark();
+            char *formatted = format_classified_value(row->values[j], stored_value_class(data, j, row), stored_number(data, j, row), col->null_val, col->zero_val, col->data_type, col->format, col->string_limit, col->wrap_mode, col->wrap_char, col->justify, data->summaries[j].max_decimal_places);
+            int width = get_display_width(formatted);
+            if (width > max_width) max_width = width;
+            if (data->cells && col->visible && page_row_shown(i)) {
+                FormattedCell *cell = &data->cells[i * config->column_count + j];
+                cell->text = formatted;
+                cell->width = width;
+            } else {
+                arena_reset(mark);
+            }
+        }
+        max_widths[j] = max_width;
+    }
+}
 
 /*
  * Calculate column widths based on content and configuration
+ * Formatted values of visible columns are kept in data->cells so the renderer does not format them again,
+ * for the rows of the page printed when there is one
+ * Blocks of rows are formatted by separate threads, each keeping the widest value of every column
  */
 void calculate_column_widths(TableConfig *config, TableData *data) {
+    if (data->cells == NULL && data->row_count > 0) {
+        data->cells = arena_calloc((size_t)data->row_count * config->column_count, sizeof(FormattedCell));
+    }
+
+    int row_widths[MAX_COLUMNS];
+    int *block_widths = row_widths;
+    int block_count = parallel_block_count(data->row_count);
+    if (block_count > 1) {
+        block_widths = calloc((size_t)block_count * config->column_count, sizeof(int));
+        if (block_widths == NULL) {
+            block_widths = row_widths;
+            block_count = 1;
+        }
+    }
+    WidthBlockContext context = { config, data, block_widths };
+    parallel_run(data->row_count, block_count, measure_row_block, &context);
+
     for (int j = 0; j < config->column_count; j++) {
         ColumnConfig *col = &config->columns[j];
         if (col->width_specified) continue; // Width already specified in config
@@ -25,169 +229,98 @@ void calculate_column_widths(TableConfig *config, TableData *data) {
         }
         
         // Check data rows
-        for (int i = 0; i < data->row_count; i++) {
-            const char *value = data->rows[i].values[j];
-            char *formatted = format_display_value_with_precision(value, col->null_val, col->zero_val, col->data_type, col->format, col->string_limit, col->wrap_mode, col->wrap_char, col->justify, data->summaries[j].max_decimal_places);
-            int width = get_display_width(formatted);
-            if (width > max_width) max_width = width;
-            free(formatted);
+        for (int b = 0; b < block_count; b++) {
+            if (block_widths[b * config->column_count + j] > max_width) max_width = block_widths[b * config->column_count + j];
         }
         
         // Check summary if present
-        if (col->summary != SUMMARY_NONE) {
-            SummaryStats *stats = &data->summaries[j];
-            char summary_text[256];
-            switch (col->summary) {
-                case SUMMARY_SUM:
-                    if (col->data_type == DATA_KCPU) {
-                        snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
-                        char *formatted = format_with_commas(summary_text);
-                        snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
-                        free(formatted);
-                    } else if (col->data_type == DATA_KMEM) {
-                        snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
-                        char *formatted = format_with_commas(summary_text);
-                        snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
-                        free(formatted);
-                    } else if (col->data_type == DATA_FLOAT) {
-                        char format[16];
-                        snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
-                        snprintf(summary_text, sizeof(summary_text), format, stats->sum);
-                        char *formatted = format_with_commas(summary_text);
-                        strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                        summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
-                    } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
-                        snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
-                        char *formatted = format_with_commas(summary_text);
-                        strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                        summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
-                    } else {
-                        snprintf(summary_text, sizeof(summary_text), "%.2f", stats->sum);
-                        char *formatted = format_with_commas(summary_text);
-                        strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                        summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
-                    }
-                    break;
-                case SUMMARY_MIN:
-                    if (stats->count > 0) {
-                        if (col->data_type == DATA_KCPU) {
-                            snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
-                            char *formatted = format_with_commas(summary_text);
-                            snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
-                            free(formatted);
-                        } else if (col->data_type == DATA_KMEM) {
-                            snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
-                            char *formatted = format_with_commas(summary_text);
-                            snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
-                            free(formatted);
-                        } else if (col->data_type == DATA_FLOAT) {
-                            char format[16];
-                            snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
-                            snprintf(summary_text, sizeof(summary_text), format, stats->min);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
-                            snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        } else {
-                            snprintf(summary_text, sizeof(summary_text), "%.2f", stats->min);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        }
-                    } else {
-                        summary_text[0] = '\0';
-                    }
-                    break;
-                case SUMMARY_MAX:
-                    if (stats->count > 0) {
-                        if (col->data_type == DATA_KCPU) {
-                            snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
-                            char *formatted = format_with_commas(summary_text);
-                            snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
-                            free(formatted);
-                        } else if (col->data_type == DATA_KMEM) {
-                            snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
-                            char *formatted = format_with_commas(summary_text);
-                            snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
-                            free(formatted);
-                        } else if (col->data_type == DATA_FLOAT) {
-                            char format[16];
-                            snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
-                            snprintf(summary_text, sizeof(summary_text), format, stats->max);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
-                            snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        } else {
-                            snprintf(summary_text, sizeof(summary_text), "%.2f", stats->max);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        }
-                    } else {
-                        summary_text[0] = '\0';
-                    }
-                    break;
-                case SUMMARY_AVG:
-                    if (stats->avg_count > 0) {
-                        double avg_result = stats->avg_sum / stats->avg_count;
-                        if (col->data_type == DATA_FLOAT) {
-                            char format[16];
-                            snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
-                            snprintf(summary_text, sizeof(summary_text), format, avg_result);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
-                            snprintf(summary_text, sizeof(summary_text), "%.0f", avg_result);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        } else {
-                            snprintf(summary_text, sizeof(summary_text), "%.2f", avg_result);
-                            char *formatted = format_with_commas(summary_text);
-                            strncpy(summary_text, formatted, sizeof(summary_text) - 1);
-                            summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
-                        }
-                    } else {
-                        snprintf(summary_text, sizeof(summary_text), "N/A");
-                    }
-                    break;
-                case SUMMARY_COUNT:
-                    snprintf(summary_text, sizeof(summary_text), "%d", stats->count);
-                    break;
-                case SUMMARY_UNIQUE:
-                    snprintf(summary_text, sizeof(summary_text), "%d", stats->unique_count);
-                    break;
-                default:
-                    summary_text[0] = '\0';
-            }
-            int summary_width = get_display_width(summary_text);
-            if (summary_width > max_width) max_width = summary_width;
+        int summary_width = summary_display_width(col, col->summary, &data->summaries[j]);
+        if (summary_width > max_width) max_width = summary_width;
+        
+        // Check the subtotals of every group
+        for (int g = 0; g < data->group_count; g++) {
+            int subtotal_width = summary_display_width(col, col->subtotal, &data->group_summaries[g * config->column_count + j]);
+            if (subtotal_width > max_width) max_width = subtotal_width;
         }
         
-    col->width = max_width + 2; // Add 1 character padding on each side
+        col->width = max_width + 2; // Add 1 character padding on each side
+    }
+    if (block_widths != row_widths) free(block_widths);
+}
+
+/*
+ * Reset the width trackers for all columns, starting from the header widths
+ */
+void init_column_widths(TableConfig *config, ColumnWidthTracker *trackers) {
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        int header_width = col->header ? get_display_width(col->header) : 0;
+        trackers[j].plain_width = header_width;
+        trackers[j].default_width = 0;
+        trackers[j].integer_width = 0;
+    }
+}
+
+/*
+ * Measure one row against the width trackers without keeping the formatted values
+ * Float columns are padded to the largest precision across all rows, which is not known yet,
+ * so their integer part is tracked separately and the precision is added in finalize_column_widths
+ */
+void measure_row_widths(TableConfig *config, TableData *data, DataRow *row, ColumnWidthTracker *trackers) {
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        if (col->width_specified) continue;
+
+        const char *value = row->values[j];
+        ValueClass value_class = stored_value_class(data, j, row);
+        const double *number = stored_number(data, j, row);
+        ColumnWidthTracker *tracker = &trackers[j];
+        ArenaMark mark = arena_mark();
+        char *formatted = format_classified_value(value, value_class, number, col->null_val, col->zero_val, col->data_type, col->format, col->string_limit, col->wrap_mode, col->wrap_char, col->justify, 0);
+        int width = get_display_width(formatted);
+
+        arena_reset(mark);
+
+        if (col->data_type != DATA_FLOAT || value_class != VALUE_CLASS_FORMATTED) {
+            if (width > tracker->plain_width) tracker->plain_width = width;
+            continue;
+        }
+
+        if (width > tracker->default_width) tracker->default_width = width;
+
+        // Formatting at the value's own precision never rounds its integer part
+        int places = count_decimal_places(value);
+        if (places < 1) places = 1;
+        formatted = format_classified_value(value, value_class, number, col->null_val, col->zero_val, col->data_type, col->format, col->string_limit, col->wrap_mode, col->wrap_char, col->justify, places);
+        int integer_width = get_display_width(formatted) - places - 1;
+        arena_reset(mark);
+        if (integer_width > tracker->integer_width) tracker->integer_width = integer_width;
+    }
 }
+
+/*
+ * Set the widths of columns without a configured width from the trackers and the summaries
+ */
+void finalize_column_widths(TableConfig *config, TableData *data, ColumnWidthTracker *trackers) {
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        if (col->width_specified) continue; // Width already specified in config
+
+        ColumnWidthTracker *tracker = &trackers[j];
+        int decimal_places = data->summaries[j].max_decimal_places;
+        int max_width = tracker->plain_width;
+        int value_width = tracker->default_width;
+        if (col->data_type == DATA_FLOAT && decimal_places > 0 && tracker->default_width > 0) {
+            value_width = tracker->integer_width + 1 + decimal_places;
+        }
+        if (value_width > max_width) max_width = value_width;
+
+        // Check summary if present
+        int summary_width = summary_display_width(col, col->summary, &data->summaries[j]);
+        if (summary_width > max_width) max_width = summary_width;
+
+        col->width = max_width + 2; // Add 1 character padding on each side
+    }
 }
 
 /*
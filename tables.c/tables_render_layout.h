@@ -13,6 +13,29 @@
  */
 void calculate_column_widths(TableConfig *config, TableData *data);
 
+/* Structure tracking the widest formatted value of a column while rows are read one at a time */
+typedef struct {
+    int plain_width;        /* Widest value that does not depend on the float precision */
+    int default_width;      /* Widest formatted value when no decimal places are enforced */
+    int integer_width;      /* Widest integer part (with separators) of float values */
+} ColumnWidthTracker;
+
+/*
+ * Reset the width trackers for all columns, starting from the header widths
+ */
+void init_column_widths(TableConfig *config, ColumnWidthTracker *trackers);
+
+/*
+ * Measure one row against the width trackers without keeping the formatted values
+ */
+void measure_row_widths(TableConfig *config, TableData *data, DataRow *row, ColumnWidthTracker *trackers);
+
+/*
+ * Set the widths of columns without a configured width from the trackers and the summaries
+ * Produces the same widths as calculate_column_widths over the same rows
+ */
+void finalize_column_widths(TableConfig *config, TableData *data, ColumnWidthTracker *trackers);
+
 /*
  * Calculate the total width of the table
  */
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tables_render_output.h"
+#include "tables_render_buffer.h"
+#include "tables_arena.h"
 #include "tables_render_title.h"
 #include "tables_render_headers.h"
 #include "tables_render_rows.h"
@@ -13,18 +15,94 @@
 #include "tables_render_footer.h"
 #include "tables_render_layout.h"
 #include "tables_render_utils.h"
+#include "tables_profile.h"
+
+extern int tables_debug_layout;
 
 /*
  * Main function to render the entire table
  */
-extern int debug_layout;
 void render_table(TableConfig *config, TableData *data) {
     // Calculate column widths based on content
+    ProfilePhase previous = profile_switch(PROFILE_WIDTHS);
     calculate_column_widths(config, data);
+    profile_switch(PROFILE_FORMAT);
     
     // Calculate total width of the table
     int total_width = calculate_total_width(config);
-    if (debug_layout) {
+
+    render_table_start(config, total_width);
+
+    // Render data rows
+    render_rows(config, data);
+
+    render_table_end(config, data, total_width);
+    output_finish();
+    profile_switch(previous);
+}
+
+/*
+ * Build the top border, separator and bottom border once the column widths are known
+ * Separators can be printed thousands of times at breaks, and each is then a single write
+ */
+void build_table_borders(TableConfig *config, int total_width) {
+    // Clear previous lines first so the loops render them rather than the cached text
+    free(config->top_border.text);
+    free(config->separator.text);
+    free(config->bottom_border.text);
+    config->top_border.text = NULL;
+    config->separator.text = NULL;
+    config->bottom_border.text = NULL;
+
+    output_capture_begin();
+    render_top_border_with_title(config, total_width, 0, 0, 0);
+    config->top_border.text = output_capture_end(&config->top_border.length);
+
+    output_capture_begin();
+    render_header_separator(config);
+    config->separator.text = output_capture_end(&config->separator.length);
+
+    output_capture_begin();
+    render_bottom_border(config);
+    config->bottom_border.text = output_capture_end(&config->bottom_border.length);
+}
+
+/*
+ * Render the bottom border used when there is no footer
+ */
+void render_bottom_border(TableConfig *config) {
+    if (config->bottom_border.text) {
+        output_write(config->bottom_border.text, config->bottom_border.length);
+        return;
+    }
+    output_puts(config->theme.border_color);
+    output_puts(config->theme.bl_corner);
+    for (int j = 0; j < config->column_count; j++) {
+        if (!config->columns[j].visible) continue;
+        output_rule(config->theme.h_line, config->columns[j].width);
+        if (j < config->column_count - 1) {
+            int next_col_visible = 0;
+            for (int k = j + 1; k < config->column_count; k++) {
+                if (config->columns[k].visible) {
+                    next_col_visible = 1;
+                    break;
+                }
+            }
+            if (next_col_visible) {
+                output_puts(config->theme.b_junct);
+            }
+        }
+    }
+    output_puts(config->theme.br_corner);
+    output_printf("%s\n", config->theme.text_color);
+}
+
+/*
+ * Render everything above the data rows: title, top border, headers and header separator
+ * Column widths must already be calculated
+ */
+void render_table_start(TableConfig *config, int total_width) {
+    if (tables_debug_layout) {
         fprintf(stderr, "Debug Layout: Total table width = %d\n", total_width);
         fprintf(stderr, "Debug Layout: Column widths:\n");
         int calculated_total = 0;
@@ -56,6 +134,8 @@ void render_table(TableConfig *config, TableData *data) {
         }
         fprintf(stderr, "Debug Layout: Note: Total width from columns = %d (may include inter-column separators in rendering)\n", calculated_total);
     }
+
+    build_table_borders(config, total_width);
     
     // Check if title is present for rendering
     int title_present = (config->title && strlen(config->title) > 0);
@@ -67,14 +147,13 @@ void render_table(TableConfig *config, TableData *data) {
         // Process the title the same way as in render_title() to get accurate width
         char *evaluated_title = evaluate_dynamic_string(config->title);
         if (evaluated_title == NULL) {
-            evaluated_title = strdup(config->title ? config->title : "");
+            evaluated_title = arena_strdup(config->title ? config->title : "");
         }
         
         char *processed_title = replace_color_placeholders(evaluated_title);
         if (processed_title == NULL) {
-            processed_title = strdup(evaluated_title);
+            processed_title = arena_strdup(evaluated_title);
         }
-        free(evaluated_title);
         
         title_width = get_display_width(processed_title);
         box_width = title_width + 4; // Add padding for box borders and internal padding
@@ -104,7 +183,6 @@ void render_table(TableConfig *config, TableData *data) {
             }
         }
         
-        free(processed_title);
     }
 
     // Render title if present
@@ -116,41 +194,19 @@ void render_table(TableConfig *config, TableData *data) {
     // Render headers for visible columns
     render_headers(config);
     render_header_separator(config);
+}
 
-    // Render data rows
-    render_rows(config, data);
-
+/*
+ * Render everything below the data rows: summaries, bottom border and footer
+ */
+void render_table_end(TableConfig *config, TableData *data, int total_width) {
     // Render summaries if any
     render_summaries(config, data);
 
     // Render bottom border if no footer is present
     int footer_present = (config->footer && strlen(config->footer) > 0);
     if (!footer_present) {
-        printf("%s", config->theme.border_color);
-        printf("%s", config->theme.bl_corner);
-        int current_pos = 1;
-        for (int j = 0; j < config->column_count; j++) {
-            if (!config->columns[j].visible) continue;
-            for (int w = 0; w < config->columns[j].width; w++) {
-                printf("%s", config->theme.h_line);
-                current_pos++;
-            }
-            if (j < config->column_count - 1) {
-                int next_col_visible = 0;
-                for (int k = j + 1; k < config->column_count; k++) {
-                    if (config->columns[k].visible) {
-                        next_col_visible = 1;
-                        break;
-                    }
-                }
-                if (next_col_visible) {
-                    printf("%s", config->theme.b_junct);
-                    current_pos++;
-                }
-            }
-        }
-        printf("%s", config->theme.br_corner);
-        printf("%s\n", config->theme.text_color);
+        render_bottom_border(config);
     }
 
     // Render footer if present
@@ -13,4 +13,24 @@
  */
 void render_table(TableConfig *config, TableData *data);
 
+/*
+ * Build the border lines stored on the config, called once the column widths are known
+ */
+void build_table_borders(TableConfig *config, int total_width);
+
+/*
+ * Render the bottom border used when there is no footer
+ */
+void render_bottom_border(TableConfig *config);
+
+/*
+ * Render everything above the data rows: title, top border, headers and header separator
+ */
+void render_table_start(TableConfig *config, int total_width);
+
+/*
+ * Render everything below the data rows: summaries, bottom border and footer
+ */
+void render_table_end(TableConfig *config, TableData *data, int total_width);
+
 #endif /* TABLES_RENDER_OUTPUT_H */
@@ -6,283 +6,487 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tables_render_rows.h"
+#include "tables_render_buffer.h"
+#include "tables_arena.h"
+#include "tables_render_headers.h"
+#include "tables_render_summaries.h"
 #include "tables_render_utils.h"
+#include "tables_parallel.h"
+#include "tables_profile.h"
+#include "tables_page.h"
 
 /*
- * Render the data rows of the table with support for wrapping, truncation, and breaking
+ * Helper function to clip a line of delimiter-wrapped text that is wider than its column
+ * The clipped line is a slice of the line, so nothing is copied. Bytes are counted rather than
+ * display columns, which is how the Bash version clips these lines
  */
-void render_rows(TableConfig *config, TableData *data) {
-    extern int debug_mode;
-    // Find break column if any
-    int break_col = -1;
+static void clip_delimited_line(TextSpan *line, int effective_width, Justification justify) {
+    const char *text = line->text;
+    int length = line->length;
+    int first = 0;          // First byte kept
+    int count = 0;          // Number of bytes kept
+    int in_ansi = 0;
+
+    if (justify == JUSTIFY_RIGHT) {
+        int target_count = effective_width;
+        for (int p = length - 1; p >= 0 && target_count > 0; p--) {
+            if (text[p] == '\033') in_ansi = 1;
+            else if (in_ansi && text[p] == 'm') in_ansi = 0;
+            else if (!in_ansi) target_count--;
+            if (target_count <= 0) {
+                first = p + 1;
+                break;
+            }
+        }
+        count = length - first;
+    } else if (justify == JUSTIFY_CENTER) {
+        int total_excess = line->width - effective_width;
+        int left_excess = total_excess / 2;
+        int right_excess = total_excess - left_excess;
+        int left_cut = 0;
+        int right_cut = length - 1;
+        int left_count = 0, right_count = 0;
+
+        for (int p = 0; p < length && left_count < left_excess; p++) {
+            if (text[p] == '\033') in_ansi = 1;
+            else if (in_ansi && text[p] == 'm') in_ansi = 0;
+            else if (!in_ansi) left_count++;
+            left_cut = p;
+        }
+        in_ansi = 0;
+        for (int p = length - 1; p >= 0 && right_count < right_excess; p--) {
+            if (text[p] == '\033') in_ansi = 1;
+            else if (in_ansi && text[p] == 'm') in_ansi = 0;
+            else if (!in_ansi) right_count++;
+            right_cut = p;
+        }
+        // Adjust to match Bash behavior by fine-tuning centering
+        if (left_cut < right_cut) {
+            int display_count = 0;
+            first = left_cut + 1;
+            for (int p = first; p <= right_cut && display_count < effective_width; p++) {
+                count++;
+                if (!in_ansi && text[p] != '\033') display_count++;
+            }
+        } else {
+            first = left_cut;
+            count = right_cut >= left_cut ? right_cut - left_cut + 1 : 0;
+        }
+    } else {
+        // Left justification (default), take first 'effective_width' characters
+        int display_count = 0;
+        for (int p = 0; p < length && display_count < effective_width; p++) {
+            if (text[p] == '\033') in_ansi = 1;
+            else if (in_ansi && text[p] == 'm') in_ansi = 0;
+            else if (!in_ansi) display_count++;
+            count++;
+        }
+    }
+    line->text = text + first;
+    line->length = count;
+    line->width = get_display_width_n(line->text, count);
+}
+
+/*
+ * Helper function to make a cell's text its only line
+ */
+static const TextSpan *single_line(TextSpan *single, const char *text, int *out_line_count) {
+    single->text = text;
+    single->length = text ? strlen(text) : 0;
+    single->width = text ? get_display_width_n(text, single->length) : 0;
+    *out_line_count = text ? 1 : 0;
+    return text ? single : NULL;
+}
+
+/*
+ * Format a single cell into its display lines, applying clipping or wrapping as configured
+ * A cell of one line is returned in single, wrapped lines point into the formatted text
+ */
+static const TextSpan *format_cell_lines(ColumnConfig *col, const char *raw_value, ValueClass value_class, const double *number, int max_decimal_places, TextSpan *single, int *out_line_count) {
+    *out_line_count = 0;
+    char *formatted = format_classified_value(raw_value, value_class, number, col->null_val, col->zero_val, col->data_type, col->format, col->string_limit, col->wrap_mode, col->wrap_char, col->justify, max_decimal_places);
+    if (col->width_specified && col->wrap_mode == WRAP_CLIP) {
+        // Use color-aware clipping for better handling of color placeholders
+        int effective_width = col->width - 2; // Account for padding on both sides (1 left + 1 right)
+        Position clip_position = POSITION_LEFT;
+        if (col->justify == JUSTIFY_RIGHT) {
+            clip_position = POSITION_RIGHT;
+        } else if (col->justify == JUSTIFY_CENTER) {
+            clip_position = POSITION_CENTER;
+        }
+        
+        formatted = clip_text_with_colors(formatted, effective_width, clip_position);
+        return single_line(single, formatted, out_line_count);
+    } else if (col->width_specified && col->wrap_mode == WRAP_WRAP) {
+        // Wrap text if width is specified and wrapping is enabled
+        int line_count = 0;
+        TextSpan *wrapped;
+        if (col->wrap_char && strlen(col->wrap_char) > 0) {
+            // Delimiter-based wrapping
+            wrapped = wrap_text_delimiter(formatted, col->width - 2, col->wrap_char, &line_count);
+            if (wrapped) {
+                // Clip each wrapped line if it exceeds the width
+                int effective_width = (col->justify == JUSTIFY_RIGHT) ? col->width - 1 : col->width - 2;
+                for (int l = 0; l < line_count; l++) {
+                    if (wrapped[l].width > effective_width) {
+                        clip_delimited_line(&wrapped[l], effective_width, col->justify);
+                    }
+                }
+            }
+        } else {
+            // Standard word wrapping
+            wrapped = wrap_text(formatted, col->width - 2, &line_count);
+        }
+        if (wrapped == NULL) {
+            return single_line(single, formatted, out_line_count);
+        }
+        *out_line_count = line_count;
+        return wrapped;
+    }
+    // No wrapping or truncation needed
+    return single_line(single, formatted, out_line_count);
+}
+
+/*
+ * Find the column whose value changes trigger a break separator, or -1 if none
+ */
+int find_break_column(TableConfig *config) {
     for (int j = 0; j < config->column_count; j++) {
         if (config->columns[j].break_on_change) {
-            break_col = j;
-            break;
+            return j;
         }
     }
+    return -1;
+}
 
-    // Track the maximum number of lines across all columns for each row
-    char ****formatted_values = malloc(data->row_count * sizeof(char ***));
-    if (formatted_values == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed for formatted_values\n");
-        return;
+/*
+ * Render the separator line inserted when the break column value changes
+ */
+void render_break_separator(TableConfig *config) {
+    render_header_separator(config);
+}
+
+/*
+ * Render the separator and column headers repeated at the top of every page after the first
+ */
+void render_page_break(TableConfig *config) {
+    render_header_separator(config);
+    render_headers(config);
+    render_header_separator(config);
+}
+
+/*
+ * Helper function to check whether a row's value differs from the one kept for the row before it
+ * A null on either side starts nothing, the same as when the groups of subtotals are gathered
+ */
+static int boundary_value_changed(const char *kept, const char *value) {
+    return kept && value && strcmp(kept, value) != 0;
+}
+
+/*
+ * Helper function to keep a copy of a row's value, which must outlive the arena the row is in
+ */
+static void keep_boundary_value(char **kept, const char *value) {
+    if (*kept && value && strcmp(*kept, value) == 0) return;
+    free(*kept);
+    *kept = value ? strdup(value) : NULL;
+}
+
+/*
+ * Start tracking the boundaries of a table's rows, group_end being NULL when there are no subtotals
+ */
+void row_boundaries_init(RowBoundaries *bounds, TableConfig *config, GroupEndFunc group_end, void *context) {
+    memset(bounds, 0, sizeof(RowBoundaries));
+    bounds->config = config;
+    bounds->break_col = find_break_column(config);
+    bounds->group_col = group_end ? subtotal_break_column(config) : -1;
+    bounds->group_end = group_end;
+    bounds->context = context;
+}
+
+/*
+ * Handle what comes before the row at index: the end of the previous group, then for a row that
+ * is shown the page break or break separator
+ */
+void render_row_boundary(RowBoundaries *bounds, const DataRow *row, int index, int shown) {
+    if (bounds->group_col >= 0) {
+        const char *value = row->values[bounds->group_col];
+        if (bounds->group_rows > 0 && boundary_value_changed(bounds->group_value, value)) {
+            bounds->group_end(bounds->context, bounds->group_shown);
+            bounds->group_rows = 0;
+        }
+        keep_boundary_value(&bounds->group_value, value);
+        bounds->group_rows++;
+        bounds->group_shown = shown;
     }
-    int **line_counts = malloc(data->row_count * sizeof(int *));
-    if (line_counts == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed for line_counts\n");
-        free(formatted_values);
-        return;
+    if (!shown) return;
+
+    // Repeat the headers at the start of a page, which also separates a break
+    int page_start = page_row_starts_page(index);
+    if (page_start) {
+        render_page_break(bounds->config);
     }
-    for (int i = 0; i < data->row_count; i++) {
-        formatted_values[i] = malloc(config->column_count * sizeof(char **));
-        if (formatted_values[i] == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed for formatted_values[%d]\n", i);
-            for (int k = 0; k < i; k++) {
-                free(formatted_values[k]);
-            }
-            free(formatted_values);
-            free(line_counts);
-            return;
+    if (bounds->break_col >= 0) {
+        const char *value = row->values[bounds->break_col];
+        if (!page_start && boundary_value_changed(bounds->break_value, value)) {
+            render_break_separator(bounds->config);
         }
-        line_counts[i] = malloc(config->column_count * sizeof(int));
-        if (line_counts[i] == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed for line_counts[%d]\n", i);
-            free(formatted_values[i]);
-            for (int k = 0; k < i; k++) {
-                free(formatted_values[k]);
-                free(line_counts[k]);
-            }
-            free(formatted_values);
-            free(line_counts);
-            return;
+        keep_boundary_value(&bounds->break_value, value);
+    }
+}
+
+/*
+ * End the group of the last row once all rows have been passed to render_row_boundary()
+ */
+void render_last_boundary(RowBoundaries *bounds) {
+    if (bounds->group_col >= 0 && bounds->group_rows > 0) {
+        bounds->group_end(bounds->context, bounds->group_shown);
+        bounds->group_rows = 0;
+    }
+}
+
+/*
+ * Release the values kept by the boundary tracking
+ */
+void row_boundaries_free(RowBoundaries *bounds) {
+    free(bounds->break_value);
+    free(bounds->group_value);
+    bounds->break_value = NULL;
+    bounds->group_value = NULL;
+}
+
+/* Structure holding a data row formatted for output, with one entry per line and column */
+typedef struct {
+    int line_count;         /* Number of lines the row spans */
+    TextSpan *cells;        /* Text and display width of each line of each visible column, line_count x column_count */
+} PreparedRow;
+
+/*
+ * Format the cells of a data row into the text and display width of each line
+ * Columns without a configured width are never clipped or wrapped, so a cached cell is its only line
+ */
+static void prepare_data_row(TableConfig *config, TableData *data, DataRow *row, FormattedCell *cached, PreparedRow *prepared) {
+    const TextSpan *cell_lines[MAX_COLUMNS];
+    TextSpan single_lines[MAX_COLUMNS];
+    int line_counts[MAX_COLUMNS];
+    int placeholders[MAX_COLUMNS];
+
+    // Format and wrap text for all visible cells, tracking the maximum number of lines
+    int max_lines = 1;
+    int cells = 0;
+    for (int j = 0; j < config->column_count; j++) {
+        cell_lines[j] = NULL;
+        line_counts[j] = 0;
+        if (!config->columns[j].visible) continue;
+        cells++;
+        placeholders[j] = stored_has_placeholders(data, j, row);
+        if (cached && cached[j].text) {
+            single_lines[j].text = cached[j].text;
+            single_lines[j].length = strlen(cached[j].text);
+            single_lines[j].width = cached[j].width;
+            cell_lines[j] = &single_lines[j];
+            line_counts[j] = 1;
+            continue;
         }
+        cell_lines[j] = format_cell_lines(&config->columns[j], row->values[j], stored_value_class(data, j, row), stored_number(data, j, row), data->summaries[j].max_decimal_places, &single_lines[j], &line_counts[j]);
+        if (line_counts[j] > max_lines) max_lines = line_counts[j];
+    }
+
+    profile_add(PROFILE_ROWS, 1);
+    profile_add(PROFILE_CELLS, cells);
+
+    size_t entries = (size_t)max_lines * config->column_count;
+    prepared->cells = arena_alloc(entries * sizeof(TextSpan));
+    prepared->line_count = prepared->cells ? max_lines : 0;
+
+    for (int line = 0; line < prepared->line_count; line++) {
         for (int j = 0; j < config->column_count; j++) {
-            formatted_values[i][j] = NULL;
-            line_counts[i][j] = 0;
+            if (!config->columns[j].visible) continue;
+            TextSpan *cell = &prepared->cells[line * config->column_count + j];
+            if (line < line_counts[j]) {
+                *cell = cell_lines[j][line];
+            } else {
+                cell->text = "";
+                cell->length = 0;
+                cell->width = 0;
+            }
+            if (placeholders[j]) {
+                // Process color placeholders in data fields
+                char *colored_text = replace_color_placeholders(arena_strndup(cell->text, cell->length));
+                if (colored_text) {
+                    cell->text = colored_text;
+                    cell->length = strlen(colored_text);
+                }
+                cell->width = get_display_width(colored_text);
+            }
         }
     }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Allocated memory for formatted_values and line_counts for %d rows and %d columns\n", data->row_count, config->column_count);
-    }
+}
 
-    // Format and wrap text for all cells
-    for (int i = 0; i < data->row_count; i++) {
-        DataRow *row = &data->rows[i];
+/*
+ * Render the lines of a prepared data row, padding each cell to its column width
+ */
+static void write_prepared_row(TableConfig *config, const PreparedRow *prepared) {
+    const ThemeConfig *theme = &config->theme;
+    for (int line = 0; line < prepared->line_count; line++) {
+        output_write(theme->border_color, theme->lengths.border_color);
+        output_write(theme->v_line, theme->lengths.v_line);
         for (int j = 0; j < config->column_count; j++) {
             if (!config->columns[j].visible) continue;
             ColumnConfig *col = &config->columns[j];
-            char *raw_value = row->values[j];
-            char *formatted = format_display_value_with_precision(raw_value, col->null_val, col->zero_val, col->data_type, col->format, col->string_limit, col->wrap_mode, col->wrap_char, col->justify, data->summaries[j].max_decimal_places);
-            if (col->width_specified && col->wrap_mode == WRAP_CLIP) {
-                // Use color-aware clipping for better handling of color placeholders
-                int effective_width = col->width - 2; // Account for padding on both sides (1 left + 1 right)
-                Position clip_position = POSITION_LEFT;
+            const TextSpan *cell = &prepared->cells[line * config->column_count + j];
+            int value_width = cell->width;
+            int total_padding = col->width - value_width;
+            int padding_left = 1;  // Minimum 1 space padding on left
+            int padding_right = 1; // Minimum 1 space padding on right
+            int remaining_padding = total_padding - 2; // Account for minimum padding
+            if (remaining_padding > 0) {
                 if (col->justify == JUSTIFY_RIGHT) {
-                    clip_position = POSITION_RIGHT;
+                    padding_left += remaining_padding;
                 } else if (col->justify == JUSTIFY_CENTER) {
-                    clip_position = POSITION_CENTER;
-                }
-                
-                char *clipped = clip_text_with_colors(formatted, effective_width, clip_position);
-                free(formatted);
-                formatted = clipped;
-                formatted_values[i][j] = malloc(sizeof(char *));
-                formatted_values[i][j][0] = formatted;
-                line_counts[i][j] = 1;
-            } else if (col->width_specified && col->wrap_mode == WRAP_WRAP) {
-                // Wrap text if width is specified and wrapping is enabled
-                int line_count = 0;
-                char **wrapped;
-                if (col->wrap_char && strlen(col->wrap_char) > 0) {
-                    // Delimiter-based wrapping
-                    wrapped = wrap_text_delimiter(formatted, col->width - 2, col->wrap_char, &line_count);
-                    if (wrapped) {
-                        free(formatted);
-                        // Clip each wrapped line if it exceeds the width
-                        for (int l = 0; l < line_count; l++) {
-                            int display_width = get_display_width(wrapped[l]);
-                            int effective_width = (col->justify == JUSTIFY_RIGHT) ? col->width - 1 : col->width - 2;
-                            if (display_width > effective_width) {
-                                char *truncated = malloc(effective_width + 1);
-                                if (truncated) {
-                                    int k = 0, display_count = 0;
-                                    int in_ansi = 0;
-                                    const char *start_p = wrapped[l];
-                                    const char *end_p = wrapped[l] + strlen(wrapped[l]) - 1;
-                                    
-                                    if (col->justify == JUSTIFY_RIGHT) {
-                                        int target_count = effective_width;
-                                        for (const char *p = end_p; p >= wrapped[l] && target_count > 0; p--) {
-                                            if (*p == '\033') in_ansi = 1;
-                                            else if (in_ansi && *p == 'm') in_ansi = 0;
-                                            else if (!in_ansi) target_count--;
-                                            if (target_count <= 0) {
-                                                start_p = p + 1;
-                                                break;
-                                            }
-                                        }
-                                        if (start_p < wrapped[l]) start_p = wrapped[l];
-                                        for (const char *p = start_p; *p; p++) {
-                                            truncated[k++] = *p;
-                                        }
-                                    } else if (col->justify == JUSTIFY_CENTER) {
-                                        int total_excess = display_width - effective_width;
-                                        int left_excess = total_excess / 2;
-                                        int right_excess = total_excess - left_excess;
-                                        const char *left_cut = wrapped[l];
-                                        const char *right_cut = end_p;
-                                        int left_count = 0, right_count = 0;
-                                        
-                                        for (const char *p = wrapped[l]; *p && left_count < left_excess; p++) {
-                                            if (*p == '\033') in_ansi = 1;
-                                            else if (in_ansi && *p == 'm') in_ansi = 0;
-                                            else if (!in_ansi) left_count++;
-                                            left_cut = p;
-                                        }
-                                        in_ansi = 0;
-                                        for (const char *p = end_p; p >= wrapped[l] && right_count < right_excess; p--) {
-                                            if (*p == '\033') in_ansi = 1;
-                                            else if (in_ansi && *p == 'm') in_ansi = 0;
-                                            else if (!in_ansi) right_count++;
-                                            right_cut = p;
-                                        }
-                                        // Adjust to match Bash behavior by fine-tuning centering
-                                        if (left_cut < right_cut) {
-                                            for (const char *p = left_cut + 1; p <= right_cut && *p; p++) {
-                                                if (display_count < effective_width) {
-                                                    truncated[k++] = *p;
-                                                    if (!in_ansi && *p != '\033') display_count++;
-                                                }
-                                            }
-                                        } else {
-                                            for (const char *p = left_cut; p <= right_cut && *p; p++) {
-                                                truncated[k++] = *p;
-                                            }
-                                        }
-                                    } else {
-                                        // Left justification (default), take first 'effective_width' characters
-                                        // Use same logic as main clipping section (lines 152-158)
-                                        for (const char *p = wrapped[l]; *p && display_count < effective_width; p++) {
-                                            if (*p == '\033') in_ansi = 1;
-                                            else if (in_ansi && *p == 'm') in_ansi = 0;
-                                            else if (!in_ansi) display_count++;
-                                            truncated[k++] = *p;
-                                        }
-                                    }
-                                    truncated[k] = '\0';
-                                    free(wrapped[l]);
-                                    wrapped[l] = truncated;
-                                }
-                            }
-                        }
-                        formatted_values[i][j] = wrapped;
-                        line_counts[i][j] = line_count;
-                    } else {
-                        formatted_values[i][j] = malloc(sizeof(char *));
-                        formatted_values[i][j][0] = formatted;
-                        line_counts[i][j] = 1;
-                    }
+                    padding_left += remaining_padding / 2;
+                    padding_right += remaining_padding - (remaining_padding / 2);
                 } else {
-                    // Standard word wrapping
-                    wrapped = wrap_text(formatted, col->width - 2, &line_count);
-                    if (wrapped) {
-                        free(formatted);
-                        formatted_values[i][j] = wrapped;
-                        line_counts[i][j] = line_count;
-                    } else {
-                        formatted_values[i][j] = malloc(sizeof(char *));
-                        formatted_values[i][j][0] = formatted;
-                        line_counts[i][j] = 1;
-                    }
+                    padding_right += remaining_padding;
                 }
-            } else {
-                // No wrapping or truncation needed
-                formatted_values[i][j] = malloc(sizeof(char *));
-                formatted_values[i][j][0] = formatted;
-                line_counts[i][j] = 1;
             }
+            output_write(theme->text_color, theme->lengths.text_color);
+            output_spaces(padding_left);
+            output_write(cell->text, cell->length);
+            output_spaces(padding_right);
+            output_write(theme->border_color, theme->lengths.border_color);
+            output_write(theme->v_line, theme->lengths.v_line);
         }
+        output_write(theme->text_color, theme->lengths.text_color);
+        output_write("\n", 1);
     }
+}
 
-    // Render rows with multi-line support and breaking
-    char *prev_break_value = NULL;
-    for (int i = 0; i < data->row_count; i++) {
-        // Check for break
-        if (break_col >= 0 && i > 0) {
-            char *current_break_value = data->rows[i].values[break_col];
-            if (prev_break_value && current_break_value && strcmp(prev_break_value, current_break_value) != 0) {
-                // Render break separator
-                printf("%s", config->theme.border_color);
-                printf("%s", config->theme.l_junct);
-                for (int j = 0; j < config->column_count; j++) {
-                    if (!config->columns[j].visible) continue;
-                    for (int w = 0; w < config->columns[j].width; w++) {
-                        printf("%s", config->theme.h_line);
-                    }
-                    if (j < config->column_count - 1) {
-                        printf("%s", config->theme.cross);
-                    }
-                }
-                printf("%s%s\n", config->theme.r_junct, config->theme.text_color);
-            }
-            prev_break_value = current_break_value;
-        } else if (i == 0 && break_col >= 0) {
-            prev_break_value = data->rows[i].values[break_col];
-        }
+/*
+ * Format and render a single data row, which may span several lines when cells wrap
+ */
+void render_data_row(TableConfig *config, TableData *data, DataRow *row, FormattedCell *cached) {
+    PreparedRow prepared;
+    prepare_data_row(config, data, row, cached, &prepared);
+    write_prepared_row(config, &prepared);
+}
 
-        // Determine max lines for this row
-        int max_lines = 1;
-        for (int j = 0; j < config->column_count; j++) {
-            if (!config->columns[j].visible) continue;
-            if (line_counts[i][j] > max_lines) max_lines = line_counts[i][j];
+/* Structure shared by the threads formatting a window of rows */
+typedef struct {
+    TableConfig *config;
+    TableData *data;
+    int first_row;                      /* Row of the table the window starts at */
+    PreparedRow *prepared;              /* Formatted rows of the window */
+    ArenaMark marks[MAX_THREADS];       /* Position each block arena is reset to for the next window */
+    int marked[MAX_THREADS];
+} RenderWindowContext;
+
+/*
+ * Helper function to format one block of a window of rows
+ * The text of the previous window has been written, so it is dropped first
+ */
+static void prepare_row_block(void *context, int block, int start, int end) {
+    RenderWindowContext *ctx = context;
+    if (ctx->marked[block]) {
+        arena_reset(ctx->marks[block]);
+    } else {
+        ctx->marks[block] = arena_mark();
+        ctx->marked[block] = 1;
+    }
+    int column_count = ctx->config->column_count;
+    for (int i = start; i < end; i++) {
+        int row_index = ctx->first_row + i;
+        FormattedCell *cached = ctx->data->cells ? &ctx->data->cells[row_index * column_count] : NULL;
+        prepare_data_row(ctx->config, ctx->data, &ctx->data->rows[row_index], cached, &ctx->prepared[i]);
+    }
+}
+
+/* Structure passed to the group ends of rows held in memory, whose subtotals are already gathered */
+typedef struct {
+    TableConfig *config;
+    TableData *data;
+    int group;              /* Group the rows met so far belong to */
+} HeldGroups;
+
+/*
+ * Helper function to render the subtotals of a group of rows held in memory as it ends
+ */
+static void end_held_group(void *context, int shown) {
+    HeldGroups *groups = context;
+    if (shown && groups->group < groups->data->group_count) {
+        render_subtotals(groups->config, &groups->data->group_summaries[groups->group * groups->config->column_count]);
+    }
+    groups->group++;
+}
+
+/*
+ * Render the data rows of the table with support for wrapping, truncation, and breaking
+ * Rows are formatted and printed one at a time so only a single row of formatted text is held,
+ * or with several threads a window of RENDER_WINDOW_ROWS rows per thread is formatted in parallel
+ * and then printed in order. With --page only the rows of that page are formatted. The subtotals
+ * of a group follow its last row
+ */
+void render_rows(TableConfig *config, TableData *data) {
+    int first, end;
+    page_window(data->row_count, &first, &end);
+    page_check_rows(data->row_count);
+    int block_count = parallel_block_count(end - first);
+    RenderWindowContext *window = NULL;
+    int window_rows = 0;
+    if (block_count > 1) {
+        window_rows = block_count * RENDER_WINDOW_ROWS;
+        window = calloc(1, sizeof(RenderWindowContext));
+        if (window) window->prepared = malloc((size_t)window_rows * sizeof(PreparedRow));
+        if (window && window->prepared == NULL) {
+            free(window);
+            window = NULL;
         }
+    }
 
-        // Render each line of the row
-        for (int line = 0; line < max_lines; line++) {
-            printf("%s%s", config->theme.border_color, config->theme.v_line);
-            for (int j = 0; j < config->column_count; j++) {
-                if (!config->columns[j].visible) continue;
-                ColumnConfig *col = &config->columns[j];
-                char *text = (line < line_counts[i][j]) ? formatted_values[i][j][line] : "";
-                // Process color placeholders in data fields
-                char *colored_text = replace_color_placeholders(text);
-                int value_width = get_display_width(colored_text);
-                int total_padding = col->width - value_width;
-                int padding_left = 1;  // Minimum 1 space padding on left
-                int padding_right = 1; // Minimum 1 space padding on right
-                int remaining_padding = total_padding - 2; // Account for minimum padding
-                if (remaining_padding > 0) {
-                    if (col->justify == JUSTIFY_RIGHT) {
-                        padding_left += remaining_padding;
-                    } else if (col->justify == JUSTIFY_CENTER) {
-                        padding_left += remaining_padding / 2;
-                        padding_right += remaining_padding - (remaining_padding / 2);
-                    } else {
-                        padding_right += remaining_padding;
-                    }
-                }
-                printf("%s%*s%s%*s", config->theme.text_color, padding_left, "", colored_text, padding_right, "");
-                printf("%s%s", config->theme.border_color, config->theme.v_line);
-                free(colored_text);
+    // The groups were gathered over all rows, so a page starts in the group of the row before it
+    HeldGroups groups = { config, data, 0 };
+    RowBoundaries bounds;
+    row_boundaries_init(&bounds, config, data->group_count > 0 ? end_held_group : NULL, &groups);
+    if (first > 0 && first < end) {
+        while (groups.group < data->group_count && data->group_ends[groups.group] <= first - 1) groups.group++;
+        render_row_boundary(&bounds, &data->rows[first - 1], first - 1, 0);
+    }
+
+    // Render rows with multi-line support and breaking
+    for (int i = first; i < end; i++) {
+        render_row_boundary(&bounds, &data->rows[i], i, 1);
+
+        if (window) {
+            // Format the next window of rows when the previous one has been printed
+            if (((i - first) % window_rows) == 0) {
+                int rows = end - i < window_rows ? end - i : window_rows;
+                window->config = config;
+                window->data = data;
+                window->first_row = i;
+                parallel_run(rows, block_count, prepare_row_block, window);
             }
-            printf("%s\n", config->theme.text_color);
+            write_prepared_row(config, &window->prepared[(i - first) % window_rows]);
+        } else {
+            // Formatting temporaries only live until the row is printed
+            FormattedCell *cached = data->cells ? &data->cells[i * config->column_count] : NULL;
+            ArenaMark mark = arena_mark();
+            render_data_row(config, data, &data->rows[i], cached);
+            arena_reset(mark);
         }
     }
 
-    // Clean up formatted values
-    for (int i = 0; i < data->row_count; i++) {
-        for (int j = 0; j < config->column_count; j++) {
-            if (formatted_values[i][j]) {
-                free_wrapped_text(formatted_values[i][j], line_counts[i][j]);
-            }
+    // Close the group of the last row printed, unless the row after it is still in that group
+    if (first < end) {
+        if (end < data->row_count) {
+            render_row_boundary(&bounds, &data->rows[end], end, 0);
+        } else {
+            render_last_boundary(&bounds);
         }
-        free(formatted_values[i]);
-        free(line_counts[i]);
     }
-    free(formatted_values);
-    free(line_counts);
-    if (debug_mode) {
-        fprintf(stderr, "Debug: Freed memory for formatted_values and line_counts\n");
+    row_boundaries_free(&bounds);
+
+    if (window) {
+        free(window->prepared);
+        free(window);
     }
 }
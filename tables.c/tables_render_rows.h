@@ -8,9 +8,72 @@
 #include "tables_config.h"
 #include "tables_data.h"
 
+/* Rows formatted by each thread before the formatted rows are printed */
+#define RENDER_WINDOW_ROWS 1024
+
+/* Called when a group of rows ends, shown set if its last row was printed so its subtotals follow */
+typedef void (*GroupEndFunc)(void *context, int shown);
+
+/* Structure tracking the page starts, breaks and group ends met while rendering rows in input order */
+typedef struct {
+    TableConfig *config;
+    int break_col;          /* Column whose value changes draw a break separator, -1 for none */
+    char *break_value;      /* Break value of the row printed last, NULL before the first */
+    int group_col;          /* Column whose value changes end a group of subtotals, -1 for none */
+    char *group_value;      /* Group value of the row met last */
+    int group_rows;         /* Rows met in the current group */
+    int group_shown;        /* Flag if the last row met in the current group was printed */
+    GroupEndFunc group_end; /* Called as each group ends, NULL without subtotals */
+    void *context;          /* Argument of group_end */
+} RowBoundaries;
+
+/*
+ * Start tracking the boundaries of a table's rows, group_end being NULL when there are no subtotals
+ */
+void row_boundaries_init(RowBoundaries *bounds, TableConfig *config, GroupEndFunc group_end, void *context);
+
+/*
+ * Handle what comes before the row at index: the end of the previous group, then for a row that
+ * is shown the page break or break separator. Rows are passed in order, shown or not, and a
+ * table whose groups are already known may start with the row before the first one shown
+ */
+void render_row_boundary(RowBoundaries *bounds, const DataRow *row, int index, int shown);
+
+/*
+ * End the group of the last row once all rows have been passed to render_row_boundary()
+ */
+void render_last_boundary(RowBoundaries *bounds);
+
+/*
+ * Release the values kept by the boundary tracking
+ */
+void row_boundaries_free(RowBoundaries *bounds);
+
 /*
  * Render the data rows of the table with support for wrapping, truncation, and breaking
  */
 void render_rows(TableConfig *config, TableData *data);
 
+/*
+ * Format and render a single data row, which may span several lines when cells wrap
+ * Cells present in cached (one entry per column, may be NULL) are used as is instead of being formatted
+ * Formatted text is allocated from the arena, callers can reset it to a mark taken before the call
+ */
+void render_data_row(TableConfig *config, TableData *data, DataRow *row, FormattedCell *cached);
+
+/*
+ * Find the column whose value changes trigger a break separator, or -1 if none
+ */
+int find_break_column(TableConfig *config);
+
+/*
+ * Render the separator line inserted when the break column value changes
+ */
+void render_break_separator(TableConfig *config);
+
+/*
+ * Render the separator and column headers repeated at the top of every page after the first
+ */
+void render_page_break(TableConfig *config);
+
 #endif /* TABLES_RENDER_ROWS_H */
@@ -0,0 +1,360 @@
+/*
+ * tables_render_stream.c - Streaming table rendering
+ * Parses rows incrementally from the data file and renders each one as soon as it is read,
+ * computing summaries on the fly and printing them once the data is exhausted. The subtotals
+ * of a group are printed as soon as the next row starts another group.
+ * Layouts that need the data to size their columns are rendered in two passes over a
+ * memory-mapped data file instead, so that no rows are held in memory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tables_render_stream.h"
+#include "tables_data.h"
+#include "tables_reader.h"
+#include "tables_select.h"
+#include "tables_page.h"
+#include "tables_arena.h"
+#include "tables_render_layout.h"
+#include "tables_render_output.h"
+#include "tables_render_rows.h"
+#include "tables_render_summaries.h"
+#include "tables_render_utils.h"
+#include "tables_render_buffer.h"
+#include "tables_input.h"
+#include "tables_profile.h"
+
+/*
+ * Check whether the layout can be rendered while the data is still being read
+ * Column widths have to be known up front and rows have to be rendered in input order, so a limit
+ * shows the first rows read
+ */
+int stream_mode_supported(TableConfig *config, const char **reason) {
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        if (col->visible && !col->width_specified) {
+            if (reason) *reason = "every visible column needs a width";
+            return 0;
+        }
+    }
+    if (config->sort_count > 0) {
+        if (reason) *reason = "sorting needs all rows before rendering";
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Check whether streaming produces output identical to the normal mode
+ * Float columns are padded to the largest precision across all rows, which is only known at the end
+ */
+int stream_mode_automatic(TableConfig *config) {
+    if (!stream_mode_supported(config, NULL)) return 0;
+    for (int j = 0; j < config->column_count; j++) {
+        ColumnConfig *col = &config->columns[j];
+        if (col->visible && col->data_type == DATA_FLOAT) return 0;
+    }
+    return 1;
+}
+
+/* Structure holding the subtotals of the group of streamed rows being read */
+typedef struct {
+    TableConfig *config;
+    SummaryStats *stats;    /* Subtotals of the rows read in the group */
+} StreamedGroup;
+
+/*
+ * Helper function to print the subtotals of a streamed group as it ends, then start the next one
+ */
+static void end_streamed_group(void *context, int shown) {
+    StreamedGroup *group = context;
+    if (shown) {
+        ProfilePhase previous = profile_switch(PROFILE_FORMAT);
+        render_subtotals(group->config, group->stats);
+        profile_switch(previous);
+    }
+    clear_summaries(group->stats, group->config->column_count);
+}
+
+/*
+ * Render the table while reading the data file one row at a time
+ */
+int render_table_stream(const char *data_file, TableConfig *config) {
+    extern int tables_debug_mode;
+    TableData data;
+    JsonArrayReader reader;
+
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Streaming data from %s\n", input_name(data_file));
+    }
+
+    FILE *fp = input_open(data_file);
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Cannot open data file %s\n", data_file);
+        return 1;
+    }
+
+    memset(&data, 0, sizeof(TableData));
+    data.max_lines = 1;
+    data.summaries = malloc(config->column_count * sizeof(SummaryStats));
+    if (data.summaries == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for summaries\n");
+        input_close(fp);
+        return 1;
+    }
+    initialize_summaries(config, &data);
+    if (init_column_store(config, &data, 1) != 0) { // Rows are parsed into the same slot one at a time
+        free_table_data(&data, config->column_count);
+        input_close(fp);
+        return 1;
+    }
+
+    // Widths are fixed, so the top of the table can be drawn before any data is read
+    ProfilePhase previous = profile_switch(PROFILE_WIDTHS);
+    calculate_column_widths(config, &data);
+    profile_switch(PROFILE_FORMAT);
+    int total_width = calculate_total_width(config);
+    render_table_start(config, total_width);
+    profile_switch(PROFILE_LOAD);
+
+    // Subtotals of the group being read, printed when the next group starts
+    StreamedGroup group = { config, NULL };
+    if (subtotal_break_column(config) >= 0) {
+        group.stats = calloc(config->column_count, sizeof(SummaryStats));
+    }
+    RowBoundaries bounds;
+    row_boundaries_init(&bounds, config, group.stats ? end_streamed_group : NULL, &group);
+
+    json_array_reader_init_file(&reader, fp);
+    int interactive = isatty(STDOUT_FILENO);
+    int limit = select_row_limit(config);
+    int summarize_all = select_summarizes_all(config);
+    int row_count = 0;
+    int status;
+    DataRow row;
+
+    while ((status = read_next_row(&reader, config, &row)) > 0) {
+        ArenaMark mark = arena_mark();
+
+        // Rows past the limit are only read for the summaries of all rows
+        if (limit > 0 && row_count >= limit) {
+            if (!summarize_all) {
+                arena_reset(mark);
+                status = 0;
+                break;
+            }
+            store_row_values(config, &data, 0, &row);
+            accumulate_row_summaries(config, &data, &row);
+            arena_reset(mark);
+            continue;
+        }
+
+        store_row_values(config, &data, 0, &row);
+        accumulate_row_summaries(config, &data, &row);
+
+        // The group before this row ends when its value changes, then rows off the page printed
+        // are only read for the summaries
+        int shown = page_row_shown(row_count);
+        if (shown) profile_switch(PROFILE_FORMAT);
+        render_row_boundary(&bounds, &row, row_count, shown);
+        if (group.stats) accumulate_row_subtotals(config, &data, &row, group.stats);
+        if (!shown) {
+            arena_reset(mark);
+            row_count++;
+            continue;
+        }
+
+        render_data_row(config, &data, &row, NULL);
+        arena_reset(mark);
+        if (interactive) output_flush(); // Show each row as soon as it is read
+        row_count++;
+        profile_switch(PROFILE_LOAD);
+    }
+    profile_switch(PROFILE_FORMAT);
+
+    json_array_reader_free(&reader);
+    input_close(fp);
+
+    if (status == 0) {
+        render_last_boundary(&bounds);
+        page_check_rows(row_count);
+        render_table_end(config, &data, total_width);
+        if (tables_debug_mode) {
+            fprintf(stderr, "Debug: Streamed %d rows\n", row_count);
+        }
+    }
+    output_finish();
+    profile_switch(previous);
+
+    if (group.stats) {
+        clear_summaries(group.stats, config->column_count);
+        free(group.stats);
+    }
+    row_boundaries_free(&bounds);
+    free_table_data(&data, config->column_count);
+    return status == 0 ? 0 : 1;
+}
+
+/*
+ * Check whether the layout can be rendered in two passes over a memory-mapped data file
+ * Pipes cannot be mapped or read twice, so the data has to be a regular file. Subtotals are
+ * measured once every group is known, which the width pass does not keep
+ */
+int mapped_mode_supported(TableConfig *config, const char *data_file, const char **reason) {
+    if (config->sort_count > 0) {
+        if (reason) *reason = "sorting needs all rows before rendering";
+        return 0;
+    }
+    if (subtotal_break_column(config) >= 0) {
+        if (reason) *reason = "subtotals need the groups of rows before rendering";
+        return 0;
+    }
+    if (!input_is_regular(data_file)) {
+        if (reason) *reason = "the data is not a regular file";
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Render the table in two passes over a memory-mapped data file
+ * The first pass gathers column widths and summaries, the second renders the rows
+ */
+int render_table_mapped(const char *data_file, TableConfig *config) {
+    extern int tables_debug_mode;
+    TableData data;
+    JsonArrayReader reader;
+    struct stat st;
+
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Mapping data from %s\n", input_name(data_file));
+    }
+
+    int fd = input_is_stdin(data_file) ? dup(STDIN_FILENO) : open(data_file, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open data file %s\n", data_file);
+        return 1;
+    }
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        fprintf(stderr, "Error: Data file %s is not a regular file\n", input_name(data_file));
+        close(fd);
+        return 1;
+    }
+    if (st.st_size == 0) {
+        fprintf(stderr, "Error: Data JSON root must be an array\n");
+        close(fd);
+        return 1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    char *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map data file %s\n", input_name(data_file));
+        return 1;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    memset(&data, 0, sizeof(TableData));
+    data.max_lines = 1;
+    data.summaries = malloc(config->column_count * sizeof(SummaryStats));
+    ColumnWidthTracker *trackers = malloc(config->column_count * sizeof(ColumnWidthTracker));
+    if (data.summaries == NULL || trackers == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for summaries\n");
+        free(data.summaries);
+        free(trackers);
+        munmap(mapped, size);
+        return 1;
+    }
+    initialize_summaries(config, &data);
+    init_column_widths(config, trackers);
+    if (init_column_store(config, &data, 1) != 0) { // Rows are parsed into the same slot one at a time
+        free_table_data(&data, config->column_count);
+        free(trackers);
+        munmap(mapped, size);
+        return 1;
+    }
+
+    json_array_reader_init_buffer(&reader, mapped, size);
+    ProfilePhase previous = profile_switch(PROFILE_LOAD);
+    int limit = select_row_limit(config);
+    int summarize_all = select_summarizes_all(config);
+    int row_count = 0;
+    int status;
+    DataRow row;
+
+    // First pass: summaries and column widths, of the rows shown when there is a limit
+    while ((status = read_next_row(&reader, config, &row)) > 0) {
+        ArenaMark mark = arena_mark();
+        int shown = limit == 0 || row_count < limit;
+        if (!shown && !summarize_all) {
+            arena_reset(mark);
+            status = 0;
+            break;
+        }
+        store_row_values(config, &data, 0, &row);
+        accumulate_row_summaries(config, &data, &row);
+        if (shown) {
+            measure_row_widths(config, &data, &row, trackers);
+            row_count++;
+        }
+        arena_reset(mark);
+    }
+
+    if (status == 0) {
+        profile_switch(PROFILE_WIDTHS);
+        finalize_column_widths(config, &data, trackers);
+        profile_switch(PROFILE_FORMAT);
+        int total_width = calculate_total_width(config);
+        render_table_start(config, total_width);
+        profile_switch(PROFILE_LOAD);
+
+        // Second pass: render the rows
+        json_array_reader_rewind(&reader);
+        RowBoundaries bounds;
+        row_boundaries_init(&bounds, config, NULL, NULL); // Layouts with subtotals are not mapped
+        int rendered = 0;
+
+        while ((status = read_next_row(&reader, config, &row)) > 0) {
+            if (rendered == row_count || page_row_past_end(rendered)) {
+                status = 0; // The rest of the rows are past the limit or the page printed
+                break;
+            }
+            if (!page_row_shown(rendered)) {
+                rendered++;
+                continue;
+            }
+            ArenaMark mark = arena_mark();
+            store_row_values(config, &data, 0, &row);
+            profile_switch(PROFILE_FORMAT);
+            render_row_boundary(&bounds, &row, rendered, 1);
+            render_data_row(config, &data, &row, NULL);
+            arena_reset(mark);
+            rendered++;
+            profile_switch(PROFILE_LOAD);
+        }
+        row_boundaries_free(&bounds);
+        profile_switch(PROFILE_FORMAT);
+
+        if (status == 0) {
+            page_check_rows(row_count);
+            render_table_end(config, &data, total_width);
+            if (tables_debug_mode) {
+                fprintf(stderr, "Debug: Rendered %d mapped rows in two passes\n", row_count);
+            }
+        }
+    }
+
+    output_finish();
+    profile_switch(previous);
+    json_array_reader_free(&reader);
+    munmap(mapped, size);
+    free(trackers);
+    free_table_data(&data, config->column_count);
+    return status == 0 ? 0 : 1;
+}
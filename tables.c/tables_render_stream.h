@@ -0,0 +1,39 @@
+/*
+ * tables_render_stream.h - Header file for streaming table rendering
+ */
+
+#ifndef TABLES_RENDER_STREAM_H
+#define TABLES_RENDER_STREAM_H
+
+#include "tables_config.h"
+
+/*
+ * Check whether the layout can be rendered while the data is still being read
+ * Returns 1 if possible, otherwise 0 with a short explanation in reason
+ */
+int stream_mode_supported(TableConfig *config, const char **reason);
+
+/*
+ * Check whether streaming produces output identical to the normal mode, so it can be used automatically
+ */
+int stream_mode_automatic(TableConfig *config);
+
+/*
+ * Render the table while reading the data file one row at a time
+ * Memory use stays constant regardless of the number of rows
+ */
+int render_table_stream(const char *data_file, TableConfig *config);
+
+/*
+ * Check whether the layout can be rendered in two passes over a memory-mapped data file
+ * Returns 1 if possible, otherwise 0 with a short explanation in reason
+ */
+int mapped_mode_supported(TableConfig *config, const char *data_file, const char **reason);
+
+/*
+ * Render the table in two passes over a memory-mapped data file
+ * Column widths are measured in the first pass, so no column needs a configured width
+ */
+int render_table_mapped(const char *data_file, TableConfig *config);
+
+#endif /* TABLES_RENDER_STREAM_H */
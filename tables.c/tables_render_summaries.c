@@ -6,44 +6,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tables_render_summaries.h"
+#include "tables_render_buffer.h"
+#include "tables_arena.h"
+#include "tables_render_headers.h"
 #include "tables_render_utils.h"
 
 /*
- * Render the summaries row if any summaries are defined
+ * Helper function to render a row of summaries, the subtotals of a group when subtotal is set
  */
-void render_summaries(TableConfig *config, TableData *data) {
-    // Check if there are any summaries to render
-    int has_summaries = 0;
-    for (int j = 0; j < config->column_count; j++) {
-        if (config->columns[j].summary != SUMMARY_NONE) {
-            has_summaries = 1;
-            break;
-        }
-    }
-    if (!has_summaries) return;
-
-    // Render summary separator
-    printf("%s", config->theme.border_color);
-    printf("%s", config->theme.l_junct);
-    for (int j = 0; j < config->column_count; j++) {
-        if (!config->columns[j].visible) continue;
-        for (int w = 0; w < config->columns[j].width; w++) {
-            printf("%s", config->theme.h_line);
-        }
-        if (j < config->column_count - 1) {
-            printf("%s", config->theme.cross);
-        }
-    }
-    printf("%s%s\n", config->theme.r_junct, config->theme.text_color);
-    
-    // Render summary row
-    printf("%s%s", config->theme.border_color, config->theme.v_line);
+static void render_summary_row(TableConfig *config, SummaryStats *summaries, int subtotal) {
+    output_printf("%s%s", config->theme.border_color, config->theme.v_line);
     for (int j = 0; j < config->column_count; j++) {
         if (!config->columns[j].visible) continue;
         ColumnConfig *col = &config->columns[j];
-        SummaryStats *stats = &data->summaries[j];
+        SummaryStats *stats = &summaries[j];
         char summary_text[256] = {0};
-        switch (col->summary) {
+        switch (subtotal ? col->subtotal : col->summary) {
             case SUMMARY_SUM:
                 // Only show summary if sum is not zero
                 if (stats->sum != 0.0) {
@@ -51,12 +29,10 @@ void render_summaries(TableConfig *config, TableData *data) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
                         char *formatted = format_with_commas(summary_text);
                         snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
-                        free(formatted);
                     } else if (col->data_type == DATA_KMEM) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
                         char *formatted = format_with_commas(summary_text);
                         snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
-                        free(formatted);
                     } else if (col->data_type == DATA_FLOAT) {
                         char format[16];
                         snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
@@ -64,19 +40,16 @@ void render_summaries(TableConfig *config, TableData *data) {
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->sum);
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     } else {
                         snprintf(summary_text, sizeof(summary_text), "%.2f", stats->sum);
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     }
                 } else {
                     summary_text[0] = '\0'; // Empty string for zero sum
@@ -89,12 +62,10 @@ void render_summaries(TableConfig *config, TableData *data) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
                         char *formatted = format_with_commas(summary_text);
                         snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
-                        free(formatted);
                     } else if (col->data_type == DATA_KMEM) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
                         char *formatted = format_with_commas(summary_text);
                         snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
-                        free(formatted);
                     } else if (col->data_type == DATA_FLOAT) {
                         char format[16];
                         snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
@@ -102,19 +73,16 @@ void render_summaries(TableConfig *config, TableData *data) {
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->min);
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     } else {
                         snprintf(summary_text, sizeof(summary_text), "%.2f", stats->min);
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     }
                 } else {
                     summary_text[0] = '\0'; // Empty string if no data
@@ -127,12 +95,10 @@ void render_summaries(TableConfig *config, TableData *data) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
                         char *formatted = format_with_commas(summary_text);
                         snprintf(summary_text, sizeof(summary_text), "%sm", formatted);
-                        free(formatted);
                     } else if (col->data_type == DATA_KMEM) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
                         char *formatted = format_with_commas(summary_text);
                         snprintf(summary_text, sizeof(summary_text), "%sM", formatted);
-                        free(formatted);
                     } else if (col->data_type == DATA_FLOAT) {
                         char format[16];
                         snprintf(format, sizeof(format), "%%.%df", stats->max_decimal_places);
@@ -140,19 +106,16 @@ void render_summaries(TableConfig *config, TableData *data) {
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
                         snprintf(summary_text, sizeof(summary_text), "%.0f", stats->max);
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     } else {
                         snprintf(summary_text, sizeof(summary_text), "%.2f", stats->max);
                         char *formatted = format_with_commas(summary_text);
                         strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                         summary_text[sizeof(summary_text) - 1] = '\0';
-                        free(formatted);
                     }
                 } else {
                     summary_text[0] = '\0'; // Empty string if no data
@@ -170,19 +133,16 @@ void render_summaries(TableConfig *config, TableData *data) {
                             char *formatted = format_with_commas(summary_text);
                             strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                             summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
                         } else if (col->data_type == DATA_INT || col->data_type == DATA_NUM) {
                             snprintf(summary_text, sizeof(summary_text), "%.0f", avg_result);
                             char *formatted = format_with_commas(summary_text);
                             strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                             summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
                         } else {
                             snprintf(summary_text, sizeof(summary_text), "%.2f", avg_result);
                             char *formatted = format_with_commas(summary_text);
                             strncpy(summary_text, formatted, sizeof(summary_text) - 1);
                             summary_text[sizeof(summary_text) - 1] = '\0';
-                            free(formatted);
                         }
                     } else {
                         summary_text[0] = '\0'; // Empty string for zero average
@@ -197,17 +157,18 @@ void render_summaries(TableConfig *config, TableData *data) {
             case SUMMARY_UNIQUE:
                 snprintf(summary_text, sizeof(summary_text), "%d", stats->unique_count);
                 break;
+            case SUMMARY_UNIQUE_APPROX:
+                snprintf(summary_text, sizeof(summary_text), "~%d", estimate_unique_count(stats));
+                break;
             case SUMMARY_BLANKS:
                 snprintf(summary_text, sizeof(summary_text), "%d", stats->blanks);
                 char *formatted_blanks = format_with_commas(summary_text);
                 strncpy(summary_text, formatted_blanks, sizeof(summary_text) - 1);
-                free(formatted_blanks);
                 break;
             case SUMMARY_NONBLANKS:
                 snprintf(summary_text, sizeof(summary_text), "%d", stats->nonblanks);
                 char *formatted_nonblanks = format_with_commas(summary_text);
                 strncpy(summary_text, formatted_nonblanks, sizeof(summary_text) - 1);
-                free(formatted_nonblanks);
                 break;
             default:
                 summary_text[0] = '\0';
@@ -216,7 +177,7 @@ void render_summaries(TableConfig *config, TableData *data) {
         int summary_width = get_display_width(summary_display);
         int effective_width = col->width - 1; // Account for minimum padding, let rendering handle the rest
         if (summary_width > effective_width && col->wrap_mode == WRAP_CLIP) {
-            char *truncated = malloc(col->width + 1);
+            char *truncated = arena_alloc(col->width + 1);
             if (truncated) {
                 int k = 0, display_count = 0;
                 int in_ansi = 0;
@@ -271,7 +232,6 @@ void render_summaries(TableConfig *config, TableData *data) {
                     }
                 }
                 truncated[k] = '\0';
-                free(summary_display);
                 summary_display = truncated;
                 summary_width = get_display_width(summary_display);
             }
@@ -290,9 +250,40 @@ void render_summaries(TableConfig *config, TableData *data) {
                 padding_right += remaining_padding;
             }
         }
-        printf("%s%*s%s%*s", config->theme.summary_color, padding_left, "", summary_display, padding_right, "");
-        free(summary_display);
-        printf("%s%s", config->theme.border_color, config->theme.v_line);
+        output_printf("%s%*s%s%*s", config->theme.summary_color, padding_left, "", summary_display, padding_right, "");
+        output_printf("%s%s", config->theme.border_color, config->theme.v_line);
+    }
+    output_printf("%s\n", config->theme.text_color);
+}
+
+/*
+ * Render the summaries row if any summaries are defined
+ */
+void render_summaries(TableConfig *config, TableData *data) {
+    // Check if there are any summaries to render
+    int has_summaries = 0;
+    for (int j = 0; j < config->column_count; j++) {
+        if (config->columns[j].summary != SUMMARY_NONE) {
+            has_summaries = 1;
+            break;
+        }
     }
-    printf("%s\n", config->theme.text_color);
+    if (!has_summaries) return;
+
+    // Render summary separator
+    render_header_separator(config);
+    
+    // Render summary row
+    render_summary_row(config, data->summaries, 0);
+}
+
+/*
+ * Render the subtotals row of a group of rows, below a separator like the summaries row
+ * A table can have a group for every row, so the formatted text is released straight away
+ */
+void render_subtotals(TableConfig *config, SummaryStats *group_summaries) {
+    ArenaMark mark = arena_mark();
+    render_header_separator(config);
+    render_summary_row(config, group_summaries, 1);
+    arena_reset(mark);
 }
@@ -13,4 +13,9 @@
  */
 void render_summaries(TableConfig *config, TableData *data);
 
+/*
+ * Render the subtotals row of a group of rows, one SummaryStats per column
+ */
+void render_subtotals(TableConfig *config, SummaryStats *group_summaries);
+
 #endif /* TABLES_RENDER_SUMMARIES_H */
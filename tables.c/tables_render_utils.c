@@ -7,16 +7,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <wchar.h>
 #include <locale.h>
+#include <ctype.h>
 #include "tables_render_utils.h"
+#include "tables_arena.h"
+#include "tables_commands.h"
 
 /*
- * Helper function to duplicate a string, returning NULL if input is NULL
+ * Helper function to duplicate a string into the arena, returning NULL if input is NULL
  */
 char *strdup_safe(const char *str) {
     if (str == NULL) return NULL;
-    char *dup = strdup(str);
+    char *dup = arena_strdup(str);
     if (dup == NULL) {
         fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
         return NULL;
@@ -24,109 +28,128 @@ char *strdup_safe(const char *str) {
     return dup;
 }
 
+/*
+ * Helper function to return the display width of a UTF-8 sequence of a lead byte and extra bytes
+ * The ranges are those of the Bash version: of its CJK (4352-55215) and emoji (127744-129535)
+ * ranges none can be encoded in the sequence lengths they are checked for, which leaves the
+ * Miscellaneous Symbols (9728-9983) and every 4-byte sequence as two columns wide
+ */
+static int sequence_width(const unsigned char *bytes, int extra) {
+    if (extra == 2) {
+        int codepoint = ((bytes[0] & 0x0F) << 12) | ((bytes[1] & 0x3F) << 6) | (bytes[2] & 0x3F);
+        return (codepoint >= 9728 && codepoint <= 9983) ? 2 : 1;
+    }
+    return extra == 3 ? 2 : 1;
+}
+
+/*
+ * Helper function to return the number of bytes following a UTF-8 lead byte, the way the
+ * Bash version reads them: continuation bytes are not checked
+ */
+static int sequence_extra_bytes(unsigned char byte) {
+    if (byte < 128) return 0;
+    if (byte < 224) return 1;
+    if (byte < 240) return 2;
+    return 3;
+}
+
+/*
+ * Helper function to measure bytes left over at the end of the text
+ * A lead byte without all of its extra bytes is one column, and the bytes after it are read again
+ */
+static int trailing_width(const unsigned char *bytes, int count) {
+    int width = 0;
+    int i = 0;
+    while (i < count) {
+        int extra = sequence_extra_bytes(bytes[i]);
+        if (i + extra < count) {
+            width += sequence_width(bytes + i, extra);
+            i += extra + 1;
+        } else {
+            width++;
+            i++;
+        }
+    }
+    return width;
+}
+
 /*
  * Calculate display width of text, accounting for ANSI escape codes (which don't take up visible space)
- * This implementation matches the Bash version's logic exactly
  */
 int get_display_width(const char *text) {
-    if (text == NULL || strlen(text) == 0) return 0;
+    if (text == NULL) return 0;
+    return get_display_width_n(text, strlen(text));
+}
 
-    // First, remove ANSI escape codes
-    char *clean_text = malloc(strlen(text) + 1);
-    if (!clean_text) return 0;
+/*
+ * Calculate display width of the first length bytes of text, as if they were the whole string
+ * This implementation matches the Bash version's logic exactly: escapes run from ESC to the next 'm',
+ * and UTF-8 sequences are decoded from the text with the escapes already removed.
+ * The text is scanned once without allocating, eight bytes at a time while they hold plain ASCII.
+ */
+int get_display_width_n(const char *text, size_t length) {
+    const uint64_t high_bits = 0x8080808080808080ULL;
+    const uint64_t low_bits = 0x0101010101010101ULL;
+    const uint64_t escapes = 0x1B1B1B1B1B1B1B1BULL;
+    const unsigned char *p = (const unsigned char *)text;
+    const unsigned char *end = p + length;
+    int width = 0;
 
-    int in_ansi = 0;
-    int j = 0;
-    for (const char *p = text; *p; p++) {
-        if (*p == '\033') {
-            in_ansi = 1;
+    while (p < end) {
+        // Count words without a high bit or ESC byte as eight columns
+        while (end - p >= 8) {
+            uint64_t word;
+            memcpy(&word, p, sizeof(word));
+            uint64_t esc = word ^ escapes;
+            if ((word | ((esc - low_bits) & ~esc)) & high_bits) break;
+            width += 8;
+            p += 8;
         }
-        if (!in_ansi) {
-            clean_text[j++] = *p;
+        if (p == end) break;
+
+        unsigned char byte = *p;
+        if (byte == '\033') {
+            // Skip the escape up to and including the next 'm'
+            const unsigned char *m = memchr(p + 1, 'm', (size_t)(end - p - 1));
+            p = m ? m + 1 : end;
+            continue;
         }
-        if (in_ansi && *p == 'm') {
-            in_ansi = 0;
+        int extra = sequence_extra_bytes(byte);
+        if (extra == 0) {
+            width++;
+            p++;
+            continue;
         }
-    }
-    clean_text[j] = '\0';
 
-    // Check if it's pure ASCII first (optimization from Bash version)
-    int is_ascii = 1;
-    for (int i = 0; clean_text[i]; i++) {
-        if ((unsigned char)clean_text[i] > 127) {
-            is_ascii = 0;
-            break;
+        // Decode the sequence in place unless an escape or the end of the text interrupts it
+        int complete = (end - p > extra);
+        for (int k = 1; complete && k <= extra; k++) {
+            if (p[k] == '\033') complete = 0;
+        }
+        if (complete) {
+            width += sequence_width(p, extra);
+            p += extra + 1;
+            continue;
         }
-    }
-    
-    if (is_ascii) {
-        int len = strlen(clean_text);
-        free(clean_text);
-        return len;
-    }
 
-    // Manual UTF-8 parsing to match Bash version exactly
-    int width = 0;
-    int len = strlen(clean_text);
-    int i = 0;
-    
-    while (i < len) {
-        unsigned char byte1 = (unsigned char)clean_text[i];
-        
-        if (byte1 < 128) {
-            // ASCII character
-            width++;
-            i++;
-        } else if (byte1 < 224) {
-            // 2-byte UTF-8 sequence
-            if (i + 1 < len) {
-                unsigned char byte2 = (unsigned char)clean_text[i + 1];
-                int codepoint = ((byte1 & 0x1F) << 6) | (byte2 & 0x3F);
-                
-                // CJK range from Bash version: 4352-55215 → width 2
-                if (codepoint >= 4352 && codepoint <= 55215) {
-                    width += 2;
-                } else {
-                    width++;
-                }
-                i += 2;
+        // Collect the sequence from the bytes around the escapes, as if they had been removed
+        unsigned char sequence[4];
+        int have = 0;
+        sequence[have++] = *p++;
+        while (have <= extra && p < end) {
+            if (*p == '\033') {
+                const unsigned char *m = memchr(p + 1, 'm', (size_t)(end - p - 1));
+                p = m ? m + 1 : end;
             } else {
-                width++;
-                i++;
-            }
-        } else if (byte1 < 240) {
-            // 3-byte UTF-8 sequence
-            if (i + 2 < len) {
-                unsigned char byte2 = (unsigned char)clean_text[i + 1];
-                unsigned char byte3 = (unsigned char)clean_text[i + 2];
-                int codepoint = ((byte1 & 0x0F) << 12) | ((byte2 & 0x3F) << 6) | (byte3 & 0x3F);
-                
-                // More precise emoji ranges - exclude single-width symbols like checkmarks
-                // Emoji ranges: 127744-129535 (main emoji block) and 9728-9983 (dingbats, excluding checkmarks)
-                if ((codepoint >= 127744 && codepoint <= 129535) ||
-                    (codepoint >= 9728 && codepoint <= 9983)) {
-                    width += 2;
-                } else {
-                    width++;
-                }
-                i += 3;
-            } else {
-                width++;
-                i++;
+                sequence[have++] = *p++;
             }
+        }
+        if (have == extra + 1) {
+            width += sequence_width(sequence, extra);
         } else {
-            // 4-byte UTF-8 sequence - assume width 2 like Bash version
-            if (i + 3 < len) {
-                width += 2;
-                i += 4;
-            } else {
-                width++;
-                i++;
-            }
+            width += trailing_width(sequence, have);
         }
     }
-
-    free(clean_text);
     return width;
 }
 
@@ -135,11 +158,11 @@ int get_display_width(const char *text) {
  */
 char *clip_text_to_width(const char *text, int max_width) {
     if (text == NULL || max_width <= 0) {
-        return strdup("");
+        return arena_strdup("");
     }
     
     if (get_display_width(text) <= max_width) {
-        return strdup(text);
+        return arena_strdup(text);
     }
     
     // We need to find the byte position where we reach max_width display characters
@@ -187,8 +210,8 @@ char *clip_text_to_width(const char *text, int max_width) {
         }
     }
     
-    char *result = malloc(byte_pos + 1);
-    if (!result) return strdup("");
+    char *result = arena_alloc(byte_pos + 1);
+    if (!result) return arena_strdup("");
     
     strncpy(result, text, byte_pos);
     result[byte_pos] = '\0';
@@ -197,381 +220,407 @@ char *clip_text_to_width(const char *text, int max_width) {
 }
 
 /*
- * Wrap text to a specified width, returning an array of lines
+ * Helper function to check that the width of words joined by spaces is the sum of their widths
+ * That holds unless an escape has no 'm' or holds a space, or a UTF-8 sequence is cut short by
+ * the end of the text, a space or an escape, which get_display_width() would read across
+ */
+static int widths_add_up(const char *text, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        unsigned char byte = (unsigned char)text[i];
+        if (byte == '\033') {
+            size_t j = i + 1;
+            while (j < length && text[j] != 'm') {
+                if (text[j] == ' ') return 0;
+                j++;
+            }
+            if (j == length) return 0;
+            i = j + 1;
+            continue;
+        }
+        int extra = sequence_extra_bytes(byte);
+        if (i + extra >= length) return 0;
+        for (int k = 1; k <= extra; k++) {
+            if (text[i + k] == '\033' || text[i + k] == ' ') return 0;
+        }
+        i += extra + 1;
+    }
+    return 1;
+}
+
+/*
+ * Helper function to add a line to the lines of a wrapped text, growing the array as needed
+ */
+static TextSpan *add_span(TextSpan *lines, int *line_count, int *capacity, const char *text, int length, int width) {
+    if (*line_count >= *capacity) {
+        TextSpan *new_lines = arena_realloc(lines, *capacity * sizeof(TextSpan), *capacity * 2 * sizeof(TextSpan));
+        if (new_lines == NULL) return NULL;
+        lines = new_lines;
+        *capacity *= 2;
+    }
+    lines[*line_count].text = text;
+    lines[*line_count].length = length;
+    lines[*line_count].width = width;
+    (*line_count)++;
+    return lines;
+}
+
+/*
+ * Helper function to return the single empty line of an empty text
+ */
+static TextSpan *empty_span(int *line_count) {
+    TextSpan *lines = arena_alloc(sizeof(TextSpan));
+    if (lines == NULL) return NULL;
+    lines[0].text = "";
+    lines[0].length = 0;
+    lines[0].width = 0;
+    *line_count = 1;
+    return lines;
+}
+
+/*
+ * Wrap text to a specified width, returning an array of lines pointing into the text
  * Handles ANSI escape codes by ignoring them in width calculations
- * Mimics Bash script behavior by building lines word by word
+ * Mimics Bash script behavior by building lines word by word, with the words of a line joined by
+ * single spaces. A line whose words were further apart is copied, all other lines are slices of
+ * the text, so wrapping needs no copies or rescans of the lines built so far
  */
-char **wrap_text(const char *text, int width, int *line_count) {
-    extern int debug_mode;
-    if (text == NULL || strlen(text) == 0 || width <= 0) {
-        *line_count = 1;
-        char **lines = malloc(sizeof(char *));
-        if (lines == NULL) return NULL;
-        lines[0] = strdup("");
-        if (debug_mode) {
+TextSpan *wrap_text(const char *text, int width, int *line_count) {
+    extern int tables_debug_mode;
+    if (text == NULL || text[0] == '\0' || width <= 0) {
+        if (tables_debug_mode) {
             fprintf(stderr, "Debug: wrap_text empty or invalid input, returning single empty line\n");
         }
-        return lines;
+        return empty_span(line_count);
     }
 
     int text_len = strlen(text);
-    int lines_capacity = 10;
-    char **lines = malloc(lines_capacity * sizeof(char *));
+    int add_up = widths_add_up(text, text_len);
+    int capacity = 10;
+    TextSpan *lines = arena_alloc(capacity * sizeof(TextSpan));
+    char *copies = NULL;        // Lines whose words were further apart than one space, one after another
+    int copies_used = 0;
     if (lines == NULL) return NULL;
     *line_count = 0;
-    char *current_line = malloc(text_len + 1);
-    if (current_line == NULL) {
-        free(lines);
-        return NULL;
-    }
-    if (debug_mode) {
-        fprintf(stderr, "Debug: wrap_text allocated initial memory for lines and current_line\n");
-    }
-    current_line[0] = '\0';
-    int line_pos = 0;
-    char *current_word = malloc(text_len + 1);
-    if (current_word == NULL) {
-        free(current_line);
-        free(lines);
-        return NULL;
-    }
-    int word_pos = 0;
+
+    const char *line = NULL;    // Start of the current line
+    int line_length = 0;
+    int line_width = 0;
+    int line_copied = 0;        // Flag if the current line is being built in copies
+    int word_start = -1;
     int in_ansi = 0;
 
     for (int i = 0; i <= text_len; i++) {
         char c = text[i];
         if (c == '\033') {
             in_ansi = 1;
-            if (word_pos < text_len) current_word[word_pos++] = c;
         } else if (in_ansi && c == 'm') {
             in_ansi = 0;
-            if (word_pos < text_len) current_word[word_pos++] = c;
         } else if (c == ' ' || c == '\0') {
-            if (word_pos > 0) {
-                current_word[word_pos] = '\0';
-                int word_width = get_display_width(current_word);
-                int line_width = get_display_width(current_line);
+            if (word_start >= 0) {
+                const char *word = text + word_start;
+                int word_length = i - word_start;
+                int word_width = get_display_width_n(word, word_length);
                 if (line_width == 0) {
-                    strcpy(current_line, current_word);
-                    line_pos = strlen(current_word);
+                    line = word;
+                    line_length = word_length;
+                    line_width = word_width;
+                    line_copied = 0;
                 } else if (line_width + word_width + 1 <= width) {
-                    strcat(current_line, " ");
-                    strcat(current_line, current_word);
-                    line_pos = strlen(current_line);
-                } else {
-                    if (*line_count >= lines_capacity) {
-                        lines_capacity *= 2;
-                        char **new_lines = realloc(lines, lines_capacity * sizeof(char *));
-                        if (new_lines == NULL) {
-                            free(current_word);
-                            free(current_line);
-                            free_wrapped_text(lines, *line_count);
-                            return NULL;
+                    if (!line_copied && word == line + line_length + 1) {
+                        line_length += word_length + 1;
+                    } else {
+                        if (copies == NULL) {
+                            copies = arena_alloc(text_len + 1);
+                            if (copies == NULL) return NULL;
                         }
-                        lines = new_lines;
-                    }
-                    lines[*line_count] = strdup(current_line);
-                    if (lines[*line_count] == NULL) {
-                        free(current_word);
-                        free(current_line);
-                        free_wrapped_text(lines, *line_count);
-                        return NULL;
+                        if (!line_copied) {
+                            memmove(copies + copies_used, line, line_length);
+                            line = copies + copies_used;
+                            line_copied = 1;
+                        }
+                        copies[copies_used + line_length] = ' ';
+                        memcpy(copies + copies_used + line_length + 1, word, word_length);
+                        line_length += word_length + 1;
                     }
-                    (*line_count)++;
-                    strcpy(current_line, current_word);
-                    line_pos = strlen(current_word);
+                    line_width = add_up ? line_width + 1 + word_width : get_display_width_n(line, line_length);
+                } else {
+                    lines = add_span(lines, line_count, &capacity, line, line_length, line_width);
+                    if (lines == NULL) return NULL;
+                    if (line_copied) copies_used += line_length;
+                    line = word;
+                    line_length = word_length;
+                    line_width = word_width;
+                    line_copied = 0;
                 }
-                word_pos = 0;
+                word_start = -1;
             }
-        } else {
-            if (word_pos < text_len) current_word[word_pos++] = c;
+            continue;
         }
+        if (word_start < 0) word_start = i;
     }
 
-    if (line_pos > 0) {
-        if (*line_count >= lines_capacity) {
-            lines_capacity *= 2;
-            char **new_lines = realloc(lines, lines_capacity * sizeof(char *));
-            if (new_lines == NULL) {
-                free(current_word);
-                free(current_line);
-                free_wrapped_text(lines, *line_count);
-                return NULL;
-            }
-            lines = new_lines;
-        }
-        lines[*line_count] = strdup(current_line);
-        if (lines[*line_count] == NULL) {
-            free(current_word);
-            free(current_line);
-            free_wrapped_text(lines, *line_count);
-            return NULL;
-        }
-        (*line_count)++;
+    if (line_length > 0) {
+        lines = add_span(lines, line_count, &capacity, line, line_length, line_width);
+        if (lines == NULL) return NULL;
     }
 
-    free(current_word);
-    free(current_line);
-    if (debug_mode) {
+    if (tables_debug_mode) {
         fprintf(stderr, "Debug: wrap_text completed, returning %d lines\n", *line_count);
     }
     return lines;
 }
 
 /*
- * Wrap text based on a delimiter, returning an array of lines
+ * Wrap text based on a delimiter, returning an array of lines pointing into the text
  * Handles ANSI escape codes by ignoring them in width calculations
- * Splits on every delimiter occurrence to match Bash behavior
+ * Splits on every delimiter occurrence to match Bash behavior, dropping empty lines
  */
-char **wrap_text_delimiter(const char *text, int width, const char *delimiter, int *line_count) {
-    if (text == NULL || strlen(text) == 0 || width <= 0) {
-        *line_count = 1;
-        char **lines = malloc(sizeof(char *));
-        if (lines == NULL) return NULL;
-        lines[0] = strdup("");
-        return lines;
+TextSpan *wrap_text_delimiter(const char *text, int width, const char *delimiter, int *line_count) {
+    if (text == NULL || text[0] == '\0' || width <= 0) {
+        return empty_span(line_count);
     }
 
     int text_len = strlen(text);
     int delimiter_len = strlen(delimiter);
-    int lines_capacity = 10;
-    char **lines = malloc(lines_capacity * sizeof(char *));
+    int capacity = 10;
+    TextSpan *lines = arena_alloc(capacity * sizeof(TextSpan));
     if (lines == NULL) return NULL;
     *line_count = 0;
     int start = 0;
-    char *current_line = malloc(text_len + 1);
-    if (current_line == NULL) {
-        free(lines);
-        return NULL;
-    }
 
     for (int i = 0; i <= text_len; i++) {
         char c = text[i];
         // Check for delimiter or end of text
-        if (((i + delimiter_len <= text_len) && (strncmp(text + i, delimiter, delimiter_len) == 0)) || c == '\0') {
-            if (*line_count >= lines_capacity) {
-                lines_capacity *= 2;
-                char **new_lines = realloc(lines, lines_capacity * sizeof(char *));
-                if (new_lines == NULL) {
-                    free(current_line);
-                    free_wrapped_text(lines, *line_count);
-                    return NULL;
-                }
-                lines = new_lines;
-            }
-            // Copy substring from start to i (excluding delimiter)
+        if (c == '\0' || (c == delimiter[0] && i + delimiter_len <= text_len && strncmp(text + i, delimiter, delimiter_len) == 0)) {
             int len = i - start;
             if (len > 0) {
-                strncpy(current_line, text + start, len);
-                current_line[len] = '\0';
-                lines[*line_count] = strdup(current_line);
-                if (lines[*line_count] == NULL) {
-                    free(current_line);
-                    free_wrapped_text(lines, *line_count);
-                    return NULL;
-                }
-                (*line_count)++;
+                lines = add_span(lines, line_count, &capacity, text + start, len, get_display_width_n(text + start, len));
+                if (lines == NULL) return NULL;
             }
             start = i + (c == '\0' ? 0 : delimiter_len);
         }
     }
-    free(current_line);
     return lines;
 }
 
+/* Structure for a string built from pieces, grown as they are appended */
+typedef struct {
+    char *text;             /* Text so far, NUL terminated, NULL once an allocation failed */
+    size_t length;          /* Length of text */
+    size_t capacity;        /* Bytes allocated for text */
+} DynamicText;
+
+/*
+ * Helper function to append length bytes of text to a dynamic string
+ */
+static void append_dynamic_text(DynamicText *out, const char *text, size_t length) {
+    if (out->text == NULL) return;
+    if (out->length + length + 1 > out->capacity) {
+        size_t capacity = (out->length + length + 1) * 2;
+        char *grown = realloc(out->text, capacity);
+        if (grown == NULL) {
+            free(out->text);
+            out->text = NULL;
+            return;
+        }
+        out->text = grown;
+        out->capacity = capacity;
+    }
+    memcpy(out->text + out->length, text, length);
+    out->length += length;
+    out->text[out->length] = '\0';
+}
+
 /*
- * Free memory allocated for wrapped text lines
+ * Helper function to append length bytes of layout text, replacing each ${name} with the value of the variable
+ * Names are letters, digits and underscores. Anything else after a $ is kept as it is
  */
-void free_wrapped_text(char **lines, int line_count) {
-    if (lines) {
-        for (int i = 0; i < line_count; i++) {
-            if (lines[i]) free(lines[i]);
+static void append_expanded_text(DynamicText *out, const char *text, size_t length) {
+    const char *p = text;
+    const char *end = text + length;
+    const char *literal = p;    // Start of the text not yet appended
+    while (p + 1 < end) {
+        if (p[0] != '$' || p[1] != '{') {
+            p++;
+            continue;
+        }
+        size_t name_length = 0;
+        while (p + 2 + name_length < end && (isalnum((unsigned char)p[2 + name_length]) || p[2 + name_length] == '_')) name_length++;
+        if (name_length == 0 || name_length >= 128 || p + 2 + name_length >= end || p[2 + name_length] != '}') {
+            p++;
+            continue;
+        }
+        char name[128];
+        memcpy(name, p + 2, name_length);
+        name[name_length] = '\0';
+        const char *value = commands_variable(name);
+        if (value == NULL) {
+            p++;
+            continue;
         }
-        free(lines);
+        append_dynamic_text(out, literal, (size_t)(p - literal));
+        append_dynamic_text(out, value, strlen(value));
+        p += name_length + 3;
+        literal = p;
     }
+    append_dynamic_text(out, literal, (size_t)(end - literal));
 }
 
 /*
- * Process a string to evaluate dynamic commands within $() and return the result
- * Forks a process to execute the command and captures its output
+ * Process a string to evaluate dynamic commands within $() and ${} variables and return the result
+ * Command output is collected from tables_commands.c and copied as it is. Variables are only
+ * replaced in the text of the layout around the commands, so neither a value holding $( nor
+ * command output holding ${ is evaluated again
  */
 char *evaluate_dynamic_string(const char *input) {
     if (input == NULL || strlen(input) == 0) {
-        return strdup("");
+        return arena_strdup("");
+    }
+    if (strstr(input, "$(") == NULL && strstr(input, "${") == NULL) {
+        return arena_strdup(input);
     }
 
-    char *result = strdup(input);
-    if (result == NULL) {
+    DynamicText out = { malloc(strlen(input) + 256), 0, strlen(input) + 256 };
+    if (out.text == NULL) {
         fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
         return NULL;
     }
+    out.text[0] = '\0';
 
-    char *current = result;
-    char *new_result = NULL;
-    size_t result_len = strlen(result);
-    size_t new_len = 0;
-
-    while (current && *current) {
-        char *start = strstr(current, "$(");
-        if (start == NULL) {
-            break;
-        }
-
-        char *end = strchr(start + 2, ')');
+    const char *current = input;
+    while (*current) {
+        const char *start = strstr(current, "$(");
+        const char *end = start ? strchr(start + 2, ')') : NULL;
         if (end == NULL) {
             break;
         }
+        append_expanded_text(&out, current, (size_t)(start - current));
 
         size_t cmd_len = end - start - 2;
-        char *cmd = malloc(cmd_len + 1);
+        char *cmd = arena_alloc(cmd_len + 1);
         if (cmd == NULL) {
-            free(result);
+            free(out.text);
             return NULL;
         }
-        strncpy(cmd, start + 2, cmd_len);
+        memcpy(cmd, start + 2, cmd_len);
         cmd[cmd_len] = '\0';
 
-        // Execute command and capture output
-        char *cmd_output = NULL;
-        FILE *fp = popen(cmd, "r");
-        if (fp) {
-            char buffer[1024];
-            size_t output_len = 0;
-            size_t capacity = 1024;
-            cmd_output = malloc(capacity);
-            if (cmd_output) {
-                while (fgets(buffer, sizeof(buffer), fp)) {
-                    size_t len = strlen(buffer);
-                    if (output_len + len >= capacity) {
-                        capacity *= 2;
-                        char *new_output = realloc(cmd_output, capacity);
-                        if (new_output == NULL) {
-                            free(cmd_output);
-                            cmd_output = NULL;
-                            break;
-                        }
-                        cmd_output = new_output;
-                    }
-                    strcpy(cmd_output + output_len, buffer);
-                    output_len += len;
-                }
-                // Remove trailing newline if present
-                if (output_len > 0 && cmd_output[output_len - 1] == '\n') {
-                    cmd_output[output_len - 1] = '\0';
-                }
-            }
-            pclose(fp);
+        // Output of each distinct command is produced once per run and reused
+        const char *cmd_output = commands_output(cmd);
+        if (cmd_output) {
+            append_dynamic_text(&out, cmd_output, strlen(cmd_output));
         }
+        current = end + 1;
+    }
+    append_expanded_text(&out, current, strlen(current));
 
-        free(cmd);
-
-        // Calculate lengths
-        size_t prefix_len = start - result;
-        size_t suffix_len = result_len - (end - result + 1);
-        size_t output_len = (cmd_output ? strlen(cmd_output) : 0);
-        new_len = prefix_len + output_len + suffix_len + 1;
+    if (out.text == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
+        return NULL;
+    }
+    char *result = arena_strdup(out.text);
+    free(out.text);
+    return result;
+}
 
-        // Build new result
-        new_result = malloc(new_len);
-        if (new_result == NULL) {
-            free(result);
-            free(cmd_output);
-            return NULL;
-        }
+/* Structure for a color placeholder and the ANSI escape code it stands for */
+typedef struct {
+    const char *tag;        /* Placeholder name between the braces */
+    size_t tag_length;
+    const char *code;       /* ANSI escape code */
+    size_t code_length;
+} ColorPlaceholder;
+
+#define COLOR_PLACEHOLDER(tag, code) { tag, sizeof(tag) - 1, code, sizeof(code) - 1 }
+
+/* Placeholders grouped by first letter, see find_color_placeholder() */
+static const ColorPlaceholder color_placeholders[] = {
+    COLOR_PLACEHOLDER("RED", "\033[0;31m"),
+    COLOR_PLACEHOLDER("RESET", "\033[0m"),
+    COLOR_PLACEHOLDER("BLUE", "\033[0;34m"),
+    COLOR_PLACEHOLDER("BOLD", "\033[1m"),
+    COLOR_PLACEHOLDER("GREEN", "\033[0;32m"),
+    COLOR_PLACEHOLDER("YELLOW", "\033[0;33m"),
+    COLOR_PLACEHOLDER("CYAN", "\033[0;36m"),
+    COLOR_PLACEHOLDER("MAGENTA", "\033[0;35m"),
+    COLOR_PLACEHOLDER("WHITE", "\033[1;37m"),
+    COLOR_PLACEHOLDER("DIM", "\033[2m"),
+    COLOR_PLACEHOLDER("UNDERLINE", "\033[4m"),
+    COLOR_PLACEHOLDER("NC", "\033[0m")
+};
+
+/* Longest ANSI code minus the shortest placeholder with its braces, the most a replacement can grow */
+#define COLOR_PLACEHOLDER_GROWTH 3
 
-        if (prefix_len > 0) {
-            strncpy(new_result, result, prefix_len);
-        }
-        if (cmd_output && output_len > 0) {
-            strcpy(new_result + prefix_len, cmd_output);
-        }
-        if (suffix_len > 0) {
-            strcpy(new_result + prefix_len + output_len, end + 1);
+/*
+ * Helper function to find the placeholder starting at text, which points just after a '{'
+ * The first letter selects the one or two placeholders that can match
+ */
+static const ColorPlaceholder *find_color_placeholder(const char *text) {
+    int first, count = 1;
+    switch (text[0]) {
+        case 'R': first = 0; count = 2; break;
+        case 'B': first = 2; count = 2; break;
+        case 'G': first = 4; break;
+        case 'Y': first = 5; break;
+        case 'C': first = 6; break;
+        case 'M': first = 7; break;
+        case 'W': first = 8; break;
+        case 'D': first = 9; break;
+        case 'U': first = 10; break;
+        case 'N': first = 11; break;
+        default: return NULL;
+    }
+    for (int i = first; i < first + count; i++) {
+        const ColorPlaceholder *placeholder = &color_placeholders[i];
+        if (strncmp(text, placeholder->tag, placeholder->tag_length) == 0 && text[placeholder->tag_length] == '}') {
+            return placeholder;
         }
-        new_result[new_len - 1] = '\0';
-
-        free(result);
-        free(cmd_output);
-        result = new_result;
-        result_len = new_len - 1;
-        current = result + prefix_len + output_len;
     }
-
-    return result;
+    return NULL;
 }
 
 /*
  * Replace color placeholders like {RED}, {NC}, etc., with ANSI escape codes
+ * The text is scanned once from left to right, stopping only at '{' characters, and the result
+ * is written into a single allocation. An ANSI code never forms a placeholder with the text
+ * around it, so this gives the same result as replacing each placeholder in turn.
  */
 char *replace_color_placeholders(const char *input) {
-    if (input == NULL || strlen(input) == 0) {
-        return strdup("");
-    }
-
-    // Define color mappings
-    const char *color_map[][2] = {
-        {"{RED}", "\033[0;31m"},
-        {"{BLUE}", "\033[0;34m"},
-        {"{GREEN}", "\033[0;32m"},
-        {"{YELLOW}", "\033[0;33m"},
-        {"{CYAN}", "\033[0;36m"},
-        {"{MAGENTA}", "\033[0;35m"},
-        {"{WHITE}", "\033[1;37m"},
-        {"{BOLD}", "\033[1m"},
-        {"{DIM}", "\033[2m"},
-        {"{UNDERLINE}", "\033[4m"},
-        {"{NC}", "\033[0m"},
-        {"{RESET}", "\033[0m"}
-    };
-    const int color_map_size = sizeof(color_map) / sizeof(color_map[0]);
-
-    char *result = strdup(input);
+    if (input == NULL || *input == '\0') {
+        return arena_strdup("");
+    }
+
+    const char *brace = strchr(input, '{');
+    if (brace == NULL) {
+        return arena_strdup(input);
+    }
+
+    // Each placeholder is at least 4 characters long, which bounds the growth of the text
+    size_t length = strlen(input);
+    char *result = arena_alloc(length + (length / 4 + 1) * COLOR_PLACEHOLDER_GROWTH + 1);
     if (result == NULL) {
         fprintf(stderr, "Error: Memory allocation failed for string duplication\n");
         return NULL;
     }
 
-    for (int i = 0; i < color_map_size; i++) {
-        const char *placeholder = color_map[i][0];
-        const char *ansi_code = color_map[i][1];
-        char *current = result;
-        char *new_result = NULL;
-        size_t result_len = strlen(result);
-        size_t placeholder_len = strlen(placeholder);
-        size_t ansi_len = strlen(ansi_code);
-
-        while (current && *current) {
-            char *match = strstr(current, placeholder);
-            if (match == NULL) {
-                break;
-            }
-
-            size_t prefix_len = match - result;
-            size_t suffix_len = result_len - prefix_len - placeholder_len;
-            size_t new_len = prefix_len + ansi_len + suffix_len + 1;
-
-            new_result = malloc(new_len);
-            if (new_result == NULL) {
-                free(result);
-                return NULL;
-            }
-
-            if (prefix_len > 0) {
-                strncpy(new_result, result, prefix_len);
-            }
-            strcpy(new_result + prefix_len, ansi_code);
-            if (suffix_len > 0) {
-                strcpy(new_result + prefix_len + ansi_len, match + placeholder_len);
-            }
-            new_result[new_len - 1] = '\0';
-
-            free(result);
-            result = new_result;
-            result_len = new_len - 1;
-            current = result + prefix_len + ansi_len;
+    char *out = result;
+    const char *p = input;
+    while (brace != NULL) {
+        const ColorPlaceholder *placeholder = find_color_placeholder(brace + 1);
+        size_t copied = (size_t)(brace - p) + (placeholder ? 0 : 1);
+        memcpy(out, p, copied);
+        out += copied;
+        p += copied;
+        if (placeholder) {
+            memcpy(out, placeholder->code, placeholder->code_length);
+            out += placeholder->code_length;
+            p += placeholder->tag_length + 2;
         }
+        brace = strchr(p, '{');
     }
-
+    strcpy(out, p);
     return result;
 }
 
@@ -580,12 +629,12 @@ char *replace_color_placeholders(const char *input) {
  */
 char *clip_text(const char *text, int width, Position justification) {
     if (text == NULL) {
-        return strdup("");
+        return arena_strdup("");
     }
 
     int display_width = get_display_width(text);
     if (display_width <= width) {
-        return strdup(text);
+        return arena_strdup(text);
     }
 
     if (justification == POSITION_CENTER) {
@@ -688,13 +737,13 @@ char *clip_text(const char *text, int width, Position justification) {
  */
 char *clip_text_with_colors(const char *text, int width, Position justification) {
     if (text == NULL) {
-        return strdup("");
+        return arena_strdup("");
     }
 
     // First, process color placeholders to convert them to ANSI codes
     char *colored_text = replace_color_placeholders(text);
     if (colored_text == NULL) {
-        return strdup("");
+        return arena_strdup("");
     }
 
     // Check if clipping is needed
@@ -705,7 +754,6 @@ char *clip_text_with_colors(const char *text, int width, Position justification)
 
     // Clip the colored text using existing clipping function
     char *clipped_text = clip_text(colored_text, width, justification);
-    free(colored_text);
     
     return clipped_text;
 }
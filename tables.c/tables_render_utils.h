@@ -5,37 +5,46 @@
 #ifndef TABLES_RENDER_UTILS_H
 #define TABLES_RENDER_UTILS_H
 
+#include <stddef.h>
 #include "tables_config.h"
 
 /*
- * Helper function to duplicate a string, returning NULL if input is NULL
+ * Helper function to duplicate a string into the arena, returning NULL if input is NULL
+ * Strings returned by the functions below are allocated from the arena and are not freed individually
  */
 char *strdup_safe(const char *str);
 
+/* Structure for one line of wrapped text, pointing into the text it was wrapped from */
+typedef struct {
+    const char *text;       /* Start of the line, not NUL-terminated */
+    int length;             /* Length of the line in bytes */
+    int width;              /* Display width of the line */
+} TextSpan;
+
 /*
  * Calculate display width of text, accounting for ANSI escape codes
  */
 int get_display_width(const char *text);
 
 /*
- * Clip text to a maximum display width, preserving ANSI codes and handling Unicode properly
+ * Calculate display width of the first length bytes of text
  */
-char *clip_text_to_width(const char *text, int max_width);
+int get_display_width_n(const char *text, size_t length);
 
 /*
- * Wrap text to a specified width, returning an array of lines
+ * Clip text to a maximum display width, preserving ANSI codes and handling Unicode properly
  */
-char **wrap_text(const char *text, int width, int *line_count);
+char *clip_text_to_width(const char *text, int max_width);
 
 /*
- * Wrap text based on a delimiter, returning an array of lines
+ * Wrap text to a specified width, returning an array of lines pointing into the text
  */
-char **wrap_text_delimiter(const char *text, int width, const char *delimiter, int *line_count);
+TextSpan *wrap_text(const char *text, int width, int *line_count);
 
 /*
- * Free memory allocated for wrapped text lines
+ * Wrap text based on a delimiter, returning an array of lines pointing into the text
  */
-void free_wrapped_text(char **lines, int line_count);
+TextSpan *wrap_text_delimiter(const char *text, int width, const char *delimiter, int *line_count);
 
 /*
  * Process a string to evaluate dynamic commands within $() and return the result
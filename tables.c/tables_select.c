@@ -0,0 +1,322 @@
+/*
+ * tables_select.c - Implementation of showing only the first rows of a table
+ * Each row read is compared with the last in sort order of the rows kept so far, and replaces it
+ * when ranked before it. Rows of equal rank keep their input order, so the rows kept are exactly
+ * those a full sort would put first. Rows that are not kept are only added to the summaries.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "tables_select.h"
+#include "tables_arena.h"
+
+extern int tables_debug_mode;
+
+static long limit_override = -1;    /* Rows given to --limit, -1 to use the layout's limit */
+
+/* Structure holding a kept row, with its values copied out of the arena */
+typedef struct {
+    char *block;            /* Array of value pointers followed by the value strings */
+    size_t capacity;        /* Bytes allocated for block */
+    DataRow row;            /* Row pointing into block, its index is its slot of the column store */
+    long sequence;          /* Position of the row in the data */
+} KeptRow;
+
+/* Structure holding the rows kept while the data is read */
+typedef struct {
+    const SortRule *rules;  /* Sort rules in priority order */
+    int rule_count;         /* Number of sort rules */
+    const TableData *data;  /* Table whose column store holds the parsed values of the rows */
+    KeptRow *slots;         /* Kept rows, one per row of the column store */
+    int slot_count;         /* Number of slots allocated */
+    int *heap;              /* Slots of the kept rows, with the one ranked last on top */
+    int heap_size;          /* Number of kept rows */
+} Selection;
+
+/*
+ * Set the number of rows shown from --limit, overriding the layout, 0 showing all rows
+ */
+int select_set_limit(long rows) {
+    if (rows < 0 || rows > INT_MAX) {
+        fprintf(stderr, "Error: --limit needs a number of rows, 0 for all\n");
+        return 1;
+    }
+    limit_override = rows;
+    return 0;
+}
+
+/*
+ * Return the number of rows shown with a layout, 0 for all of them
+ */
+int select_row_limit(const TableConfig *config) {
+    return limit_override >= 0 ? (int)limit_override : config->limit;
+}
+
+/*
+ * Return 1 if the rows left out by the limit still have to be added to the summaries
+ * Without a summarized column the summaries are left to the rows shown, as they are only used to
+ * line up their decimals
+ */
+int select_summarizes_all(const TableConfig *config) {
+    if (!config->limit_summaries) return 0;
+    for (int j = 0; j < config->column_count; j++) {
+        if (config->columns[j].summary != SUMMARY_NONE) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Helper function to compare two rows by the sort rules and then by their position in the data
+ * Returns a positive number if row a is ranked after row b
+ */
+static int compare_ranks(const Selection *selection, const DataRow *a, long sequence_a, const DataRow *b, long sequence_b) {
+    int result = compare_row_values(selection->rules, selection->rule_count, selection->data, a, b);
+    if (result != 0) return result;
+    return (sequence_a > sequence_b) - (sequence_a < sequence_b);
+}
+
+/*
+ * Helper function to check whether the row of heap position a is ranked after that of position b
+ */
+static int heap_after(const Selection *selection, int a, int b) {
+    const KeptRow *row_a = &selection->slots[selection->heap[a]];
+    const KeptRow *row_b = &selection->slots[selection->heap[b]];
+    return compare_ranks(selection, &row_a->row, row_a->sequence, &row_b->row, row_b->sequence) > 0;
+}
+
+/*
+ * Helper function to swap two heap positions
+ */
+static void heap_swap(Selection *selection, int a, int b) {
+    int slot = selection->heap[a];
+    selection->heap[a] = selection->heap[b];
+    selection->heap[b] = slot;
+}
+
+/*
+ * Helper function to move a newly added row up the heap to its place
+ */
+static void heap_sift_up(Selection *selection, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!heap_after(selection, pos, parent)) break;
+        heap_swap(selection, pos, parent);
+        pos = parent;
+    }
+}
+
+/*
+ * Helper function to move a row that replaced the top of the heap down to its place
+ */
+static void heap_sift_down(Selection *selection, int pos) {
+    while (1) {
+        int last = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < selection->heap_size && heap_after(selection, left, last)) last = left;
+        if (right < selection->heap_size && heap_after(selection, right, last)) last = right;
+        if (last == pos) break;
+        heap_swap(selection, pos, last);
+        pos = last;
+    }
+}
+
+/*
+ * Helper function to copy the values of a row into the block of the slot keeping it
+ */
+static int keep_row_values(KeptRow *kept, const DataRow *row, int column_count) {
+    size_t size = column_count * sizeof(char *);
+    for (int j = 0; j < column_count; j++) {
+        if (row->values[j]) size += strlen(row->values[j]) + 1;
+    }
+    if (size > kept->capacity) {
+        size_t capacity = kept->capacity ? kept->capacity : 256;
+        while (capacity < size) capacity *= 2;
+        char *block = realloc(kept->block, capacity);
+        if (block == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for kept row\n");
+            return 1;
+        }
+        kept->block = block;
+        kept->capacity = capacity;
+    }
+
+    char **values = (char **)kept->block;
+    char *text = kept->block + column_count * sizeof(char *);
+    for (int j = 0; j < column_count; j++) {
+        if (row->values[j] == NULL) {
+            values[j] = NULL;
+            continue;
+        }
+        size_t length = strlen(row->values[j]) + 1;
+        memcpy(text, row->values[j], length);
+        values[j] = text;
+        text += length;
+    }
+    kept->row.values = values;
+    kept->row.index = row->index;
+    return 0;
+}
+
+/*
+ * Helper function to add slots for more kept rows, up to one more than the limit
+ */
+static int grow_selection(Selection *selection, TableConfig *config, TableData *data, int limit) {
+    long count = (long)selection->slot_count * 2;
+    if (count > (long)limit + 1) count = (long)limit + 1;
+    KeptRow *slots = realloc(selection->slots, count * sizeof(KeptRow));
+    if (slots) selection->slots = slots;
+    int *heap = realloc(selection->heap, count * sizeof(int));
+    if (heap) selection->heap = heap;
+    if (slots == NULL || heap == NULL) {
+        fprintf(stderr, "Error: Memory reallocation failed for kept rows\n");
+        return 1;
+    }
+    memset(&selection->slots[selection->slot_count], 0, (count - selection->slot_count) * sizeof(KeptRow));
+    selection->slot_count = (int)count;
+    return grow_column_store(config, data, (int)count);
+}
+
+/*
+ * Helper function to order kept rows by their position in the data
+ */
+static int compare_sequences(const void *a, const void *b) {
+    long sequence_a = (*(const KeptRow *const *)a)->sequence;
+    long sequence_b = (*(const KeptRow *const *)b)->sequence;
+    return (sequence_a > sequence_b) - (sequence_a < sequence_b);
+}
+
+/*
+ * Helper function to move the kept rows into the table in input order, with their values in the arena
+ */
+static int store_kept_rows(Selection *selection, TableConfig *config, TableData *data) {
+    int count = selection->heap_size;
+    KeptRow **order = malloc((count ? count : 1) * sizeof(KeptRow *));
+    data->rows = malloc((count ? count : 1) * sizeof(DataRow));
+    if (order == NULL || data->rows == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for data rows\n");
+        free(order);
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        order[i] = &selection->slots[selection->heap[i]];
+    }
+    qsort(order, count, sizeof(KeptRow *), compare_sequences);
+
+    for (int i = 0; i < count; i++) {
+        DataRow *row = &data->rows[i];
+        row->index = order[i]->row.index;
+        row->values = arena_alloc(config->column_count * sizeof(char *));
+        if (row->values == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed for row values\n");
+            free(order);
+            return 1;
+        }
+        for (int j = 0; j < config->column_count; j++) {
+            const char *value = order[i]->row.values[j];
+            row->values[j] = value ? arena_strdup(value) : NULL;
+        }
+    }
+    data->row_count = count;
+    free(order);
+    return 0;
+}
+
+/*
+ * Load the rows shown with the layout's limit, reading the rest of the data only for the summaries
+ * The rows come in input order, to be sorted like all the rows would be. Without sort rules or
+ * summaries of all rows, the data past the limit is not read at all. Returns 0 on success
+ */
+int select_rows(JsonArrayReader *reader, const char *source, TableConfig *config, TableData *data) {
+    int limit = select_row_limit(config);
+    int summarize_all = select_summarizes_all(config);
+    SortRule rules[MAX_COLUMNS];
+    Selection selection;
+    memset(&selection, 0, sizeof(Selection));
+    selection.rules = rules;
+    selection.rule_count = resolve_sort_rules(config, rules, 0); // sort_data() warns about the rest
+    selection.data = data;
+    selection.slot_count = (limit < SELECT_INITIAL_ROWS ? limit : SELECT_INITIAL_ROWS) + 1;
+
+    memset(data, 0, sizeof(TableData));
+    data->summaries = calloc(config->column_count, sizeof(SummaryStats));
+    selection.slots = calloc(selection.slot_count, sizeof(KeptRow));
+    selection.heap = malloc(selection.slot_count * sizeof(int));
+    if (data->summaries == NULL || selection.slots == NULL || selection.heap == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for kept rows\n");
+        free(selection.slots);
+        free(selection.heap);
+        free_table_data(data, config->column_count);
+        return 1;
+    }
+    initialize_summaries(config, data);
+    int status = init_column_store(config, data, selection.slot_count) != 0 ? -1 : 1;
+
+    long sequence = 0;
+    int scratch = 0; // Slot the next row is parsed into, the one ranked last is dropped into it
+    DataRow row;
+    while (status > 0) {
+        if (selection.heap_size == limit && selection.rule_count == 0 && !summarize_all) {
+            status = 0; // The first rows are all that is shown
+            break;
+        }
+        ArenaMark mark = arena_mark();
+        status = read_next_row(reader, config, &row);
+        if (status <= 0) {
+            arena_reset(mark);
+            break;
+        }
+        if (scratch == selection.slot_count && grow_selection(&selection, config, data, limit) != 0) {
+            status = -1;
+            break;
+        }
+        store_row_values(config, data, scratch, &row);
+        if (summarize_all) {
+            accumulate_row_summaries(config, data, &row);
+        }
+
+        if (selection.heap_size < limit) {
+            if (keep_row_values(&selection.slots[scratch], &row, config->column_count) != 0) status = -1;
+            selection.slots[scratch].sequence = sequence;
+            selection.heap[selection.heap_size++] = scratch;
+            heap_sift_up(&selection, selection.heap_size - 1);
+            scratch = selection.heap_size;
+        } else {
+            KeptRow *last = &selection.slots[selection.heap[0]];
+            if (compare_ranks(&selection, &row, sequence, &last->row, last->sequence) < 0) {
+                if (keep_row_values(&selection.slots[scratch], &row, config->column_count) != 0) status = -1;
+                selection.slots[scratch].sequence = sequence;
+                int dropped = selection.heap[0];
+                selection.heap[0] = scratch;
+                heap_sift_down(&selection, 0);
+                scratch = dropped;
+            }
+        }
+        arena_reset(mark);
+        sequence++;
+    }
+
+    if (status == 0) {
+        status = store_kept_rows(&selection, config, data);
+    } else {
+        status = 1;
+    }
+    for (int i = 0; i < selection.slot_count; i++) {
+        free(selection.slots[i].block);
+    }
+    free(selection.slots);
+    free(selection.heap);
+    if (status != 0) {
+        free_table_data(data, config->column_count);
+        return 1;
+    }
+
+    data->summarized = summarize_all;
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Kept %d of %ld rows read from %s for a limit of %d, summaries of %s rows\n",
+                data->row_count, sequence, source, limit, summarize_all ? "all" : "shown");
+    }
+    return 0;
+}
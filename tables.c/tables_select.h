@@ -0,0 +1,24 @@
+/*
+ * tables_select.h - Header file for showing only the first rows of a table
+ * A layout "limit" (or --limit) shows the first rows in sort order. Rows are read one at a time
+ * and only the rows that can still be shown are kept, in a heap ordered by the sort rules, so the
+ * memory used depends on the limit rather than on the size of the data.
+ */
+
+#ifndef TABLES_SELECT_H
+#define TABLES_SELECT_H
+
+#include "tables_config.h"
+#include "tables_data.h"
+#include "tables_reader.h"
+
+/* Number of rows the kept rows are first allocated for, growing up to the limit */
+#define SELECT_INITIAL_ROWS 1024
+
+/* Function prototypes */
+int select_set_limit(long rows);
+int select_row_limit(const TableConfig *config);
+int select_summarizes_all(const TableConfig *config);
+int select_rows(JsonArrayReader *reader, const char *source, TableConfig *config, TableData *data);
+
+#endif /* TABLES_SELECT_H */
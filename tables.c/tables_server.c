@@ -0,0 +1,515 @@
+/*
+ * tables_server.c - Implementation of rendering tables for clients of a Unix socket
+ * The server keeps parsed layouts with their themes, reading a layout file again only when it
+ * changes. Each connection is handed to a process forked as soon as it is accepted, which reads
+ * the request, so a slow or idle client never holds up the others. That process looks the layout
+ * up in the copy of the server's layouts it was forked with, and parses it itself when it is new
+ * or changed, telling the server through a pipe so the server parses it for later requests.
+ * At most SERVER_MAX_REQUESTS processes run at once, so idle connections cannot use up processes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "tables_server.h"
+#include "tables_config.h"
+#include "tables_themes.h"
+#include "tables_data.h"
+#include "tables_render.h"
+#include "tables_render_buffer.h"
+#include "tables_commands.h"
+#include "tables_input.h"
+
+extern int tables_debug_mode;
+
+/* Structure holding a layout parsed by the server */
+typedef struct {
+    char *filename;         /* Layout file as named by the client */
+    struct timespec mtime;  /* Modification time of the file when it was parsed */
+    off_t size;             /* Size of the file when it was parsed */
+    TableConfig config;     /* Parsed layout with its theme */
+} ServedLayout;
+
+static ServedLayout layouts[SERVER_MAX_LAYOUTS];
+static int layout_count = 0;
+static volatile sig_atomic_t stopping = 0;
+
+/*
+ * Helper function to stop accepting requests on SIGINT or SIGTERM
+ */
+static void stop_server(int signal_number) {
+    (void)signal_number;
+    stopping = 1;
+}
+
+/*
+ * Helper function to wake the server from poll() when a request process ends
+ */
+static void request_ended(int signal_number) {
+    (void)signal_number;
+}
+
+/*
+ * Helper function to reap the request processes that have ended, returning how many
+ */
+static int reap_requests(void) {
+    int reaped = 0;
+    while (waitpid(-1, NULL, WNOHANG) > 0) {
+        reaped++;
+    }
+    return reaped;
+}
+
+/*
+ * Helper function to return the current time in milliseconds
+ */
+static double now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+/*
+ * Helper function to write all of data to fd, returning 0 on success
+ */
+static int write_all(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return 1;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+/*
+ * Helper function to fill in the address of a Unix socket, returning 0 if the path fits
+ */
+static int socket_address(const char *socket_path, struct sockaddr_un *address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address->sun_path)) {
+        fprintf(stderr, "Error: Socket path %s is too long\n", socket_path);
+        return 1;
+    }
+    strcpy(address->sun_path, socket_path);
+    return 0;
+}
+
+/*
+ * Helper function to drop a parsed layout
+ */
+static void remove_layout(int index) {
+    free(layouts[index].filename);
+    free_table_config(&layouts[index].config);
+    layout_count--;
+    memmove(&layouts[index], &layouts[index + 1], (layout_count - index) * sizeof(ServedLayout));
+}
+
+/*
+ * Helper function to return the index of the layout parsed from a file, -1 if it is not parsed
+ * A layout parsed before the file last changed is dropped
+ */
+static int find_layout(const char *filename, const struct stat *info) {
+    for (int i = 0; i < layout_count; i++) {
+        if (strcmp(layouts[i].filename, filename) != 0) continue;
+        if (layouts[i].mtime.tv_sec == info->st_mtim.tv_sec && layouts[i].mtime.tv_nsec == info->st_mtim.tv_nsec &&
+            layouts[i].size == info->st_size) {
+            return i;
+        }
+        remove_layout(i);
+        break;
+    }
+    return -1;
+}
+
+/*
+ * Helper function to parse a layout file reported by a request process into the server's layouts
+ * Only regular files are parsed, so the server never waits on a named pipe
+ */
+static void add_layout(const char *filename) {
+    struct stat info;
+    if (stat(filename, &info) != 0 || !S_ISREG(info.st_mode) || find_layout(filename, &info) >= 0) return;
+
+    ServedLayout layout;
+    layout.filename = strdup(filename);
+    layout.mtime = info.st_mtim;
+    layout.size = info.st_size;
+    if (layout.filename == NULL || parse_layout_file(filename, &layout.config) != 0) {
+        free(layout.filename);
+        return;
+    }
+    get_theme(&layout.config);
+
+    if (layout_count == SERVER_MAX_LAYOUTS) {
+        remove_layout(0);
+    }
+    layouts[layout_count++] = layout;
+}
+
+/*
+ * Helper function to read the layout files reported by request processes and parse them
+ * Each is one line written at once, so lines are only split when the pipe holds many of them
+ */
+static void read_reported_layouts(int report_fd) {
+    static char pending[PATH_MAX * 2];
+    static size_t pending_length = 0;
+    for (;;) {
+        ssize_t count = read(report_fd, pending + pending_length, sizeof(pending) - pending_length);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return;
+        pending_length += (size_t)count;
+        char *line = pending;
+        char *newline;
+        while ((newline = memchr(line, '\n', pending_length - (size_t)(line - pending))) != NULL) {
+            *newline = '\0';
+            add_layout(line);
+            line = newline + 1;
+        }
+        pending_length -= (size_t)(line - pending);
+        memmove(pending, line, pending_length);
+        if (pending_length == sizeof(pending)) pending_length = 0; // A line too long for any path
+    }
+}
+
+/*
+ * Helper function to return the parsed layout of a file in a request process
+ * A layout the server has not parsed, or parsed before the file changed, is parsed here and
+ * reported to the server. Sets reused when the server's layout is used, returns NULL if the
+ * layout cannot be used
+ */
+static TableConfig *served_layout(const char *filename, int report_fd, int *reused, TableConfig *parsed) {
+    struct stat info;
+    *reused = 0;
+    if (stat(filename, &info) != 0) {
+        fprintf(stderr, "Error: Cannot open layout file %s\n", filename);
+        return NULL;
+    }
+    int index = find_layout(filename, &info);
+    if (index >= 0) {
+        *reused = 1;
+        return &layouts[index].config;
+    }
+
+    if (parse_layout_file(filename, parsed) != 0) {
+        return NULL;
+    }
+    get_theme(parsed);
+    size_t length = strlen(filename);
+    if (S_ISREG(info.st_mode) && length + 1 < PIPE_BUF) {
+        char line[PIPE_BUF];
+        memcpy(line, filename, length);
+        line[length] = '\n';
+        write_all(report_fd, line, length + 1);
+    }
+    return parsed;
+}
+
+/*
+ * Helper function to read the first line of a request, returning 0 on success
+ * Bytes are read one at a time so the data following the line is left for the renderer
+ */
+static int read_request_line(int fd, char *line, size_t size) {
+    size_t length = 0;
+    while (length + 1 < size) {
+        char c;
+        ssize_t count = read(fd, &c, 1);
+        if (count < 0 && errno == EINTR && !stopping) continue;
+        if (count <= 0) return 1;
+        if (c == '\n') {
+            if (length > 0 && line[length - 1] == '\r') length--;
+            line[length] = '\0';
+            return length == 0;
+        }
+        line[length++] = c;
+    }
+    return 1;
+}
+
+/*
+ * Helper function to render one request in the process forked for it, returning the exit status
+ * Messages are sent to the client along with the table, as a direct run would print them, except
+ * in debug mode where they all stay in the log of the server
+ */
+static int render_request(int fd, TableConfig *config, const char *layout_file) {
+    double start = now_ms();
+    if (!tables_debug_mode) {
+        dup2(fd, STDERR_FILENO);
+    }
+
+    // Commands of the title and footer run while the data is received
+    commands_start(config);
+
+    size_t capacity = 64 * 1024;
+    size_t length = 0;
+    char *buffer = malloc(capacity);
+    while (buffer) {
+        if (length == capacity) {
+            char *grown = realloc(buffer, capacity * 2);
+            if (grown == NULL) {
+                free(buffer);
+                buffer = NULL;
+                break;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+        ssize_t count = read(fd, buffer + length, capacity - length);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) {
+            fprintf(stderr, "Error: Reading data from client failed\n");
+            return 1;
+        }
+        if (count == 0) break;
+        length += (size_t)count;
+    }
+    if (buffer == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for request data\n");
+        return 1;
+    }
+
+    TableData data;
+    output_set_fd(fd);
+    int status = prepare_data_buffer(buffer, length, "request data", config, &data);
+    free(buffer);
+    if (status != 0) {
+        fprintf(stderr, "Error: Failed to load data from request\n");
+        return 1;
+    }
+    sort_data(config, &data);
+    process_data_rows(config, &data);
+    render_table(config, &data);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Request for %s with %d rows rendered in %.3f ms\n",
+                layout_file, data.row_count, now_ms() - start);
+    }
+    return 0;
+}
+
+/*
+ * Helper function to create the listening socket, replacing a socket no server listens on
+ */
+static int listen_socket(const char *socket_path) {
+    struct sockaddr_un address;
+    if (socket_address(socket_path, &address) != 0) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create socket: %s\n", strerror(errno));
+        return -1;
+    }
+    struct stat info;
+    if (lstat(socket_path, &info) == 0 && S_ISSOCK(info.st_mode)) {
+        if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0) {
+            fprintf(stderr, "Error: Another server is listening on %s\n", socket_path);
+            close(fd);
+            return -1;
+        }
+        unlink(socket_path);
+    }
+
+    mode_t previous_mask = umask(077);
+    int bound = bind(fd, (struct sockaddr *)&address, sizeof(address));
+    umask(previous_mask);
+    if (bound != 0 || listen(fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Error: Cannot listen on %s: %s\n", socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+/*
+ * Helper function to read and render one request in the process forked for its connection
+ * Returns the exit status of the process
+ */
+static int serve_request(int fd, long request_count, int report_fd) {
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    struct timeval timeout = { SERVER_REQUEST_TIMEOUT, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    char layout_file[PATH_MAX];
+    if (read_request_line(fd, layout_file, sizeof(layout_file)) != 0) {
+        const char *message = "Error: Request needs a layout file on its first line\n";
+        write_all(fd, message, strlen(message));
+        return 1;
+    }
+
+    double start = now_ms();
+    int reused = 0;
+    TableConfig parsed;
+    TableConfig *config = served_layout(layout_file, report_fd, &reused, &parsed);
+    if (config == NULL) {
+        char message[PATH_MAX + 64];
+        snprintf(message, sizeof(message), "Error: Failed to parse layout file %s\n", layout_file);
+        write_all(fd, message, strlen(message));
+        return 1;
+    }
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Request %ld for %s, %s layout in %.3f ms\n", request_count,
+                layout_file, reused ? "reused" : "parsed", now_ms() - start);
+    }
+    return render_request(fd, config, layout_file);
+}
+
+/*
+ * Serve render requests on a Unix socket until SIGINT or SIGTERM, returning the exit status
+ */
+int serve_tables(const char *socket_path) {
+    int listen_fd = listen_socket(socket_path);
+    if (listen_fd < 0) return 1;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop_server;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    action.sa_handler = request_ended;
+    sigaction(SIGCHLD, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Serving tables on %s\n", socket_path);
+    }
+
+    // Request processes report the layouts they had to parse on this pipe
+    int report[2];
+    if (pipe(report) != 0) {
+        fprintf(stderr, "Error: Cannot create a pipe for request processes: %s\n", strerror(errno));
+        close(listen_fd);
+        unlink(socket_path);
+        return 1;
+    }
+    fcntl(report[0], F_SETFD, FD_CLOEXEC);
+    fcntl(report[1], F_SETFD, FD_CLOEXEC);
+    fcntl(report[0], F_SETFL, O_NONBLOCK);
+
+    long request_count = 0;
+    int running = 0;
+    while (!stopping) {
+        running -= reap_requests();
+
+        // At the limit, connections wait in the listen queue, checking for ended processes
+        // regularly as one may end between reaping and poll()
+        int full = running >= SERVER_MAX_REQUESTS;
+        struct pollfd fds[2] = { { report[0], POLLIN, 0 }, { listen_fd, POLLIN, 0 } };
+        if (poll(fds, full ? 1 : 2, full ? 100 : -1) < 0) {
+            if (errno != EINTR) fprintf(stderr, "Error: Waiting for connections failed: %s\n", strerror(errno));
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            read_reported_layouts(report[0]);
+        }
+        if (full || !(fds[1].revents & POLLIN)) continue;
+
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EINTR) fprintf(stderr, "Error: Accepting a connection failed: %s\n", strerror(errno));
+            continue;
+        }
+        request_count++;
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(listen_fd);
+            close(report[0]);
+            _exit(serve_request(fd, request_count, report[1]));
+        }
+        if (pid < 0) {
+            const char *message = "Error: Cannot start a process for the request\n";
+            write_all(fd, message, strlen(message));
+        } else {
+            running++;
+            if (tables_debug_mode && running == SERVER_MAX_REQUESTS) {
+                fprintf(stderr, "Debug: %d requests running, waiting for one to end\n", running);
+            }
+        }
+        close(fd);
+    }
+
+    close(report[0]);
+    close(report[1]);
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Server stopped after %ld requests\n", request_count);
+    }
+    close(listen_fd);
+    unlink(socket_path);
+    while (layout_count > 0) {
+        remove_layout(layout_count - 1);
+    }
+    return 0;
+}
+
+/*
+ * Send a layout file and data file to a server and copy the rendered table to stdout
+ * The layout path is made absolute, as the server may run in another directory
+ */
+int request_table(const char *socket_path, const char *layout_file, const char *data_file) {
+    char layout_path[PATH_MAX];
+    if (realpath(layout_file, layout_path) == NULL) {
+        fprintf(stderr, "Error: Cannot open layout file %s\n", layout_file);
+        return 1;
+    }
+    int data_fd = input_is_stdin(data_file) ? STDIN_FILENO : open(data_file, O_RDONLY);
+    if (data_fd < 0) {
+        fprintf(stderr, "Error: Cannot open data file %s\n", data_file);
+        return 1;
+    }
+
+    struct sockaddr_un address;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || socket_address(socket_path, &address) != 0 ||
+        connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        fprintf(stderr, "Error: Cannot connect to tables server at %s\n", socket_path);
+        if (fd >= 0) close(fd);
+        if (data_fd != STDIN_FILENO) close(data_fd);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // Send the request, then read the response until the server closes the connection
+    char buffer[64 * 1024];
+    size_t path_length = strlen(layout_path);
+    layout_path[path_length] = '\n';
+    int failed = write_all(fd, layout_path, path_length + 1);
+    ssize_t count;
+    while (!failed && (count = read(data_fd, buffer, sizeof(buffer))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error: Reading data file %s\n", input_name(data_file));
+            failed = 1;
+            break;
+        }
+        failed = write_all(fd, buffer, (size_t)count);
+    }
+    if (data_fd != STDIN_FILENO) close(data_fd);
+    shutdown(fd, SHUT_WR);
+
+    while ((count = read(fd, buffer, sizeof(buffer))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        write_all(STDOUT_FILENO, buffer, (size_t)count);
+    }
+    close(fd);
+    return failed;
+}
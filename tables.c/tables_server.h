@@ -0,0 +1,24 @@
+/*
+ * tables_server.h - Header file for rendering tables for clients of a Unix socket
+ * A request is the path of a layout file on one line followed by the JSON data, ended by closing
+ * the sending side of the connection. The response is the rendered table together with any
+ * messages a direct run would print on stderr, and the connection is closed once it is complete.
+ */
+
+#ifndef TABLES_SERVER_H
+#define TABLES_SERVER_H
+
+/* Number of parsed layouts kept by the server, the least recently added is dropped first */
+#define SERVER_MAX_LAYOUTS 64
+
+/* Number of requests served at once, further connections wait until one of them ends */
+#define SERVER_MAX_REQUESTS 64
+
+/* Seconds a client may stay silent while sending a request */
+#define SERVER_REQUEST_TIMEOUT 5
+
+/* Function prototypes */
+int serve_tables(const char *socket_path);
+int request_table(const char *socket_path, const char *layout_file, const char *data_file);
+
+#endif /* TABLES_SERVER_H */
@@ -1,87 +1,265 @@
 /*
  * tables_themes.c - Implementation of theme management for the tables utility
  * Manages visual themes with ANSI color codes and border characters.
+ * The built-in themes are constant tables with the byte length of every string measured when
+ * tables is compiled. A theme file is read once per process into the same form, its strings
+ * packed into one allocation, and reused by every layout naming it until the file changes.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <jansson.h>
 #include "tables_themes.h"
+#include "tables_input.h"
+#include "tables_arena.h"
+#include "tables_render_utils.h"
 
-/* ANSI color code constants - commented out to suppress unused variable warnings */
-/* static const char *RED = "\033[0;31m"; */
-/* static const char *BLUE = "\033[0;34m"; */
-/* static const char *GREEN = "\033[0;32m"; */
-/* static const char *CYAN = "\033[0;36m"; */
-/* static const char *BRIGHT_WHITE = "\033[1;37m"; */
-/* static const char *DEFAULT_COLOR = "\033[0m"; */
+/* Initializer of a theme string together with its byte length */
+#define THEME_STRING(field, text) .field = text, .lengths.field = sizeof(text) - 1
 
 /* Theme definitions */
-static ThemeConfig RED_THEME = {
-    .border_color = "\033[0;31m",
-    .caption_color = "\033[0;32m",
-    .header_color = "\033[1;37m",
-    .footer_color = "\033[0;36m",
-    .summary_color = "\033[1;37m",
-    .text_color = "\033[0m",
-    .tl_corner = "╭",
-    .tr_corner = "╮",
-    .bl_corner = "╰",
-    .br_corner = "╯",
-    .h_line = "─",
-    .v_line = "│",
-    .t_junct = "┬",
-    .b_junct = "┴",
-    .l_junct = "├",
-    .r_junct = "┤",
-    .cross = "┼"
+static const ThemeConfig RED_THEME = {
+    THEME_STRING(border_color, "\033[0;31m"),
+    THEME_STRING(caption_color, "\033[0;32m"),
+    THEME_STRING(header_color, "\033[1;37m"),
+    THEME_STRING(footer_color, "\033[0;36m"),
+    THEME_STRING(summary_color, "\033[1;37m"),
+    THEME_STRING(text_color, "\033[0m"),
+    THEME_STRING(tl_corner, "╭"),
+    THEME_STRING(tr_corner, "╮"),
+    THEME_STRING(bl_corner, "╰"),
+    THEME_STRING(br_corner, "╯"),
+    THEME_STRING(h_line, "─"),
+    THEME_STRING(v_line, "│"),
+    THEME_STRING(t_junct, "┬"),
+    THEME_STRING(b_junct, "┴"),
+    THEME_STRING(l_junct, "├"),
+    THEME_STRING(r_junct, "┤"),
+    THEME_STRING(cross, "┼")
 };
 
-static ThemeConfig BLUE_THEME = {
-    .border_color = "\033[0;34m",
-    .caption_color = "\033[0;34m",
-    .header_color = "\033[1;37m",
-    .footer_color = "\033[0;36m",
-    .summary_color = "\033[1;37m",
-    .text_color = "\033[0m",
-    .tl_corner = "╭",
-    .tr_corner = "╮",
-    .bl_corner = "╰",
-    .br_corner = "╯",
-    .h_line = "─",
-    .v_line = "│",
-    .t_junct = "┬",
-    .b_junct = "┴",
-    .l_junct = "├",
-    .r_junct = "┤",
-    .cross = "┼"
+static const ThemeConfig BLUE_THEME = {
+    THEME_STRING(border_color, "\033[0;34m"),
+    THEME_STRING(caption_color, "\033[0;34m"),
+    THEME_STRING(header_color, "\033[1;37m"),
+    THEME_STRING(footer_color, "\033[0;36m"),
+    THEME_STRING(summary_color, "\033[1;37m"),
+    THEME_STRING(text_color, "\033[0m"),
+    THEME_STRING(tl_corner, "╭"),
+    THEME_STRING(tr_corner, "╮"),
+    THEME_STRING(bl_corner, "╰"),
+    THEME_STRING(br_corner, "╯"),
+    THEME_STRING(h_line, "─"),
+    THEME_STRING(v_line, "│"),
+    THEME_STRING(t_junct, "┬"),
+    THEME_STRING(b_junct, "┴"),
+    THEME_STRING(l_junct, "├"),
+    THEME_STRING(r_junct, "┤"),
+    THEME_STRING(cross, "┼")
 };
 
+/* Key of a theme file string and where the string and its length are kept */
+typedef struct {
+    const char *key;        /* Key in the theme file, the same as the ThemeConfig field */
+    size_t offset;          /* Offset of the string in ThemeConfig */
+    size_t length_offset;   /* Offset of its length in ThemeLengths */
+    int glyph;              /* Flag if the string is a border glyph, which must be one column wide */
+} ThemeField;
+
+#define THEME_FIELD(field, glyph) { #field, offsetof(ThemeConfig, field), offsetof(ThemeLengths, field), glyph }
+
+static const ThemeField theme_fields[] = {
+    THEME_FIELD(border_color, 0), THEME_FIELD(caption_color, 0), THEME_FIELD(header_color, 0),
+    THEME_FIELD(footer_color, 0), THEME_FIELD(summary_color, 0), THEME_FIELD(text_color, 0),
+    THEME_FIELD(tl_corner, 1), THEME_FIELD(tr_corner, 1), THEME_FIELD(bl_corner, 1),
+    THEME_FIELD(br_corner, 1), THEME_FIELD(h_line, 1), THEME_FIELD(v_line, 1),
+    THEME_FIELD(t_junct, 1), THEME_FIELD(b_junct, 1), THEME_FIELD(l_junct, 1),
+    THEME_FIELD(r_junct, 1), THEME_FIELD(cross, 1)
+};
+
+#define THEME_FIELD_COUNT (int)(sizeof(theme_fields) / sizeof(theme_fields[0]))
+
+/* Structure holding a theme read from a file, with its path and strings in the same allocation */
+typedef struct LoadedTheme {
+    struct LoadedTheme *next;   /* Theme loaded before this one */
+    const char *path;           /* Path of the theme file */
+    struct timespec mtime;      /* Modification time of the file when it was read */
+    off_t size;                 /* Size of the file when it was read */
+    ThemeConfig theme;          /* Theme, its strings pointing into text */
+    char text[];                /* Path and strings, each NUL terminated */
+} LoadedTheme;
+
+/* Themes read so far, kept for the whole process as configurations point at their strings */
+static LoadedTheme *loaded_themes = NULL;
+
+/*
+ * Helper function to return the string of a theme field
+ */
+static char **theme_string(ThemeConfig *theme, const ThemeField *field) {
+    return (char **)((char *)theme + field->offset);
+}
+
+/*
+ * Helper function to return the length of a theme field
+ */
+static unsigned char *theme_length(ThemeConfig *theme, const ThemeField *field) {
+    return (unsigned char *)&theme->lengths + field->length_offset;
+}
+
+/*
+ * Helper function to find the file of a theme that is not built in
+ * A name with a '/' or ending in .json is a path, any other name is looked up as
+ * $XDG_CONFIG_HOME/tables/themes/<name>.json or ~/.config/tables/themes/<name>.json
+ * Returns 0 with path set on success
+ */
+static int theme_file_path(const char *name, char *path, size_t size) {
+    size_t length = strlen(name);
+    if (strchr(name, '/') || (length > 5 && strcmp(name + length - 5, ".json") == 0)) {
+        return snprintf(path, size, "%s", name) >= (int)size;
+    }
+    const char *xdg = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    if (xdg && *xdg) {
+        return snprintf(path, size, "%s/tables/themes/%s.json", xdg, name) >= (int)size;
+    }
+    if (home && *home) {
+        return snprintf(path, size, "%s/.config/tables/themes/%s.json", home, name) >= (int)size;
+    }
+    return 1;
+}
+
+/*
+ * Helper function to read a theme file into one allocation, starting from the Red theme
+ * Colors may be written as placeholders like {CYAN}, glyphs must be one column wide
+ */
+static LoadedTheme *read_theme_file(const char *path, const struct stat *info) {
+    size_t length = 0;
+    char *buffer = read_input(path, "theme", &length);
+    if (buffer == NULL) return NULL;
+    json_error_t error;
+    json_t *root = json_loadb(buffer, length, 0, &error);
+    free(buffer);
+    if (root == NULL) {
+        fprintf(stderr, "Error: JSON parsing failed for %s: %s\n", path, error.text);
+        return NULL;
+    }
+    if (!json_is_object(root)) {
+        fprintf(stderr, "Error: Theme file %s must hold a JSON object\n", path);
+        json_decref(root);
+        return NULL;
+    }
+
+    // Gather the strings in the arena first, so they can be packed once their sizes are known
+    ArenaMark mark = arena_mark();
+    ThemeConfig theme = RED_THEME;
+    size_t text_size = strlen(path) + 1;
+    for (int f = 0; f < THEME_FIELD_COUNT; f++) {
+        const ThemeField *field = &theme_fields[f];
+        json_t *value = json_object_get(root, field->key);
+        if (value != NULL) {
+            const char *text = json_string_value(value);
+            char *replaced = text ? replace_color_placeholders(text) : NULL;
+            if (replaced == NULL) {
+                fprintf(stderr, "Warning: Theme file %s: %s must be a string, using the default\n", path, field->key);
+            } else if (strlen(replaced) > UCHAR_MAX) {
+                fprintf(stderr, "Warning: Theme file %s: %s is longer than %d bytes, using the default\n", path, field->key, UCHAR_MAX);
+            } else if (field->glyph && get_display_width(replaced) != 1) {
+                fprintf(stderr, "Warning: Theme file %s: %s must be one column wide, using the default\n", path, field->key);
+            } else {
+                *theme_string(&theme, field) = replaced;
+                *theme_length(&theme, field) = (unsigned char)strlen(replaced);
+            }
+        }
+        text_size += *theme_length(&theme, field) + 1;
+    }
+    json_decref(root);
+
+    LoadedTheme *loaded = malloc(sizeof(LoadedTheme) + text_size);
+    if (loaded == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for theme %s\n", path);
+        arena_reset(mark);
+        return NULL;
+    }
+    char *text = loaded->text;
+    size_t path_size = strlen(path) + 1;
+    memcpy(text, path, path_size);
+    loaded->path = text;
+    text += path_size;
+    loaded->theme = theme;
+    for (int f = 0; f < THEME_FIELD_COUNT; f++) {
+        const ThemeField *field = &theme_fields[f];
+        size_t field_size = *theme_length(&theme, field) + 1;
+        memcpy(text, *theme_string(&theme, field), field_size);
+        *theme_string(&loaded->theme, field) = text;
+        text += field_size;
+    }
+    arena_reset(mark);
+    loaded->mtime = info->st_mtim;
+    loaded->size = info->st_size;
+    return loaded;
+}
+
+/*
+ * Helper function to return the theme of a theme file, reading it unless it was read unchanged before
+ * Returns NULL if there is no such file or it cannot be read
+ */
+static const ThemeConfig *load_theme_file(const char *name) {
+    extern int tables_debug_mode;
+    char path[4096];
+    struct stat info;
+    if (theme_file_path(name, path, sizeof(path)) != 0 || stat(path, &info) != 0) {
+        return NULL;
+    }
+    for (LoadedTheme *loaded = loaded_themes; loaded; loaded = loaded->next) {
+        if (strcmp(loaded->path, path) == 0 && loaded->size == info.st_size &&
+            loaded->mtime.tv_sec == info.st_mtim.tv_sec && loaded->mtime.tv_nsec == info.st_mtim.tv_nsec) {
+            return &loaded->theme;
+        }
+    }
+    LoadedTheme *loaded = read_theme_file(path, &info);
+    if (loaded == NULL) return NULL;
+    loaded->next = loaded_themes;
+    loaded_themes = loaded;
+    if (tables_debug_mode) {
+        fprintf(stderr, "Debug: Loaded theme '%s' from %s\n", name, path);
+    }
+    return &loaded->theme;
+}
+
 /*
  * Set the active theme based on the theme name in the configuration
+ * Names other than Red and Blue are looked up as theme files, see theme_file_path()
  */
 void get_theme(TableConfig *config) {
     char *theme_name = config->theme_name;
-    ThemeConfig *selected_theme = &RED_THEME; // Default to Red
-    
+    const ThemeConfig *selected_theme = &RED_THEME; // Default to Red
+
     if (theme_name) {
         if (strcasecmp(theme_name, "blue") == 0) {
             selected_theme = &BLUE_THEME;
         } else if (strcasecmp(theme_name, "red") != 0) {
-            fprintf(stderr, "%sWarning: Unknown theme '%s', using Red%s\n", 
-                    RED_THEME.border_color, theme_name, RED_THEME.text_color);
+            const ThemeConfig *file_theme = load_theme_file(theme_name);
+            if (file_theme) {
+                selected_theme = file_theme;
+            } else {
+                fprintf(stderr, "%sWarning: Unknown theme '%s', using Red%s\n",
+                        RED_THEME.border_color, theme_name, RED_THEME.text_color);
+            }
         }
     }
-    
-    // Copy the selected theme to the config
+
+    // Copy the selected theme to the config, its strings are shared
     config->theme = *selected_theme;
 }
 
 /*
- * Free any dynamically allocated memory in the theme (currently none, as themes are static)
+ * Free any dynamically allocated memory in the theme (none, as theme strings are shared)
  */
 void free_theme(ThemeConfig *theme) {
-    // No dynamically allocated memory in ThemeConfig currently
-    // This function is provided for future extensibility
+    // Theme strings are built in or owned by the loaded theme files
     (void)theme; // Suppress unused parameter warning
 }
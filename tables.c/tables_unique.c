@@ -0,0 +1,171 @@
+/*
+ * tables_unique.c - Implementation of distinct value counting for the tables utility
+ * Exact counts use an open-addressing hash set whose strings are interned in an arena of
+ * its own, so they survive the per-row arena resets of the streaming renderers.
+ * Approximate counts use a fixed-size HyperLogLog sketch fed with the same hash.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "tables_unique.h"
+
+/*
+ * Hash a string with 64-bit FNV-1a, followed by a finalizer so that every bit is well mixed
+ * (HyperLogLog uses the top bits as register index and the rest for the rank)
+ */
+uint64_t unique_hash(const char *value) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)value; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/*
+ * Helper function to resize the slot array, reinserting values by their stored hash
+ */
+static int unique_set_grow(UniqueSet *set, size_t new_capacity) {
+    UniqueSlot *new_slots = calloc(new_capacity, sizeof(UniqueSlot));
+    if (new_slots == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for unique values\n");
+        return 1;
+    }
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (set->slots[i].value == NULL) continue;
+        size_t index = set->slots[i].hash & mask;
+        while (new_slots[index].value != NULL) {
+            index = (index + 1) & mask;
+        }
+        new_slots[index] = set->slots[i];
+    }
+    free(set->slots);
+    set->slots = new_slots;
+    set->capacity = new_capacity;
+    return 0;
+}
+
+/*
+ * Helper function to add a value with a known hash to the set
+ * The set doubles in size whenever it becomes more than 70% full
+ */
+static int unique_set_insert(UniqueSet *set, uint64_t hash, const char *value) {
+    if ((set->count + 1) * 10 > set->capacity * 7) {
+        size_t new_capacity = set->capacity ? set->capacity * 2 : UNIQUE_SET_INITIAL_CAPACITY;
+        if (unique_set_grow(set, new_capacity) != 0) return -1;
+    }
+
+    size_t mask = set->capacity - 1;
+    size_t index = hash & mask;
+    while (set->slots[index].value != NULL) {
+        if (set->slots[index].hash == hash && strcmp(set->slots[index].value, value) == 0) {
+            return 0;
+        }
+        index = (index + 1) & mask;
+    }
+
+    Arena *previous = arena_use(&set->strings);
+    char *interned = arena_strdup(value);
+    arena_use(previous);
+    if (interned == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for unique value string\n");
+        return -1;
+    }
+    set->slots[index].hash = hash;
+    set->slots[index].value = interned;
+    set->count++;
+    return 1;
+}
+
+/*
+ * Add a value to the set, returning 1 if it was new, 0 if already present and -1 on error
+ */
+int unique_set_add(UniqueSet *set, const char *value) {
+    return unique_set_insert(set, unique_hash(value), value);
+}
+
+/*
+ * Add every value of another set, returning the number of values that were new, or -1 on error
+ */
+int unique_set_merge(UniqueSet *set, const UniqueSet *other) {
+    int added = 0;
+    for (size_t i = 0; i < other->capacity; i++) {
+        if (other->slots[i].value == NULL) continue;
+        int result = unique_set_insert(set, other->slots[i].hash, other->slots[i].value);
+        if (result < 0) return -1;
+        added += result;
+    }
+    return added;
+}
+
+/*
+ * Release the slots and interned strings of a set, leaving it empty
+ */
+void unique_set_free(UniqueSet *set) {
+    free(set->slots);
+    arena_release(&set->strings);
+    memset(set, 0, sizeof(UniqueSet));
+}
+
+/*
+ * Allocate an empty HyperLogLog sketch, released with free()
+ */
+HyperLogLog *hll_create(void) {
+    HyperLogLog *hll = calloc(1, sizeof(HyperLogLog));
+    if (hll == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for unique value estimate\n");
+    }
+    return hll;
+}
+
+/*
+ * Record a hashed value in the sketch
+ * The top bits select a register, which keeps the longest run of leading zeros seen in the rest
+ */
+void hll_add(HyperLogLog *hll, uint64_t hash) {
+    size_t index = hash >> (64 - HLL_PRECISION);
+    uint64_t rest = hash << HLL_PRECISION;
+    unsigned char rank = rest ? (unsigned char)(__builtin_clzll(rest) + 1) : (unsigned char)(64 - HLL_PRECISION + 1);
+    if (rank > hll->registers[index]) {
+        hll->registers[index] = rank;
+    }
+}
+
+/*
+ * Record every value of another sketch, giving the sketch of both sets of values combined
+ */
+void hll_merge(HyperLogLog *hll, const HyperLogLog *other) {
+    for (int i = 0; i < HLL_REGISTERS; i++) {
+        if (other->registers[i] > hll->registers[i]) {
+            hll->registers[i] = other->registers[i];
+        }
+    }
+}
+
+/*
+ * Estimate the number of distinct values recorded in the sketch
+ * Falls back to linear counting while many registers are still empty
+ */
+double hll_estimate(const HyperLogLog *hll) {
+    const double m = HLL_REGISTERS;
+    double sum = 0.0;
+    int zeros = 0;
+    for (int i = 0; i < HLL_REGISTERS; i++) {
+        sum += ldexp(1.0, -hll->registers[i]);
+        if (hll->registers[i] == 0) zeros++;
+    }
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * log(m / zeros);
+    }
+    return estimate;
+}
@@ -0,0 +1,50 @@
+/*
+ * tables_unique.h - Header file for counting distinct values in the tables utility
+ * Defines the hash set used by the unique summary and the HyperLogLog sketch used by
+ * the approximate unique~ summary.
+ */
+
+#ifndef TABLES_UNIQUE_H
+#define TABLES_UNIQUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tables_arena.h"
+
+/* Initial number of hash set slots, always a power of two */
+#define UNIQUE_SET_INITIAL_CAPACITY 64
+
+/* Number of index bits of the HyperLogLog sketch, giving a standard error of about 0.8% */
+#define HLL_PRECISION 14
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+/* Structure for one slot of the hash set */
+typedef struct {
+    uint64_t hash;          /* Hash of value, kept so growing does not rehash strings */
+    const char *value;      /* Interned value, NULL for an empty slot */
+} UniqueSlot;
+
+/* Structure for an open-addressing hash set of strings, all zero when empty */
+typedef struct {
+    UniqueSlot *slots;      /* Slot array with linear probing */
+    size_t capacity;        /* Number of slots */
+    size_t count;           /* Number of values stored */
+    Arena strings;          /* Arena holding the interned values */
+} UniqueSet;
+
+/* Structure for a HyperLogLog sketch estimating the number of distinct values */
+typedef struct {
+    unsigned char registers[HLL_REGISTERS];
+} HyperLogLog;
+
+/* Function prototypes */
+uint64_t unique_hash(const char *value);
+int unique_set_add(UniqueSet *set, const char *value);
+int unique_set_merge(UniqueSet *set, const UniqueSet *other);
+void unique_set_free(UniqueSet *set);
+HyperLogLog *hll_create(void);
+void hll_add(HyperLogLog *hll, uint64_t hash);
+void hll_merge(HyperLogLog *hll, const HyperLogLog *other);
+double hll_estimate(const HyperLogLog *hll);
+
+#endif /* TABLES_UNIQUE_H */
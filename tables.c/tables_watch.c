@@ -0,0 +1,313 @@
+/*
+ * tables_watch.c - Implementation of rendering a table again whenever its data may have changed
+ * Frames are written by the normal renderer to a temporary file, so every mode and option works
+ * the same as for a single table. The frame on screen is kept, and a new frame is painted by
+ * moving the cursor to each line that differs and rewriting it, clearing what was left of it.
+ * Cursor rows only match frame lines while every line fits the terminal without wrapping or
+ * scrolling, so frames that do not fit, and the first frame after a resize, are drawn in full.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include "tables_watch.h"
+#include "tables_render_buffer.h"
+#include "tables_render_utils.h"
+#include "tables_input.h"
+
+extern int tables_debug_mode;
+
+static double watch_interval = -1;          /* Seconds between frames, 0 for SIGHUP only, -1 when off */
+static volatile sig_atomic_t reload_requested = 0;
+static volatile sig_atomic_t stop_requested = 0;
+static volatile sig_atomic_t resize_requested = 0;
+
+/* Structure holding a rendered frame split into lines */
+typedef struct {
+    char *text;             /* Frame as rendered */
+    size_t length;          /* Length of text */
+    size_t *starts;         /* Offset of each line in text */
+    size_t *lengths;        /* Length of each line, without its newline */
+    int line_count;         /* Number of lines */
+} WatchFrame;
+
+/*
+ * Set the seconds between frames from --watch, 0 rendering again only on SIGHUP
+ */
+int watch_set_interval(const char *seconds) {
+    char *end = NULL;
+    double interval = seconds ? strtod(seconds, &end) : -1;
+    if (end == NULL || end == seconds || *end != '\0' || !(interval >= 0) || interval > 86400) {
+        fprintf(stderr, "Error: --watch needs a number of seconds between frames, 0 to wait for SIGHUP\n");
+        return 1;
+    }
+    watch_interval = interval;
+    return 0;
+}
+
+/*
+ * Return 1 if --watch was given
+ */
+int watch_requested(void) {
+    return watch_interval >= 0;
+}
+
+/*
+ * Helper function to note a signal for the watch loop
+ */
+static void watch_signal(int signal_number) {
+    if (signal_number == SIGHUP) {
+        reload_requested = 1;
+    } else if (signal_number == SIGWINCH) {
+        resize_requested = 1;
+    } else {
+        stop_requested = 1;
+    }
+}
+
+/*
+ * Helper function to release the text and lines of a frame
+ */
+static void free_frame(WatchFrame *frame) {
+    free(frame->text);
+    free(frame->starts);
+    free(frame->lengths);
+    memset(frame, 0, sizeof(WatchFrame));
+}
+
+/*
+ * Helper function to read the frame rendered into fd and split it into lines
+ */
+static int read_frame(int fd, WatchFrame *frame) {
+    struct stat st;
+    memset(frame, 0, sizeof(WatchFrame));
+    if (fstat(fd, &st) != 0) return 1;
+    frame->length = (size_t)st.st_size;
+    frame->text = malloc(frame->length + 1);
+    if (frame->text == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for watched frame\n");
+        return 1;
+    }
+    size_t offset = 0;
+    while (offset < frame->length) {
+        ssize_t count = pread(fd, frame->text + offset, frame->length - offset, (off_t)offset);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        offset += (size_t)count;
+    }
+    frame->length = offset;
+    frame->text[offset] = '\0';
+
+    int capacity = 1;
+    for (size_t i = 0; i < frame->length; i++) {
+        if (frame->text[i] == '\n') capacity++;
+    }
+    frame->starts = malloc(capacity * sizeof(size_t));
+    frame->lengths = malloc(capacity * sizeof(size_t));
+    if (frame->starts == NULL || frame->lengths == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for watched frame\n");
+        free_frame(frame);
+        return 1;
+    }
+    size_t start = 0;
+    for (size_t i = 0; i <= frame->length; i++) {
+        if (i == frame->length && i == start) break; // Nothing after the last newline
+        if (i == frame->length || frame->text[i] == '\n') {
+            frame->starts[frame->line_count] = start;
+            frame->lengths[frame->line_count] = i - start;
+            frame->line_count++;
+            start = i + 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Helper function to check whether line of frame a is the same as that line of frame b
+ */
+static int same_line(const WatchFrame *a, const WatchFrame *b, int line) {
+    if (line >= a->line_count || line >= b->line_count) return 0;
+    return a->lengths[line] == b->lengths[line] &&
+           memcmp(a->text + a->starts[line], b->text + b->starts[line], a->lengths[line]) == 0;
+}
+
+/*
+ * Helper function to find the rows and columns of the terminal, from TIOCGWINSZ or else LINES and COLUMNS
+ * Returns 1 with both left at 0 when the size is not known
+ */
+static int terminal_size(int *rows, int *columns) {
+    struct winsize size;
+    *rows = 0;
+    *columns = 0;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+        *rows = size.ws_row;
+        *columns = size.ws_col;
+        return 0;
+    }
+    const char *lines = getenv("LINES");
+    const char *cols = getenv("COLUMNS");
+    if (lines && cols && atoi(lines) > 0 && atoi(cols) > 0) {
+        *rows = atoi(lines);
+        *columns = atoi(cols);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Helper function to check that a frame and the cursor line below it fit the terminal unwrapped
+ * A terminal of unknown size is taken to fit, as is output that is not a terminal
+ */
+static int frame_fits(const WatchFrame *frame) {
+    int rows, columns;
+    if (terminal_size(&rows, &columns) != 0) return 1;
+    if (frame->line_count >= rows) return 0;
+    for (int line = 0; line < frame->line_count; line++) {
+        if (get_display_width_n(frame->text + frame->starts[line], frame->lengths[line]) > columns) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Helper function to paint a frame over the previous one, or on a cleared screen when there is none
+ * Returns the number of lines that were written
+ */
+static int paint_frame(const WatchFrame *previous, const WatchFrame *frame) {
+    int painted = 0;
+    if (previous == NULL) {
+        output_puts("\033[H\033[2J");
+        output_write(frame->text, frame->length);
+        output_flush();
+        return frame->line_count;
+    }
+    for (int line = 0; line < frame->line_count; line++) {
+        if (same_line(previous, frame, line)) continue;
+        output_printf("\033[%d;1H", line + 1);
+        output_write(frame->text + frame->starts[line], frame->lengths[line]);
+        output_puts("\033[K");
+        painted++;
+    }
+    if (frame->line_count < previous->line_count) {
+        output_printf("\033[%d;1H\033[J", frame->line_count + 1); // Clear what was below, leaving the cursor there
+    } else if (painted > 0) {
+        output_printf("\033[%d;1H", frame->line_count + 1); // Leave the cursor below the table
+    }
+    output_flush();
+    return painted;
+}
+
+/*
+ * Helper function to wait until the next frame is due, SIGHUP or SIGWINCH asks for one or the watch is stopped
+ * The signals stay blocked outside pselect(), so one arriving just before the wait is not missed
+ */
+static void wait_for_frame(const sigset_t *watched) {
+    struct timespec now, deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += (time_t)watch_interval;
+    deadline.tv_nsec += (long)((watch_interval - (time_t)watch_interval) * 1e9);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    sigset_t original;
+    sigprocmask(SIG_BLOCK, watched, &original);
+    while (!reload_requested && !stop_requested && !resize_requested) {
+        struct timespec remaining, *timeout = NULL;
+        if (watch_interval > 0) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            remaining.tv_sec = deadline.tv_sec - now.tv_sec;
+            remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+            if (remaining.tv_nsec < 0) {
+                remaining.tv_sec--;
+                remaining.tv_nsec += 1000000000L;
+            }
+            if (remaining.tv_sec < 0) break;
+            timeout = &remaining;
+        }
+        if (pselect(0, NULL, NULL, NULL, timeout, &original) == 0) break;
+    }
+    reload_requested = 0;
+    sigprocmask(SIG_SETMASK, &original, NULL);
+}
+
+/*
+ * Render the table again every interval and on SIGHUP until SIGINT or SIGTERM, returning the exit status
+ * A frame that fails to render leaves the previous one on screen, as the data may be rewritten,
+ * and SIGWINCH draws the next frame in full at once
+ */
+int watch_table(TableConfig *config, const char *data_file, WatchRender render) {
+    if (input_is_stdin(data_file)) {
+        fprintf(stderr, "Error: --watch needs a data file that can be read again, not stdin\n");
+        return 1;
+    }
+    FILE *frame_file = tmpfile();
+    if (frame_file == NULL) {
+        fprintf(stderr, "Error: Cannot create a file for watched frames\n");
+        return 1;
+    }
+    int frame_fd = fileno(frame_file);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = watch_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGHUP, &action, NULL);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGWINCH, &action, NULL);
+    sigset_t watched;
+    sigemptyset(&watched);
+    sigaddset(&watched, SIGHUP);
+    sigaddset(&watched, SIGINT);
+    sigaddset(&watched, SIGTERM);
+    sigaddset(&watched, SIGWINCH);
+
+    WatchFrame shown = {0};
+    int have_shown = 0;
+    int shown_fits = 0;         /* Flag if the frame on screen was painted without scrolling or wrapping */
+    int status = 0;
+    long frame_count = 0;
+    while (!stop_requested) {
+        if (ftruncate(frame_fd, 0) != 0 || lseek(frame_fd, 0, SEEK_SET) != 0) {
+            fprintf(stderr, "Error: Cannot reuse the file for watched frames\n");
+            status = 1;
+            break;
+        }
+        output_set_fd(frame_fd);
+        int render_status = render(config, data_file);
+        output_set_fd(STDOUT_FILENO);
+
+        WatchFrame frame;
+        if (render_status == 0 && read_frame(frame_fd, &frame) == 0) {
+            // A resize may have rewrapped the screen, so it is drawn in full as when nothing is shown
+            int fits = frame_fits(&frame);
+            int repaint = have_shown && shown_fits && fits && !resize_requested;
+            resize_requested = 0;
+            int painted = paint_frame(repaint ? &shown : NULL, &frame);
+            if (tables_debug_mode) {
+                fprintf(stderr, "Debug: Watched frame %ld repainted %d of %d lines\n", ++frame_count, painted, frame.line_count);
+            }
+            if (have_shown) free_frame(&shown);
+            shown = frame;
+            have_shown = 1;
+            shown_fits = fits;
+        }
+        wait_for_frame(&watched);
+    }
+
+    if (have_shown) free_frame(&shown);
+    fclose(frame_file);
+    signal(SIGHUP, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGWINCH, SIG_DFL);
+    return status;
+}
@@ -0,0 +1,24 @@
+/*
+ * tables_watch.h - Header file for rendering a table again whenever its data may have changed
+ * With --watch the table is rendered every few seconds, and at once on SIGHUP, until SIGINT or
+ * SIGTERM. Each frame is rendered into a temporary file and compared line by line with the
+ * frame on screen, and only the lines that changed are repainted, using cursor addressing.
+ * A change of column widths changes every line, which repaints the whole table. A frame that
+ * does not fit the terminal, and the first frame after SIGWINCH, clear the screen and are drawn
+ * in full, as scrolling and wrapped lines move the rows that cursor addressing relies on.
+ */
+
+#ifndef TABLES_WATCH_H
+#define TABLES_WATCH_H
+
+#include "tables_config.h"
+
+/* Renders one frame of the table to the output, returning 0 on success */
+typedef int (*WatchRender)(TableConfig *config, const char *data_file);
+
+/* Function prototypes */
+int watch_set_interval(const char *seconds);
+int watch_requested(void);
+int watch_table(TableConfig *config, const char *data_file, WatchRender render);
+
+#endif /* TABLES_WATCH_H */
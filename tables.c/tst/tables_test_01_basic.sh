@@ -470,3 +470,98 @@ EOF
 echo -e "\nTestC 1-I: Complex color combinations and edge cases"
 echo "-----------------------------------------------------"
 "$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# Test 1-J: Large integers and reals keep all their digits (Theme: Blue)
+cat > "$data_file" << 'EOF'
+[
+  { "counter": 9007199254740993, "bytes": 123456789012, "ratio": 1234567.5, "load": 750.0 },
+  { "counter": 4294967296, "bytes": 2147483648, "ratio": 0.1, "load": 2.45 },
+  { "counter": 1e3, "bytes": 0, "ratio": 99.95, "load": 12.125 }
+]
+EOF
+
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "columns": [
+    {
+      "header": "Counter",
+      "key": "counter",
+      "datatype": "int",
+      "justification": "right"
+    },
+    {
+      "header": "Bytes",
+      "key": "bytes",
+      "datatype": "num",
+      "justification": "right"
+    },
+    {
+      "header": "Ratio",
+      "key": "ratio",
+      "datatype": "float",
+      "justification": "right"
+    },
+    {
+      "header": "Load",
+      "key": "load",
+      "datatype": "float",
+      "justification": "right"
+    }
+  ]
+}
+EOF
+
+echo -e "\nTestC 1-J: Large integers and reals keep all their digits"
+echo "---------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# Test 1-K: Color placeholders next to braces that are not placeholders
+cat > "$data_file" << 'EOF'
+[
+  {
+    "label": "{{RED}nested{NC}}",
+    "tags": "{GREEN}{BOLD}adjacent{RESET}{NC}",
+    "other": "{red} {UNKNOWN} {NC",
+    "count": 12
+  },
+  {
+    "label": "plain {text}",
+    "tags": "{DIM}{UNDERLINE}dim{NC} and {CYAN}cyan{NC}",
+    "other": "{}{{}}",
+    "count": 0
+  }
+]
+EOF
+
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "columns": [
+    {
+      "header": "Label",
+      "key": "label"
+    },
+    {
+      "header": "Tags",
+      "key": "tags",
+      "width": 14
+    },
+    {
+      "header": "Other",
+      "key": "other"
+    },
+    {
+      "header": "Count",
+      "key": "count",
+      "datatype": "int",
+      "format": "{YELLOW}%.0f{NC}",
+      "justification": "right"
+    }
+  ]
+}
+EOF
+
+echo -e "\nTestC 1-K: Color placeholders next to braces that are not placeholders"
+echo "----------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
@@ -2,7 +2,7 @@
 
 # Test Suite 2: Summary - Summary row functionality with various summary functions
 # This test suite focuses on demonstrating the summary row functionality
-# with different summary types (sum, count, min, max, unique) across all datatypes
+# with different summary types (sum, count, min, max, unique, unique~) across all datatypes
 
 # Create temporary files for our JSON
 layout_file=$(mktemp)
@@ -456,3 +456,37 @@ EOF
 echo -e "\nTestC 2-I: Blanks and nonblanks summaries"
 echo "------------------------------------------"
 "$tables_script" "$layout_file" "$data_file"
+
+# Test 2-J: Approximate unique value summaries next to exact ones (Theme: Blue)
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "columns": [
+    {
+      "header": "Status",
+      "key": "status",
+      "datatype": "text",
+      "justification": "left",
+      "summary": "unique"
+    },
+    {
+      "header": "Status (approx)",
+      "key": "status",
+      "datatype": "text",
+      "justification": "left",
+      "summary": "unique~"
+    },
+    {
+      "header": "Memory Usage",
+      "key": "memory_usage",
+      "datatype": "kmem",
+      "justification": "right",
+      "summary": "unique~"
+    }
+  ]
+}
+EOF
+
+echo -e "\nTestC 2-J: Approximate unique value summaries next to exact ones"
+echo "-----------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file"
@@ -0,0 +1,116 @@
+#!/usr/bin/env bash
+
+# Test Suite 10: Streaming - Rendering rows while the data file is still being read
+# This test suite focuses on the streaming renderer, which is selected with --stream or
+# automatically when every visible column has a fixed width and no sorting is requested,
+# and on the two-pass renderer over a memory-mapped data file selected with --mmap.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data with a grouping column and a mix of datatypes
+cat > "$data_file" << 'EOF'
+[
+  { "namespace": "default", "pod": "web-7d9f8-abcde", "cpu": "250m", "memory": "512Mi", "restarts": 0, "load": 0.5 },
+  { "namespace": "default", "pod": "web-7d9f8-fghij", "cpu": "300m", "memory": "768Mi", "restarts": 2, "load": 1.25 },
+  { "namespace": "kube-system", "pod": "coredns-5d78c-klmno", "cpu": "100m", "memory": "72Mi", "restarts": 1, "load": 0.125 },
+  { "namespace": "kube-system", "pod": "kube-proxy-pqrst", "cpu": "50m", "memory": "32Mi", "restarts": 0, "load": 0.2 },
+  { "namespace": "monitoring", "pod": "prometheus-0", "cpu": "1200m", "memory": "2Gi", "restarts": 5, "load": 3.75 }
+]
+EOF
+
+# TestC 10-A: Fixed widths select the streaming renderer automatically
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Pods (streamed)",
+  "title_position": "left",
+  "columns": [
+    { "header": "Namespace", "key": "namespace", "width": 13, "break": true },
+    { "header": "Pod", "key": "pod", "width": 18, "summary": "count" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "width": 9, "summary": "sum" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "width": 9, "summary": "sum" },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right", "width": 10, "summary": "max" }
+  ]
+}
+EOF
+
+echo "TestC 10-A: Fixed widths select the streaming renderer automatically"
+echo "--------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 10-B: Explicit --stream with a float column (precision grows as rows arrive)
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "footer": "Streamed with --stream",
+  "footer_position": "right",
+  "columns": [
+    { "header": "Pod", "key": "pod", "width": 22, "wrap_mode": "wrap", "wrap_char": "-" },
+    { "header": "Load", "key": "load", "datatype": "float", "justification": "right", "width": 8, "summary": "avg" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 10-B: Explicit --stream with a float column"
+echo "-------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --stream $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 10-C: --stream falls back to the normal renderer when a width is missing
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "columns": [
+    { "header": "Namespace", "key": "namespace" },
+    { "header": "Pod", "key": "pod", "width": 22 },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 10-C: --stream falls back to the normal renderer when a width is missing"
+echo "------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --stream $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 10-D: --mmap measures widths in a first pass and renders in a second
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "Pods (two passes)",
+  "columns": [
+    { "header": "Namespace", "key": "namespace", "break": true },
+    { "header": "Pod", "key": "pod", "summary": "count" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "summary": "sum" },
+    { "header": "Load", "key": "load", "datatype": "float", "justification": "right", "summary": "max" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 10-D: --mmap measures widths in a first pass and renders in a second"
+echo "-------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --mmap $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
@@ -0,0 +1,126 @@
+#!/usr/bin/env bash
+
+# Test Suite 11: Sorting - Ordering rows with the sort array of the layout
+# This test suite focuses on sorting by text and numeric columns, multiple sort keys with
+# priorities and directions, null values (always sorted last) and the ordering of equal rows.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data in no particular order, with ties and null values
+cat > "$data_file" << 'EOF'
+[
+  { "namespace": "monitoring", "pod": "prometheus-0", "cpu": "1200m", "memory": "2Gi", "restarts": 5 },
+  { "namespace": "default", "pod": "web-7d9f8-fghij", "cpu": "300m", "memory": "768Mi", "restarts": 2 },
+  { "namespace": "kube-system", "pod": "kube-proxy-pqrst", "cpu": "50m", "memory": "32Mi", "restarts": 0 },
+  { "namespace": "default", "pod": "web-7d9f8-abcde", "cpu": "250m", "memory": "512Mi", "restarts": 0 },
+  { "namespace": "kube-system", "pod": "coredns-5d78c-klmno", "cpu": "100m", "memory": "72Mi", "restarts": null },
+  { "namespace": "monitoring", "pod": "grafana-6b7c9", "cpu": "0.2", "memory": "256Mi", "restarts": 2 }
+]
+EOF
+
+# TestC 11-A: Sort by a single text column
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Pods by name",
+  "columns": [
+    { "header": "Pod", "key": "pod" },
+    { "header": "Namespace", "key": "namespace" },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right" }
+  ],
+  "sort": [
+    { "key": "pod" }
+  ]
+}
+EOF
+
+echo "TestC 11-A: Sort by a single text column"
+echo "----------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 11-B: Several sort keys with priorities, a descending numeric key and a null value
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "columns": [
+    { "header": "Namespace", "key": "namespace", "break": true },
+    { "header": "Pod", "key": "pod", "summary": "count" },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right", "summary": "sum" }
+  ],
+  "sort": [
+    { "key": "restarts", "direction": "desc", "priority": 2 },
+    { "key": "namespace", "direction": "asc", "priority": 1 }
+  ]
+}
+EOF
+
+echo -e "\nTestC 11-B: Several sort keys with priorities, a descending numeric key and a null value"
+echo "---------------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 11-C: Kubernetes units are compared by value
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "footer": "Sorted by memory, then CPU",
+  "footer_position": "right",
+  "columns": [
+    { "header": "Pod", "key": "pod" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right" },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right" }
+  ],
+  "sort": [
+    { "key": "memory", "direction": "desc" },
+    { "key": "cpu", "direction": "desc" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 11-C: Kubernetes units are compared by value"
+echo "--------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 11-D: Equal keys keep their input order
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "columns": [
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right" },
+    { "header": "Pod", "key": "pod" }
+  ],
+  "sort": [
+    { "key": "restarts" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 11-D: Equal keys keep their input order"
+echo "---------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
@@ -0,0 +1,115 @@
+#!/usr/bin/env bash
+
+# Test Suite 12: Threads - Formatting and measuring blocks of rows in parallel
+# This test suite focuses on --threads, checking that tables rendered by several threads are
+# identical to those rendered by a single thread, including widths, wrapping, breaks and the
+# summaries merged from every block of rows.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+single_file=$(mktemp)
+threaded_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file" "$single_file" "$threaded_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data with enough rows to be split into several blocks
+{
+    echo "["
+    for i in $(seq 1 1500); do
+        separator=","
+        if [ "$i" -eq 1500 ]; then separator=""; fi
+        case $((i % 4)) in
+            0) cpu="null" ;;
+            1) cpu="\"$((i % 900))m\"" ;;
+            2) cpu="\"0.$((i % 10))\"" ;;
+            3) cpu="\"$((i % 3))\"" ;;
+        esac
+        echo "  { \"group\": \"group-$((i / 300))\", \"id\": $i, \"name\": \"{GREEN}item $((i * 7919 % 1000)) of a longer description{RESET}\", \"ratio\": $((i % 97)).$((i % 7))$((i % 3)), \"cpu\": $cpu }$separator"
+    done
+    echo "]"
+} > "$data_file"
+
+# TestC 12-A: Column widths and summaries from several threads
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Threaded summaries",
+  "columns": [
+    { "header": "Group", "key": "group", "summary": "unique" },
+    { "header": "ID", "key": "id", "datatype": "int", "justification": "right", "summary": "sum" },
+    { "header": "Ratio", "key": "ratio", "datatype": "float", "justification": "right", "summary": "avg" },
+    { "header": "Ratio Sum", "key": "ratio", "datatype": "float", "justification": "right", "summary": "sum" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "max" },
+    { "header": "Names", "key": "name", "summary": "unique~" }
+  ]
+}
+EOF
+
+echo "TestC 12-A: Column widths and summaries from several threads"
+echo "------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --threads 1 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$single_file"
+"$tables_script" "$layout_file" "$data_file" --threads 4 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$threaded_file"
+if cmp -s "$single_file" "$threaded_file"; then
+    echo "Output with --threads 4 matches --threads 1 ($(wc -l < "$single_file") lines)"
+else
+    echo "Output with --threads 4 differs from --threads 1"
+fi
+tail -n 4 "$threaded_file"
+
+# TestC 12-B: Wrapped columns, breaks and sorting rendered by several threads
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "columns": [
+    { "header": "Group", "key": "group", "break": true },
+    { "header": "ID", "key": "id", "datatype": "int", "justification": "right", "summary": "count" },
+    { "header": "Name", "key": "name", "width": 16, "wrap_mode": "wrap" },
+    { "header": "Ratio", "key": "ratio", "datatype": "float", "width": 10, "justification": "right", "summary": "min" }
+  ],
+  "sort": [
+    { "key": "ratio", "direction": "desc" }
+  ]
+}
+EOF
+
+echo ""
+echo "TestC 12-B: Wrapped columns, breaks and sorting rendered by several threads"
+echo "---------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --threads 1 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$single_file"
+"$tables_script" "$layout_file" "$data_file" --threads 3 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$threaded_file"
+if cmp -s "$single_file" "$threaded_file"; then
+    echo "Output with --threads 3 matches --threads 1 ($(wc -l < "$single_file") lines)"
+else
+    echo "Output with --threads 3 differs from --threads 1"
+fi
+tail -n 4 "$threaded_file"
+
+# TestC 12-C: An invalid thread count is rejected
+echo ""
+echo "TestC 12-C: An invalid thread count is rejected"
+echo "-----------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --threads 0 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+echo "Exit status: $?"
@@ -0,0 +1,128 @@
+#!/usr/bin/env bash
+
+# Test Suite 13: Commands - Running the $() commands of titles and footers
+# This test suite focuses on dynamic titles and footers, checking that each distinct command runs
+# once per table, that independent commands run at the same time, that "command_timeout" stops
+# slow commands and that "cache_seconds" keeps output on disk between runs.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+count_file=$(mktemp)
+cache_dir=$(mktemp -d)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file" "$count_file"
+    rm -rf "$cache_dir"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data
+cat > "$data_file" << 'EOF'
+[
+  { "server": "web-01", "status": "Running" },
+  { "server": "db-01", "status": "Stopped" }
+]
+EOF
+
+# TestC 13-A: A command used in both the title and the footer runs once
+cat > "$layout_file" << EOF
+{
+  "theme": "Red",
+  "title": "Run \$(echo run >> $count_file; wc -l < $count_file)",
+  "footer": "Run \$(echo run >> $count_file; wc -l < $count_file)",
+  "columns": [
+    { "header": "Server", "key": "server" },
+    { "header": "Status", "key": "status" }
+  ]
+}
+EOF
+
+echo "TestC 13-A: A command used in both the title and the footer runs once"
+echo "---------------------------------------------------------------------"
+: > "$count_file"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+echo "Command ran $(wc -l < "$count_file") time(s)"
+
+# TestC 13-B: Independent commands run at the same time
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "$(sleep 1; echo First) and $(sleep 1; echo Second)",
+  "footer": "$(sleep 1; echo Third)",
+  "columns": [
+    { "header": "Server", "key": "server" },
+    { "header": "Status", "key": "status" }
+  ]
+}
+EOF
+
+echo ""
+echo "TestC 13-B: Independent commands run at the same time"
+echo "-----------------------------------------------------"
+start_ms=$(( $(date +%s%N) / 1000000 ))
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+elapsed_ms=$(( $(date +%s%N) / 1000000 - start_ms ))
+if [ "$elapsed_ms" -lt 2500 ]; then
+    echo "Three one second commands finished together"
+else
+    echo "Three one second commands took ${elapsed_ms} ms"
+fi
+
+# TestC 13-C: A command running longer than command_timeout is stopped
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Status: $(sleep 10; echo Late)$(echo Ready)",
+  "command_timeout": 0.5,
+  "columns": [
+    { "header": "Server", "key": "server" },
+    { "header": "Status", "key": "status" }
+  ]
+}
+EOF
+
+echo ""
+echo "TestC 13-C: A command running longer than command_timeout is stopped"
+echo "--------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1
+
+# TestC 13-D: Output cached on disk with cache_seconds is reused by the next run
+cat > "$layout_file" << EOF
+{
+  "theme": "Red",
+  "title": "Run \$(echo run >> $count_file; wc -l < $count_file)",
+  "cache_seconds": 300,
+  "columns": [
+    { "header": "Server", "key": "server" },
+    { "header": "Status", "key": "status" }
+  ]
+}
+EOF
+
+echo ""
+echo "TestC 13-D: Output cached on disk with cache_seconds is reused by the next run"
+echo "------------------------------------------------------------------------------"
+: > "$count_file"
+XDG_CACHE_HOME="$cache_dir" "$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG | head -n 3
+XDG_CACHE_HOME="$cache_dir" "$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG | head -n 3
+echo "Command ran $(wc -l < "$count_file") time(s) for two runs"
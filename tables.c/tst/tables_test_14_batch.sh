@@ -0,0 +1,133 @@
+#!/usr/bin/env bash
+
+# Test Suite 14: Batch - Rendering several tables in one process
+# This test suite focuses on --batch, checking that the tables listed in a manifest match the
+# same tables rendered one at a time, that "output" files receive their table and that a broken
+# entry is reported without stopping the rest of the batch.
+
+# Create temporary files for our JSON
+servers_layout=$(mktemp)
+totals_layout=$(mktemp)
+servers_data=$(mktemp)
+totals_data=$(mktemp)
+manifest_file=$(mktemp)
+single_file=$(mktemp)
+batch_file=$(mktemp)
+output_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$servers_layout" "$totals_layout" "$servers_data" "$totals_data" "$manifest_file"
+    rm -f "$single_file" "$batch_file" "$output_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data
+cat > "$servers_layout" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Servers",
+  "columns": [
+    { "header": "Server", "key": "server" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" }
+  ]
+}
+EOF
+
+cat > "$totals_layout" << 'EOF'
+{
+  "theme": "Blue",
+  "footer": "Totals",
+  "columns": [
+    { "header": "Region", "key": "region" },
+    { "header": "Count", "key": "count", "datatype": "int", "justification": "right", "summary": "sum" }
+  ]
+}
+EOF
+
+cat > "$servers_data" << 'EOF'
+[
+  { "server": "web-01", "cpu": "250m" },
+  { "server": "web-02", "cpu": "1500m" },
+  { "server": "db-01", "cpu": "2" }
+]
+EOF
+
+cat > "$totals_data" << 'EOF'
+[
+  { "region": "east", "count": 12 },
+  { "region": "west", "count": 7 }
+]
+EOF
+
+# TestC 14-A: Tables from a manifest match tables rendered one at a time
+cat > "$manifest_file" << EOF
+[
+  { "layout": "$servers_layout", "data": "$servers_data" },
+  { "layout": "$totals_layout", "data": "$totals_data" },
+  { "layout": "$servers_layout", "data": "$servers_data" }
+]
+EOF
+
+echo "TestC 14-A: Tables from a manifest match tables rendered one at a time"
+echo "----------------------------------------------------------------------"
+{
+    "$tables_script" "$servers_layout" "$servers_data" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+    "$tables_script" "$totals_layout" "$totals_data" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+    "$tables_script" "$servers_layout" "$servers_data" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+} > "$single_file"
+"$tables_script" --batch "$manifest_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$batch_file"
+if cmp -s "$single_file" "$batch_file"; then
+    echo "Batch output matches separate runs ($(wc -l < "$batch_file") lines)"
+else
+    echo "Batch output differs from separate runs"
+fi
+cat "$batch_file"
+
+# TestC 14-B: A table with an output file is written there instead of stdout
+cat > "$manifest_file" << EOF
+[
+  { "layout": "$totals_layout", "data": "$totals_data", "output": "$output_file" },
+  { "layout": "$servers_layout", "data": "$servers_data" }
+]
+EOF
+
+echo ""
+echo "TestC 14-B: A table with an output file is written there instead of stdout"
+echo "--------------------------------------------------------------------------"
+"$tables_script" --batch "$manifest_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+echo "Output file:"
+cat "$output_file"
+
+# TestC 14-C: A broken entry is reported and the other tables are still rendered
+cat > "$manifest_file" << EOF
+[
+  { "layout": "$servers_layout", "data": "$servers_data.missing" },
+  { "layout": "$totals_layout" },
+  { "layout": "$totals_layout", "data": "$totals_data" }
+]
+EOF
+
+echo ""
+echo "TestC 14-C: A broken entry is reported and the other tables are still rendered"
+echo "------------------------------------------------------------------------------"
+"$tables_script" --batch "$manifest_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1 | sed "s#$servers_data#SERVERS_DATA#"
+echo "Exit status: ${PIPESTATUS[0]}"
@@ -0,0 +1,165 @@
+#!/usr/bin/env bash
+
+# Test Suite 15: Server - Rendering tables for clients of a Unix socket
+# This test suite focuses on --serve and --client, checking that tables rendered by the server
+# match direct runs, that several clients are served at once, that a client holding an idle
+# connection does not delay the others, that only a limited number of requests run at once,
+# that a changed layout file is parsed again and that errors are sent back to the client.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+direct_file=$(mktemp)
+served_dir=$(mktemp -d)
+socket_file="$served_dir/tables.sock"
+tables_script="$(dirname "$0")/../tables"
+server_pid=""
+
+# Cleanup function
+cleanup() {
+    if [ -n "$server_pid" ]; then kill "$server_pid" 2>/dev/null; wait "$server_pid" 2>/dev/null; fi
+    rm -f "$layout_file" "$data_file" "$direct_file"
+    rm -rf "$served_dir"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Served table",
+  "columns": [
+    { "header": "Pod", "key": "pod" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "summary": "sum" }
+  ],
+  "sort": [
+    { "key": "pod", "direction": "asc" }
+  ]
+}
+EOF
+
+cat > "$data_file" << 'EOF'
+[
+  { "pod": "web-7f9c", "memory": "256Mi" },
+  { "pod": "api-5d2a", "memory": "1Gi" },
+  { "pod": "db-0", "memory": "512Mi" }
+]
+EOF
+
+# Start the server and wait for its socket
+"$tables_script" --serve "$socket_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG &
+server_pid=$!
+for attempt in $(seq 1 50); do
+    [ -S "$socket_file" ] && break
+    sleep 0.1
+done
+
+# TestC 15-A: A table rendered by the server matches a direct run
+echo "TestC 15-A: A table rendered by the server matches a direct run"
+echo "---------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" > "$direct_file"
+"$tables_script" --client "$socket_file" "$layout_file" "$data_file" > "$served_dir/served"
+if cmp -s "$direct_file" "$served_dir/served"; then
+    echo "Served table matches direct run ($(wc -l < "$direct_file") lines)"
+else
+    echo "Served table differs from direct run"
+fi
+cat "$served_dir/served"
+
+# TestC 15-B: Several clients are served at the same time
+echo ""
+echo "TestC 15-B: Several clients are served at the same time"
+echo "-------------------------------------------------------"
+for client in 1 2 3 4; do
+    "$tables_script" --client "$socket_file" "$layout_file" "$data_file" > "$served_dir/client_$client" &
+done
+wait $(jobs -p | grep -v "^$server_pid$")
+for client in 1 2 3 4; do
+    if cmp -s "$direct_file" "$served_dir/client_$client"; then
+        echo "Client $client received the same table"
+    else
+        echo "Client $client received a different table"
+    fi
+done
+
+# TestC 15-C: An idle connection does not delay other clients
+echo ""
+echo "TestC 15-C: An idle connection does not delay other clients"
+echo "------------------------------------------------------------"
+python3 -c 'import socket, sys, time
+idle = socket.socket(socket.AF_UNIX)
+idle.connect(sys.argv[1])
+time.sleep(3)' "$socket_file" &
+idle_pid=$!
+sleep 0.3
+start=$(date +%s%N)
+"$tables_script" --client "$socket_file" "$layout_file" "$data_file" > "$served_dir/behind_idle"
+elapsed_ms=$(( ($(date +%s%N) - start) / 1000000 ))
+if cmp -s "$direct_file" "$served_dir/behind_idle" && [ "$elapsed_ms" -lt 2000 ]; then
+    echo "Client behind an idle connection was answered promptly"
+else
+    echo "Client behind an idle connection waited ${elapsed_ms} ms"
+fi
+kill "$idle_pid" 2>/dev/null
+wait "$idle_pid" 2>/dev/null
+
+# TestC 15-D: Only a limited number of requests run at once
+echo ""
+echo "TestC 15-D: Only a limited number of requests run at once"
+echo "---------------------------------------------------------"
+python3 -c 'import socket, sys, time
+idle = []
+for i in range(80):
+    idle.append(socket.socket(socket.AF_UNIX))
+    idle[-1].connect(sys.argv[1])
+time.sleep(2)' "$socket_file" &
+idle_pid=$!
+sleep 1
+echo "Request processes for 80 idle connections: $(pgrep -P "$server_pid" | wc -l)"
+"$tables_script" --client "$socket_file" "$layout_file" "$data_file" > "$served_dir/behind_limit"
+if cmp -s "$direct_file" "$served_dir/behind_limit"; then
+    echo "Client past the limit was answered once the idle connections closed"
+else
+    echo "Client past the limit received a different table"
+fi
+wait "$idle_pid" 2>/dev/null
+
+# TestC 15-E: A changed layout file is parsed again
+sed -i 's/"Served table"/"Changed layout"/' "$layout_file"
+echo ""
+echo "TestC 15-E: A changed layout file is parsed again"
+echo "-------------------------------------------------"
+"$tables_script" --client "$socket_file" "$layout_file" "$data_file" | head -n 3
+
+# TestC 15-F: Errors are sent back to the client
+echo ""
+echo "TestC 15-F: Errors are sent back to the client"
+echo "----------------------------------------------"
+echo '"not an array"' > "$data_file"
+"$tables_script" --client "$socket_file" "$layout_file" "$data_file"
+kill "$server_pid"
+wait "$server_pid"
+echo "Server exit status: $?"
+server_pid=""
+if [ -S "$socket_file" ]; then
+    echo "Socket left behind"
+else
+    echo "Socket removed"
+fi
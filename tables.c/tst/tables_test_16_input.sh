@@ -0,0 +1,110 @@
+#!/usr/bin/env bash
+
+# Test Suite 16: Input - Reading layout and data from stdin and named pipes
+# This test suite focuses on inputs that are not regular files, checking that "-" reads the
+# layout or the data from stdin, that named pipes are read like files and that --mmap falls back
+# to loading the data when it cannot be mapped.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+direct_file=$(mktemp)
+piped_file=$(mktemp)
+fifo_dir=$(mktemp -d)
+fifo_file="$fifo_dir/data.fifo"
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file" "$direct_file" "$piped_file"
+    rm -rf "$fifo_dir"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data, large enough to take several reads from a pipe
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Piped data",
+  "columns": [
+    { "header": "Node", "key": "node" },
+    { "header": "Pods", "key": "pods", "datatype": "int", "justification": "right", "summary": "sum" },
+    { "header": "Load", "key": "load", "datatype": "float", "justification": "right", "summary": "max" }
+  ]
+}
+EOF
+
+{
+    echo "["
+    for i in $(seq 1 2000); do
+        separator=","
+        if [ "$i" -eq 2000 ]; then separator=""; fi
+        echo "  { \"node\": \"node-$i.cluster.example.com\", \"pods\": $((i % 110)), \"load\": $((i % 16)).$((i % 100)) }$separator"
+    done
+    echo "]"
+} > "$data_file"
+"$tables_script" "$layout_file" "$data_file" > "$direct_file"
+
+# Helper function to compare a table with the one rendered from regular files
+compare_table() {
+    if cmp -s "$direct_file" "$piped_file"; then
+        echo "Table matches the one rendered from files ($(wc -l < "$piped_file") lines)"
+    else
+        echo "Table differs from the one rendered from files"
+    fi
+}
+
+# TestC 16-A: Data piped to stdin
+echo "TestC 16-A: Data piped to stdin"
+echo "-------------------------------"
+cat "$data_file" | "$tables_script" "$layout_file" - $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$piped_file"
+compare_table
+tail -n 3 "$piped_file"
+
+# TestC 16-B: Layout piped to stdin
+echo ""
+echo "TestC 16-B: Layout piped to stdin"
+echo "---------------------------------"
+cat "$layout_file" | "$tables_script" - "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$piped_file"
+compare_table
+
+# TestC 16-C: Data read from a named pipe
+echo ""
+echo "TestC 16-C: Data read from a named pipe"
+echo "---------------------------------------"
+mkfifo "$fifo_file"
+cat "$data_file" > "$fifo_file" &
+"$tables_script" "$layout_file" "$fifo_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$piped_file"
+wait
+compare_table
+
+# TestC 16-D: --mmap on piped data falls back to loading it
+echo ""
+echo "TestC 16-D: --mmap on piped data falls back to loading it"
+echo "---------------------------------------------------------"
+cat "$data_file" | "$tables_script" "$layout_file" - --mmap $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$piped_file"
+compare_table
+
+# TestC 16-E: Layout and data cannot both come from stdin
+echo ""
+echo "TestC 16-E: Layout and data cannot both come from stdin"
+echo "-------------------------------------------------------"
+"$tables_script" - - $DEBUG_FLAG $DEBUG_LAYOUT_FLAG < /dev/null
+echo "Exit status: $?"
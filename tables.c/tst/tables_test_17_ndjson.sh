@@ -0,0 +1,105 @@
+#!/usr/bin/env bash
+
+# Test Suite 17: NDJSON - Reading data with one row object per line
+# This test suite focuses on NDJSON data, checking that it is detected from its first object or
+# selected with --format, that it renders the same table as the equivalent JSON array whether the
+# rows are loaded, streamed or piped, and that a bad line is reported with its line number.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+array_file=$(mktemp)
+ndjson_file=$(mktemp)
+array_table=$(mktemp)
+ndjson_table=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$array_file" "$ndjson_file" "$array_table" "$ndjson_table"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Setup test data, the same rows as a JSON array and as NDJSON
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Log lines",
+  "columns": [
+    { "header": "Host", "key": "host", "width": 24 },
+    { "header": "Status", "key": "status", "datatype": "int", "justification": "right", "width": 8, "summary": "count" },
+    { "header": "Bytes", "key": "bytes", "datatype": "int", "justification": "right", "width": 10, "summary": "sum" }
+  ]
+}
+EOF
+
+: > "$ndjson_file"
+for i in $(seq 1 1000); do
+    echo "{\"host\": \"web-$((i % 37)).example.com\", \"status\": $((200 + (i % 3) * 100)), \"bytes\": $((i * 17))}" >> "$ndjson_file"
+done
+{
+    echo "["
+    sed '$!s/$/,/' "$ndjson_file"
+    echo "]"
+} > "$array_file"
+"$tables_script" "$layout_file" "$array_file" > "$array_table"
+
+# Helper function to compare a table with the one rendered from the JSON array
+compare_table() {
+    if cmp -s "$array_table" "$ndjson_table"; then
+        echo "Table matches the one rendered from the JSON array ($(wc -l < "$ndjson_table") lines)"
+    else
+        echo "Table differs from the one rendered from the JSON array"
+    fi
+}
+
+# TestC 17-A: NDJSON detected from its first object
+echo "TestC 17-A: NDJSON detected from its first object"
+echo "-------------------------------------------------"
+"$tables_script" "$layout_file" "$ndjson_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$ndjson_table"
+compare_table
+tail -n 3 "$ndjson_table"
+
+# TestC 17-B: NDJSON selected with --format
+echo ""
+echo "TestC 17-B: NDJSON selected with --format"
+echo "-----------------------------------------"
+"$tables_script" "$layout_file" "$ndjson_file" --format ndjson $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$ndjson_table"
+compare_table
+"$tables_script" "$layout_file" - --format json $DEBUG_FLAG $DEBUG_LAYOUT_FLAG < "$ndjson_file" > /dev/null
+echo "Exit status with --format json: $?"
+
+# TestC 17-C: NDJSON streamed and piped
+echo ""
+echo "TestC 17-C: NDJSON streamed and piped"
+echo "-------------------------------------"
+"$tables_script" "$layout_file" "$ndjson_file" --stream $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$ndjson_table"
+compare_table
+cat "$ndjson_file" | "$tables_script" "$layout_file" - $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$ndjson_table"
+compare_table
+"$tables_script" "$layout_file" "$ndjson_file" --mmap $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$ndjson_table"
+compare_table
+
+# TestC 17-D: A bad line is reported with its line number
+echo ""
+echo "TestC 17-D: A bad line is reported with its line number"
+echo "-------------------------------------------------------"
+sed -i '500s/}$/,}/' "$ndjson_file"
+"$tables_script" "$layout_file" - $DEBUG_FLAG $DEBUG_LAYOUT_FLAG < "$ndjson_file" > /dev/null
+echo "Exit status: $?"
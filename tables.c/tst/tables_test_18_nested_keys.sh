@@ -0,0 +1,153 @@
+#!/usr/bin/env bash
+
+# Test Suite 18: Nested Keys - Column keys naming fields of nested objects
+# This test suite focuses on dotted column keys such as "metadata.name", checking that they are
+# followed into nested objects, that a field named by the whole key takes priority, that rows
+# read field by field give the same values whether they are streamed or mapped, and that numbers
+# out of range are rejected even in fields the layout does not show.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# TestC 18-A: Dotted keys follow nested objects
+echo "TestC 18-A: Dotted keys follow nested objects"
+echo "---------------------------------------------"
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Pods",
+  "columns": [
+    { "header": "Name", "key": "metadata.name" },
+    { "header": "Namespace", "key": "metadata.namespace" },
+    { "header": "Node", "key": "spec.nodeName" },
+    { "header": "Restarts", "key": "status.restarts", "datatype": "int", "justification": "right", "summary": "sum" }
+  ]
+}
+EOF
+cat > "$data_file" << 'EOF'
+[
+  { "metadata": { "name": "web-1", "namespace": "shop", "labels": { "app": "web" } },
+    "spec": { "nodeName": "node-a", "containers": [ { "name": "nginx", "ports": [ 80, 443 ] } ] },
+    "status": { "phase": "Running", "restarts": 2 } },
+  { "metadata": { "name": "db-1", "namespace": "shop" },
+    "spec": { "nodeName": "node-b" },
+    "status": { "restarts": 0 } },
+  { "metadata": { "name": "job-7" },
+    "spec": "pending",
+    "status": { "restarts": 5 } }
+]
+EOF
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 18-B: A field named by the whole key comes first
+echo ""
+echo "TestC 18-B: A field named by the whole key comes first"
+echo "------------------------------------------------------"
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "columns": [
+    { "header": "Label", "key": "app.kubernetes.io/name" },
+    { "header": "Owner", "key": "owner.name" }
+  ]
+}
+EOF
+cat > "$data_file" << 'EOF'
+[
+  { "app.kubernetes.io/name": "whole key", "app": { "kubernetes": { "io/name": "nested" } }, "owner": { "name": "ops" } },
+  { "app": { "kubernetes": { "io/name": "nested only" } }, "owner.name": "dev", "owner": { "name": "ops" } },
+  { "owner": { "name": "first" }, "owner": { "team": "replaced" } }
+]
+EOF
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 18-C: Escapes, numbers and other values
+echo ""
+echo "TestC 18-C: Escapes, numbers and other values"
+echo "---------------------------------------------"
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "columns": [
+    { "header": "Text", "key": "text" },
+    { "header": "Nümber", "key": "nümber" },
+    { "header": "Other", "key": "other" }
+  ]
+}
+EOF
+cat > "$data_file" << 'EOF'
+[
+  { "text": "café \"quoted\"", "nümber": 1.50, "other": true },
+  { "text": "tab\there", "nümber": 1e2, "other": [ 1, 2 ] },
+  { "text": "😀", "nümber": -0, "other": { "a": 1 } },
+  { "nümber": 12345678901234567, "other": null }
+]
+EOF
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 18-D: Streamed rows match mapped rows
+echo ""
+echo "TestC 18-D: Streamed rows match mapped rows"
+echo "-------------------------------------------"
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "columns": [
+    { "header": "Host", "key": "host.name", "width": 12 },
+    { "header": "Region", "key": "host.region", "width": 10 },
+    { "header": "Load", "key": "metrics.load", "datatype": "float", "justification": "right", "width": 8, "summary": "max" }
+  ]
+}
+EOF
+for i in $(seq 1 200); do
+    echo "{\"host\": {\"name\": \"h$i\", \"region\": \"r$((i % 4))\", \"tags\": [\"a\", \"b\"]}, \"metrics\": {\"load\": $((i % 9)).$((i % 10)), \"history\": [1, 2, 3]}}"
+done > "$data_file"
+streamed=$("$tables_script" "$layout_file" "$data_file" --stream $DEBUG_FLAG $DEBUG_LAYOUT_FLAG)
+mapped=$("$tables_script" "$layout_file" "$data_file" --mmap $DEBUG_FLAG $DEBUG_LAYOUT_FLAG)
+if [ "$streamed" = "$mapped" ]; then
+    echo "Streamed and mapped tables match ($(echo "$streamed" | wc -l) lines)"
+else
+    echo "Streamed and mapped tables differ"
+fi
+echo "$streamed" | tail -n 3
+
+# TestC 18-E: Numbers out of range are rejected in fields outside the layout
+echo ""
+echo "TestC 18-E: Numbers out of range are rejected in fields outside the layout"
+echo "--------------------------------------------------------------------------"
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "columns": [
+    { "header": "A", "key": "a" }
+  ]
+}
+EOF
+echo '[ { "a": 1, "z": 1e400 } ]' > "$data_file"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1 | sed "s#$data_file#DATA_FILE#"
+echo "Exit status: ${PIPESTATUS[0]}"
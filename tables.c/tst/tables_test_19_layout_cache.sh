@@ -0,0 +1,102 @@
+#!/usr/bin/env bash
+
+# Test Suite 19: Layout Cache - Reusing parsed layouts with --layout_cache
+# This test suite focuses on the binary layout cache, checking that a cached layout renders the
+# same table as a parsed one, that changing the layout file replaces its cached image, and that
+# a damaged image is ignored in favour of parsing the layout again.
+
+# Create temporary files for our JSON and a private cache directory
+layout_file=$(mktemp)
+data_file=$(mktemp)
+cache_home=$(mktemp -d)
+tables_script="$(dirname "$0")/../tables"
+export XDG_CACHE_HOME="$cache_home"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+    rm -rf "$cache_home"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Helper to count the cached layout images
+count_images() {
+    find "$cache_home" -name "*.layout" | wc -l | tr -d ' '
+}
+
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Servers",
+  "title_position": "center",
+  "footer": "Cached",
+  "columns": [
+    { "header": "Server", "key": "server", "summary": "count" },
+    { "header": "Zone", "key": "region.zone", "width": 8 },
+    { "header": "Load", "key": "load", "datatype": "float", "justification": "right", "summary": "avg" },
+    { "header": "Users", "key": "users", "datatype": "int", "justification": "right", "summary": "sum" }
+  ],
+  "sort": [ { "key": "users", "direction": "desc" } ]
+}
+EOF
+cat > "$data_file" << 'EOF'
+[
+  { "server": "alpha", "region": { "zone": "eu-west-1a" }, "load": 0.75, "users": 120 },
+  { "server": "beta", "region": { "zone": "us-east-1c" }, "load": 1.5, "users": 340 },
+  { "server": "gamma", "region": { "zone": "ap-south-1" }, "load": 0.25, "users": 15 }
+]
+EOF
+
+# TestC 19-A: The first run stores the layout and later runs read it back
+echo "TestC 19-A: The first run stores the layout and later runs read it back"
+echo "-----------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --layout_cache $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+echo "Cached images: $(count_images)"
+"$tables_script" "$layout_file" "$data_file" --layout_cache $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+echo "Cached images: $(count_images)"
+
+# TestC 19-B: A cached layout renders the same table as a parsed one
+echo ""
+echo "TestC 19-B: A cached layout renders the same table as a parsed one"
+echo "------------------------------------------------------------------"
+if cmp -s <("$tables_script" "$layout_file" "$data_file") <("$tables_script" "$layout_file" "$data_file" --layout_cache); then
+    echo "Output matches"
+else
+    echo "Output differs"
+fi
+
+# TestC 19-C: Changing the layout file replaces its cached image
+echo ""
+echo "TestC 19-C: Changing the layout file replaces its cached image"
+echo "--------------------------------------------------------------"
+sed -i 's/"title": "Servers"/"title": "Servers by Users"/' "$layout_file"
+"$tables_script" "$layout_file" "$data_file" --layout_cache $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+echo "Cached images: $(count_images)"
+
+# TestC 19-D: A damaged image is ignored and the layout parsed again
+echo ""
+echo "TestC 19-D: A damaged image is ignored and the layout parsed again"
+echo "------------------------------------------------------------------"
+image_file=$(find "$cache_home" -name "*.layout" | head -n 1)
+printf 'XXXXXXXX' | dd of="$image_file" bs=1 seek=200 conv=notrunc 2>/dev/null
+"$tables_script" "$layout_file" "$data_file" --layout_cache $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+head -c 100 "$image_file" > "$image_file.short" && mv "$image_file.short" "$image_file"
+"$tables_script" "$layout_file" "$data_file" --layout_cache $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+echo "Cached images: $(count_images)"
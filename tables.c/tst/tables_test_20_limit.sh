@@ -0,0 +1,132 @@
+#!/usr/bin/env bash
+
+# Test Suite 20: Limit - Showing only the first rows in sort order
+# This test suite focuses on the layout "limit" and the --limit option, checking that the rows
+# shown are the ones a full sort puts first, that summaries cover every row or only the rows
+# shown as configured, and that unsorted and streamed tables show the first rows read.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+cat > "$data_file" << 'EOF'
+[
+  { "namespace": "monitoring", "pod": "prometheus-0", "cpu": "1200m", "memory": "2Gi", "restarts": 5 },
+  { "namespace": "default", "pod": "web-7d9f8-fghij", "cpu": "300m", "memory": "768Mi", "restarts": 2 },
+  { "namespace": "kube-system", "pod": "kube-proxy-pqrst", "cpu": "50m", "memory": "32Mi", "restarts": 0 },
+  { "namespace": "default", "pod": "web-7d9f8-abcde", "cpu": "250m", "memory": "768Mi", "restarts": 0 },
+  { "namespace": "kube-system", "pod": "coredns-5d78c-klmno", "cpu": "100m", "memory": null, "restarts": null },
+  { "namespace": "monitoring", "pod": "grafana-6b7c9", "cpu": "0.2", "memory": "256Mi", "restarts": 2 },
+  { "namespace": "default", "pod": "api-5f6d7-qwert", "cpu": "400m", "memory": "1Gi", "restarts": 1 }
+]
+EOF
+
+# TestC 20-A: The top rows by memory, with summaries of every row
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Top 3 pods by memory",
+  "limit": 3,
+  "columns": [
+    { "header": "Pod", "key": "pod", "summary": "count" },
+    { "header": "Namespace", "key": "namespace" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "summary": "sum" },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right", "summary": "sum" }
+  ],
+  "sort": [
+    { "key": "memory", "direction": "desc" }
+  ]
+}
+EOF
+
+echo "TestC 20-A: The top rows by memory, with summaries of every row"
+echo "---------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 20-B: Summaries of the rows shown, with equal keys in input order
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "Top 4 pods by memory",
+  "limit": 4,
+  "limit_summaries": "shown",
+  "columns": [
+    { "header": "Pod", "key": "pod", "summary": "count" },
+    { "header": "Namespace", "key": "namespace", "summary": "unique" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "summary": "sum" },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right", "summary": "max" }
+  ],
+  "sort": [
+    { "key": "memory", "direction": "desc" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 20-B: Summaries of the rows shown, with equal keys in input order"
+echo "----------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 20-C: --limit overrides the layout, 0 showing every row
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "limit": 2,
+  "columns": [
+    { "header": "Pod", "key": "pod" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right" }
+  ],
+  "sort": [
+    { "key": "restarts", "direction": "desc" },
+    { "key": "cpu", "direction": "asc" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 20-C: --limit overrides the layout, 0 showing every row"
+echo "-------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --limit 5 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" --limit 0 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 20-D: Unsorted tables show the first rows, also when streamed
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "First pods",
+  "limit": 3,
+  "columns": [
+    { "header": "Pod", "key": "pod", "width": 20, "summary": "count" },
+    { "header": "Namespace", "key": "namespace", "width": 12 }
+  ]
+}
+EOF
+
+echo -e "\nTestC 20-D: Unsorted tables show the first rows, also when streamed"
+echo "-------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" --mmap $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" --limit 4 --stream $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
@@ -0,0 +1,95 @@
+#!/usr/bin/env bash
+
+# Test Suite 21: Wrapping - Word and delimiter wrapping of long cells
+# This test suite focuses on wrapped cells, checking that words separated by several spaces are
+# joined by one, that colored and multi-byte text wraps by its display width, and that lines of
+# delimiter-wrapped cells wider than their column are clipped for each justification.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+cat > "$data_file" << 'EOF'
+[
+  { "name": "alpha", "notes": "The quick   brown fox jumps    over the lazy dog", "tags": "red|green|blue-violet|yellow" },
+  { "name": "beta", "notes": "Crème brûlée über café naïve façade", "tags": "one|two||three" },
+  { "name": "gamma", "notes": "{RED}warning{RESET} disk {YELLOW}nearly{RESET} full on /var", "tags": "averyveryverylongtag|x" },
+  { "name": "delta", "notes": "", "tags": "|" },
+  { "name": "epsilon", "notes": "supercalifragilisticexpialidocious word", "tags": null }
+]
+EOF
+
+# TestC 21-A: Word wrapping with collapsed spaces and delimiter wrapping, left justified
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Wrapped notes",
+  "columns": [
+    { "header": "Name", "key": "name" },
+    { "header": "Notes", "key": "notes", "width": 16, "wrap_mode": "wrap", "justification": "left" },
+    { "header": "Tags", "key": "tags", "width": 9, "wrap_mode": "wrap", "wrap_char": "|", "justification": "left" }
+  ]
+}
+EOF
+
+echo "TestC 21-A: Word wrapping with collapsed spaces and delimiter wrapping, left justified"
+echo "--------------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 21-B: Delimiter-wrapped lines clipped from the left when right justified
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "Wrapped notes",
+  "columns": [
+    { "header": "Name", "key": "name" },
+    { "header": "Notes", "key": "notes", "width": 16, "wrap_mode": "wrap", "justification": "right" },
+    { "header": "Tags", "key": "tags", "width": 9, "wrap_mode": "wrap", "wrap_char": "|", "justification": "right" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 21-B: Delimiter-wrapped lines clipped from the left when right justified"
+echo "------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 21-C: Delimiter-wrapped lines clipped on both sides when centered
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Wrapped notes",
+  "columns": [
+    { "header": "Name", "key": "name" },
+    { "header": "Notes", "key": "notes", "width": 16, "wrap_mode": "wrap", "justification": "center" },
+    { "header": "Tags", "key": "tags", "width": 9, "wrap_mode": "wrap", "wrap_char": "|", "justification": "center" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 21-C: Delimiter-wrapped lines clipped on both sides when centered"
+echo "-----------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
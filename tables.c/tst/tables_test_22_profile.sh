@@ -0,0 +1,101 @@
+#!/usr/bin/env bash
+
+# Test Suite 22: Profile - Phase timings and counters reported by --profile
+# This test suite focuses on the --profile option, checking that the table itself is unchanged,
+# that one JSON record is printed on stderr with every phase, and that the rows, cells, commands
+# and bytes written are counted for loaded, streamed and batch tables. Timings and arena figures
+# vary between runs and machines, so they are shown as # by the filter below.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+manifest_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file" "$manifest_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Show the profile record with everything that varies between runs replaced by #
+profile_filter() {
+    sed -E -e 's/("[a-z_]+_ms"|"(validate|parse|theme|load|sort|process|widths|format|output|commands)"):[0-9.]+/\1:#/g' \
+           -e 's/("arena_[a-z_]+"):[0-9]+/\1:#/g'
+}
+
+cat > "$data_file" << 'EOF'
+[
+  { "host": "web-01", "zone": "east", "cpu": "250m", "memory": "512Mi" },
+  { "host": "web-02", "zone": "east", "cpu": "1500m", "memory": "2Gi" },
+  { "host": "db-01", "zone": "west", "cpu": "2", "memory": "8Gi" },
+  { "host": "cache-01", "zone": "west", "cpu": "500m", "memory": "1Gi" }
+]
+EOF
+
+# TestC 22-A: A sorted table with a command in its title
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Hosts at $(echo noon)",
+  "columns": [
+    { "header": "Host", "key": "host" },
+    { "header": "Zone", "key": "zone", "break": true },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "summary": "sum" }
+  ],
+  "sort": [
+    { "key": "zone", "direction": "asc" }
+  ]
+}
+EOF
+
+echo "TestC 22-A: A sorted table with a command in its title"
+echo "------------------------------------------------------"
+{ "$tables_script" "$layout_file" "$data_file" --profile $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1 >&3 | profile_filter; } 3>&1
+
+# TestC 22-B: A streamed table, with the rows read and formatted one at a time
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "Streamed hosts",
+  "columns": [
+    { "header": "Host", "key": "host", "width": 10 },
+    { "header": "Zone", "key": "zone", "width": 6 },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "width": 8 }
+  ]
+}
+EOF
+
+echo -e "\nTestC 22-B: A streamed table, with the rows read and formatted one at a time"
+echo "----------------------------------------------------------------------------"
+{ "$tables_script" "$layout_file" "$data_file" --stream --profile $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1 >&3 | profile_filter; } 3>&1
+
+# TestC 22-C: One record adding up every table of a batch
+cat > "$manifest_file" << EOF
+[
+  { "layout": "$layout_file", "data": "$data_file" },
+  { "layout": "$layout_file", "data": "$data_file" }
+]
+EOF
+
+echo -e "\nTestC 22-C: One record adding up every table of a batch"
+echo "-------------------------------------------------------"
+{ "$tables_script" --batch "$manifest_file" --profile $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1 >&3 | profile_filter; } 3>&1
@@ -0,0 +1,129 @@
+#!/usr/bin/env bash
+
+# Test Suite 23: Watch - Rendering a table again as its data changes with --watch
+# This test suite focuses on the --watch option, running the table in the background with
+# --watch 0 so that frames are only rendered on SIGHUP, changing the data between frames and
+# stopping it with SIGTERM. The output is shown with cat -v, so the cursor addressing that
+# repaints only the changed lines is visible.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+output_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file" "$output_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Start watching the table, waiting for the first frame
+watch_start() {
+    "$tables_script" "$layout_file" "$data_file" --watch 0 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG > "$output_file" &
+    watch_pid=$!
+    sleep 0.5
+}
+
+# Ask the watching table for another frame
+watch_frame() {
+    kill -HUP "$watch_pid"
+    sleep 0.5
+}
+
+# Stop the watching table and show everything it wrote
+watch_stop() {
+    kill -TERM "$watch_pid"
+    wait "$watch_pid"
+    echo "Exit status: $?"
+    cat -v "$output_file"
+}
+
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Pods",
+  "columns": [
+    { "header": "Pod", "key": "pod", "width": 10 },
+    { "header": "Status", "key": "status", "width": 10 },
+    { "header": "Restarts", "key": "restarts", "datatype": "int", "justification": "right", "width": 10, "summary": "sum" }
+  ]
+}
+EOF
+
+cat > "$data_file" << 'EOF'
+[
+  { "pod": "web-1", "status": "Running", "restarts": 0 },
+  { "pod": "web-2", "status": "Pending", "restarts": 0 },
+  { "pod": "db-1", "status": "Running", "restarts": 2 }
+]
+EOF
+
+# TestC 23-A: A changed row and total are the only lines repainted
+echo "TestC 23-A: A changed row and total are the only lines repainted"
+echo "----------------------------------------------------------------"
+watch_start
+cat > "$data_file" << 'EOF'
+[
+  { "pod": "web-1", "status": "Running", "restarts": 0 },
+  { "pod": "web-2", "status": "Running", "restarts": 1 },
+  { "pod": "db-1", "status": "Running", "restarts": 2 }
+]
+EOF
+watch_frame
+watch_frame
+watch_stop
+
+# TestC 23-B: Lines left below a shorter table are cleared
+echo -e "\nTestC 23-B: Lines left below a shorter table are cleared"
+echo "--------------------------------------------------------"
+watch_start
+cat > "$data_file" << 'EOF'
+[
+  { "pod": "db-1", "status": "Running", "restarts": 2 }
+]
+EOF
+watch_frame
+watch_stop
+
+# TestC 23-C: Frames taller than the terminal, and frames after a resize, are drawn in full
+echo -e "\nTestC 23-C: Frames taller than the terminal, and frames after a resize, are drawn in full"
+echo "----------------------------------------------------------------------------------------"
+LINES=4 COLUMNS=80 watch_start
+watch_frame
+watch_frame
+kill -TERM "$watch_pid"
+wait "$watch_pid"
+echo "Frames drawn in full on a 4 line terminal: $(grep -o $'\033\[2J' "$output_file" | wc -l)"
+LINES=24 COLUMNS=80 watch_start
+watch_frame
+kill -WINCH "$watch_pid"
+sleep 0.5
+kill -TERM "$watch_pid"
+wait "$watch_pid"
+echo "Frames drawn in full on a 24 line terminal resized once: $(grep -o $'\033\[2J' "$output_file" | wc -l)"
+
+# TestC 23-D: Data that cannot be read again, and an interval that is not a number
+echo -e "\nTestC 23-D: Data that cannot be read again, and an interval that is not a number"
+echo "--------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" - --watch 1 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG < "$data_file" 2>&1
+echo "Exit status: $?"
+"$tables_script" "$layout_file" "$data_file" --watch soon $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1
+echo "Exit status: $?"
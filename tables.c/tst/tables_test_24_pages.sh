@@ -0,0 +1,103 @@
+#!/usr/bin/env bash
+
+# Test Suite 24: Pages - Splitting the rows of a table into pages
+# This test suite focuses on the --page_size and --page options, checking that every page repeats
+# the column headers, that a single page is cut from the sorted rows while the column widths and
+# summaries still cover every row, and that streamed and mapped tables pick the same rows.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+cat > "$data_file" << 'EOF'
+[
+  { "host": "web-01", "zone": "east", "cpu": "250m", "memory": "512Mi" },
+  { "host": "web-02", "zone": "east", "cpu": "1500m", "memory": "2Gi" },
+  { "host": "db-01", "zone": "west", "cpu": "2", "memory": "8Gi" },
+  { "host": "cache-01", "zone": "west", "cpu": "500m", "memory": "1Gi" },
+  { "host": "batch-worker-01", "zone": "north", "cpu": "4", "memory": "16Gi" }
+]
+EOF
+
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Hosts",
+  "footer": "Capacity",
+  "columns": [
+    { "header": "Zone", "key": "zone", "break": true },
+    { "header": "Host", "key": "host" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "summary": "sum" }
+  ],
+  "sort": [
+    { "key": "zone", "direction": "asc" },
+    { "key": "host", "direction": "asc" }
+  ]
+}
+EOF
+
+# TestC 24-A: Every page in turn, each starting with the column headers
+echo "TestC 24-A: Every page in turn, each starting with the column headers"
+echo "---------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --page_size 2 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 24-B: One page, as wide as the whole table and with its summaries
+echo -e "\nTestC 24-B: One page, as wide as the whole table and with its summaries"
+echo "-----------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --page_size 2 --page 2 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 24-C: The last page, and a page past it
+echo -e "\nTestC 24-C: The last page, and a page past it"
+echo "---------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --page_size 2 --page 3 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" --page_size 2 --page 4 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1
+
+# TestC 24-D: Streamed and mapped tables pick the same page in input order
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "Hosts in input order",
+  "columns": [
+    { "header": "Host", "key": "host", "width": 18 },
+    { "header": "Zone", "key": "zone", "width": 7 },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum", "width": 9 }
+  ]
+}
+EOF
+
+echo -e "\nTestC 24-D: Streamed and mapped tables pick the same page in input order"
+echo "------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --stream --page_size 2 --page 2 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" --mmap --page_size 2 --page 2 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" --stream --page_size 3 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 24-E: A page without a page size
+echo -e "\nTestC 24-E: A page without a page size"
+echo "--------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --page 2 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1
+echo "Exit status: $?"
@@ -0,0 +1,106 @@
+#!/usr/bin/env bash
+
+# Test Suite 25: Subtotals - Summaries of each group of rows between breaks
+# This test suite focuses on the "subtotal" column option, checking that each group of rows
+# sharing a break value is followed by its subtotals, that a column can have a subtotal without a
+# grand total and the other way around, that subtotals are counted in the column widths, and that
+# streamed tables and pages print the same subtotals.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+cat > "$data_file" << 'EOF'
+[
+  { "host": "web-01", "zone": "east", "cpu": "250m", "memory": "512Mi", "load": 0.5 },
+  { "host": "web-02", "zone": "east", "cpu": "1500m", "memory": "2Gi", "load": 1.25 },
+  { "host": "db-01", "zone": "west", "cpu": "2", "memory": "8Gi", "load": 3.5 },
+  { "host": "cache-01", "zone": "west", "cpu": "500m", "memory": "1Gi", "load": 0.75 },
+  { "host": "batch-01", "zone": "north", "cpu": "64", "memory": "512Gi", "load": 12 }
+]
+EOF
+
+# TestC 25-A: Sums per zone and in total, a count per zone only and a maximum in total only
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Hosts by zone",
+  "columns": [
+    { "header": "Zone", "key": "zone", "break": true },
+    { "header": "Host", "key": "host", "subtotal": "count" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum", "subtotal": "sum" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "summary": "sum", "subtotal": "sum" },
+    { "header": "Load", "key": "load", "datatype": "float", "justification": "right", "summary": "max", "subtotal": "avg" }
+  ],
+  "sort": [
+    { "key": "zone", "direction": "asc" },
+    { "key": "host", "direction": "asc" }
+  ]
+}
+EOF
+
+echo "TestC 25-A: Sums per zone and in total, a count per zone only and a maximum in total only"
+echo "----------------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 25-B: Pages print the subtotals of the groups that end on them
+echo -e "\nTestC 25-B: Pages print the subtotals of the groups that end on them"
+echo "--------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --page_size 2 --page 2 $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 25-C: A streamed table prints each group's subtotals when the next group starts
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "Hosts in input order",
+  "columns": [
+    { "header": "Zone", "key": "zone", "break": true, "width": 7 },
+    { "header": "Host", "key": "host", "width": 10, "subtotal": "count" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "width": 9, "summary": "sum", "subtotal": "sum" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 25-C: A streamed table prints each group's subtotals when the next group starts"
+echo "------------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --stream $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 25-D: Mapped tables are rendered from loaded rows when there are subtotals
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "columns": [
+    { "header": "Zone", "key": "zone", "break": true },
+    { "header": "Host", "key": "host" },
+    { "header": "Memory", "key": "memory", "datatype": "kmem", "justification": "right", "subtotal": "max" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 25-D: Mapped tables are rendered from loaded rows when there are subtotals"
+echo "--------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" --mmap $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1
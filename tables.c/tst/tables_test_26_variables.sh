@@ -0,0 +1,114 @@
+#!/usr/bin/env bash
+
+# Test Suite 26: Variables - ${name} variables and commands run without the shell
+# This test suite focuses on the ${name} variables of titles and footers, from the layout's
+# "vars", the environment and the HOSTNAME, DATE and TIME built in, none of which runs a process.
+# It also checks which $() commands are run directly and which need /bin/sh, and that command
+# output is shown as it is, without replacing variables in it.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+output_file=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file" "$output_file"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+cat > "$data_file" << 'EOF'
+[
+  { "host": "web-01", "cpu": "250m" },
+  { "host": "db-01", "cpu": "2" }
+]
+EOF
+
+# TestC 26-A: Variables of the layout and the environment, and one that is not set
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "vars": { "cluster": "prod-east", "region": "$(echo eu-1)" },
+  "title": "${cluster} hosts",
+  "footer": "Owner ${TABLES_TEST_OWNER}, region ${region}${not_set}, cost $5",
+  "columns": [
+    { "header": "Host", "key": "host" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right" }
+  ]
+}
+EOF
+
+echo "TestC 26-A: Variables of the layout and the environment, and one that is not set"
+echo "--------------------------------------------------------------------------------"
+TABLES_TEST_OWNER=ops "$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 26-B: The host name and date built in
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "${HOSTNAME} on ${DATE}",
+  "columns": [
+    { "header": "Host", "key": "host" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 26-B: The host name and date built in"
+echo "-------------------------------------------"
+title=$(env -u HOSTNAME "$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG | sed -n 2p)
+if [[ "$title" == *"$(hostname) on $(date +%Y-%m-%d)"* ]]; then
+    echo "Title holds the host name and the date"
+else
+    echo "Title does not hold the host name and the date: $title"
+fi
+
+# TestC 26-C: Commands without shell syntax are run directly, others by /bin/sh
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "$(uname -s) / $(type true) / $(echo a | tr a b)",
+  "columns": [
+    { "header": "Host", "key": "host" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 26-C: Commands without shell syntax are run directly, others by /bin/sh"
+echo "-----------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" --debug 2>&1 >/dev/null | grep "Running command" | sed 's/process [0-9]*/process #/'
+
+# TestC 26-D: Command output is shown as it is, without replacing variables in it
+echo '${HOME} and ${cluster}' > "$output_file"
+cat > "$layout_file" << EOF
+{
+  "theme": "Red",
+  "vars": { "cluster": "prod-east" },
+  "title": "\${cluster}: \$(cat $output_file)",
+  "columns": [
+    { "header": "Host", "key": "host" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 26-D: Command output is shown as it is, without replacing variables in it"
+echo "-------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG | sed -n 2p
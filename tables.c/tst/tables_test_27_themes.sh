@@ -0,0 +1,104 @@
+#!/usr/bin/env bash
+
+# Test Suite 27: Themes - Theme files loaded alongside the built-in Red and Blue themes
+# This test suite focuses on themes read from JSON files, named by path or looked up in
+# $XDG_CONFIG_HOME/tables/themes, with ASCII glyphs, colors written as placeholders,
+# the defaults used for strings a theme file leaves out or gets wrong, and unknown themes.
+
+# Create temporary files for our JSON
+layout_file=$(mktemp)
+data_file=$(mktemp)
+theme_dir=$(mktemp -d)
+tables_script="$(dirname "$0")/../tables"
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file"
+    rm -rf "$theme_dir"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+cat > "$data_file" << 'EOF'
+[
+  { "pod": "web-1", "namespace": "shop", "cpu": "250m" },
+  { "pod": "web-2", "namespace": "shop", "cpu": "1.5" },
+  { "pod": "db-1", "namespace": "data", "cpu": "2" }
+]
+EOF
+
+mkdir -p "$theme_dir/tables/themes"
+cat > "$theme_dir/tables/themes/plain.json" << 'EOF'
+{
+  "border_color": "{NC}",
+  "caption_color": "{NC}",
+  "header_color": "{NC}",
+  "footer_color": "{NC}",
+  "summary_color": "{NC}",
+  "text_color": "{NC}",
+  "tl_corner": "+", "tr_corner": "+", "bl_corner": "+", "br_corner": "+",
+  "h_line": "-", "v_line": "|",
+  "t_junct": "+", "b_junct": "+", "l_junct": "+", "r_junct": "+", "cross": "+"
+}
+EOF
+
+cat > "$theme_dir/partial.json" << 'EOF'
+{
+  "border_color": "{YELLOW}",
+  "h_line": "==",
+  "v_line": "┃",
+  "cross": 5
+}
+EOF
+
+layout_with_theme() {
+    cat > "$layout_file" << EOF
+{
+  "theme": "$1",
+  "title": "Pods",
+  "footer": "Generated",
+  "columns": [
+    { "header": "Pod", "key": "pod" },
+    { "header": "Namespace", "key": "namespace", "break": true },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" }
+  ]
+}
+EOF
+}
+
+# TestC 27-A: An ASCII theme looked up by name in the theme directory
+layout_with_theme "plain"
+
+echo "TestC 27-A: An ASCII theme looked up by name in the theme directory"
+echo "-------------------------------------------------------------------"
+XDG_CONFIG_HOME="$theme_dir" "$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 27-B: A theme file named by path, with the defaults kept for strings it gets wrong
+layout_with_theme "$theme_dir/partial.json"
+
+echo -e "\nTestC 27-B: A theme file named by path, with the defaults kept for strings it gets wrong"
+echo "----------------------------------------------------------------------------------------"
+"$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1 | sed "s#$theme_dir#<theme_dir>#g"
+
+# TestC 27-C: A theme that is neither built in nor a file
+layout_with_theme "missing"
+
+echo -e "\nTestC 27-C: A theme that is neither built in nor a file"
+echo "-------------------------------------------------------"
+XDG_CONFIG_HOME="$theme_dir" "$tables_script" "$layout_file" "$data_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1
@@ -0,0 +1,92 @@
+/*
+ * tables_test_28_library.c - Program rendering a table through libtables for tables_test_28_library.sh
+ * The rows are pushed from memory, including NULL values and rows shorter than the layout, and the
+ * rendered table is passed to a writer that copies it to stdout and counts what it was given.
+ * Usage: tables_test_28_library LAYOUT_FILE [--stdout] [--twice] [--debug] [--debug_layout]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../tables_api.h"
+
+/* Structure counting what the writer was given */
+typedef struct {
+    size_t bytes;           /* Bytes of rendered table received */
+    int blocks;             /* Calls of the writer */
+} WrittenTable;
+
+/* Rows of the table as pod, namespace and cpu, each with the number of values it holds */
+static const char *const pod_rows[][3] = {
+    { "web-1", "shop", "250m" },
+    { "web-2", NULL, "1500m" },
+    { "db-1", "data", NULL },
+    { "cache-1", NULL, NULL },
+    { "db-2", "data", "2000m" }
+};
+static const int pod_counts[] = { 3, 3, 2, 1, 3 };
+
+/*
+ * Helper function to copy a block of the rendered table to stdout and count it
+ */
+static void write_block(void *context, const char *data, size_t length) {
+    WrittenTable *written = context;
+    written->bytes += length;
+    written->blocks++;
+    fwrite(data, 1, length, stdout);
+}
+
+/*
+ * Helper function to push the rows and render them as one table, returning 0 on success
+ */
+static int render_pods(TablesLayout *layout) {
+    if (tables_begin(layout) != 0) return 1;
+    for (size_t i = 0; i < sizeof(pod_counts) / sizeof(pod_counts[0]); i++) {
+        if (tables_push_row(pod_rows[i], pod_counts[i]) != 0) {
+            tables_end();
+            return 1;
+        }
+    }
+    return tables_end();
+}
+
+/*
+ * Main function
+ * Renders the rows once, or twice with the same layout, and reports what reached the writer
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s LAYOUT_FILE [--stdout] [--twice] [--debug] [--debug_layout]\n", argv[0]);
+        return 1;
+    }
+    int to_stdout = 0;
+    int tables = 1;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--stdout") == 0) {
+            to_stdout = 1;
+        } else if (strcmp(argv[i], "--twice") == 0) {
+            tables = 2;
+        } else if (strcmp(argv[i], "--debug") == 0) {
+            tables_set_debug(1);
+        } else if (strcmp(argv[i], "--debug_layout") == 0) {
+            tables_set_debug_layout(1);
+        }
+    }
+
+    TablesLayout *layout = tables_load_layout(argv[1]);
+    if (layout == NULL) return 1;
+
+    // Setting the writer back to NULL renders to stdout without the writer seeing anything
+    WrittenTable written = {0, 0};
+    tables_set_writer(write_block, &written);
+    if (to_stdout) tables_set_writer(NULL, NULL);
+
+    int status = 0;
+    for (int i = 0; i < tables && status == 0; i++) {
+        status = render_pods(layout);
+    }
+    fflush(stdout);
+    tables_set_writer(NULL, NULL);
+    tables_free_layout(layout);
+    fprintf(stderr, "Writer received %zu bytes%s\n", written.bytes, written.blocks > 0 ? "" : ", none of the table");
+    return status;
+}
@@ -0,0 +1,122 @@
+#!/usr/bin/env bash
+
+# Test Suite 28: Library - Tables rendered from rows pushed through libtables
+# This test suite focuses on the row-push interface of tables_api.h, built together with the
+# library sources into a small program pushing rows with NULL values and rows shorter than the
+# layout, checking the table against the tables command, the limit, and the writer function.
+# CC, LIB_CFLAGS and LIB_LDFLAGS override how the program is built, as in the Makefile.
+
+# Create temporary files for our JSON and the program
+layout_file=$(mktemp)
+data_file=$(mktemp)
+library_output=$(mktemp)
+command_output=$(mktemp)
+library_program=$(mktemp)
+tables_script="$(dirname "$0")/../tables"
+source_dir="$(dirname "$0")/.."
+
+# Cleanup function
+cleanup() {
+    rm -f "$layout_file" "$data_file" "$library_output" "$command_output" "$library_program"
+}
+trap cleanup EXIT
+
+# Check for debug flags
+DEBUG_FLAG=""
+DEBUG_LAYOUT_FLAG=""
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug)
+            DEBUG_FLAG="--debug"
+            echo "Debug mode enabled"
+            ;;
+        --debug_layout)
+            DEBUG_LAYOUT_FLAG="--debug_layout"
+            echo "Debug layout mode enabled"
+            ;;
+    esac
+    shift
+done
+
+# Build the program with every source of the library, which is all but the command line driver
+library_sources=()
+for source in "$source_dir"/*.c; do
+    [[ "$(basename "$source")" == "tables.c" ]] || library_sources+=("$source")
+done
+if ! ${CC:-gcc} ${LIB_CFLAGS:--Wall -Wextra -O2 $(pkg-config --cflags jansson)} -o "$library_program" \
+        "$(dirname "$0")/tables_test_28_library.c" "${library_sources[@]}" \
+        ${LIB_LDFLAGS:-$(pkg-config --libs jansson)} -lm -lpthread; then
+    echo "Error: Cannot build tables_test_28_library.c"
+    exit 1
+fi
+
+# The rows the program pushes, with null values where it pushes NULL or fewer values
+cat > "$data_file" << 'EOF'
+[
+  { "pod": "web-1", "namespace": "shop", "cpu": "250m" },
+  { "pod": "web-2", "namespace": null, "cpu": "1500m" },
+  { "pod": "db-1", "namespace": "data", "cpu": null },
+  { "pod": "cache-1", "namespace": null, "cpu": null },
+  { "pod": "db-2", "namespace": "data", "cpu": "2000m" }
+]
+EOF
+
+# TestC 28-A: Pushed rows with NULL values and short rows, passed to the writer
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Red",
+  "title": "Pods",
+  "footer": "Pushed rows",
+  "columns": [
+    { "header": "Pod", "key": "pod", "summary": "count" },
+    { "header": "Namespace", "key": "namespace" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" }
+  ]
+}
+EOF
+
+echo "TestC 28-A: Pushed rows with NULL values and short rows, passed to the writer"
+echo "----------------------------------------------------------------------------"
+"$library_program" "$layout_file" $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+
+# TestC 28-B: The same table as the tables command renders from JSON
+echo -e "\nTestC 28-B: The same table as the tables command renders from JSON"
+echo "------------------------------------------------------------------"
+"$library_program" "$layout_file" > "$library_output" 2>/dev/null
+"$tables_script" "$layout_file" "$data_file" > "$command_output"
+if cmp -s "$library_output" "$command_output"; then
+    echo "Library and command tables match"
+else
+    diff "$command_output" "$library_output"
+fi
+
+# TestC 28-C: The top rows by CPU, with summaries of every row, for two tables in a run
+cat > "$layout_file" << 'EOF'
+{
+  "theme": "Blue",
+  "title": "Top 2 pods by CPU",
+  "limit": 2,
+  "columns": [
+    { "header": "Pod", "key": "pod", "summary": "count" },
+    { "header": "Namespace", "key": "namespace" },
+    { "header": "CPU", "key": "cpu", "datatype": "kcpu", "justification": "right", "summary": "sum" }
+  ],
+  "sort": [
+    { "key": "cpu", "direction": "desc" }
+  ]
+}
+EOF
+
+echo -e "\nTestC 28-C: The top rows by CPU, with summaries of every row, for two tables in a run"
+echo "-------------------------------------------------------------------------------------"
+"$library_program" "$layout_file" --twice $DEBUG_FLAG $DEBUG_LAYOUT_FLAG
+"$tables_script" "$layout_file" "$data_file" > "$command_output"
+"$library_program" "$layout_file" > "$library_output" 2>/dev/null
+cmp -s "$library_output" "$command_output" && echo "Library and command tables match"
+
+# TestC 28-D: A NULL writer going back to stdout, and a layout that cannot be loaded
+echo -e "\nTestC 28-D: A NULL writer going back to stdout, and a layout that cannot be loaded"
+echo "----------------------------------------------------------------------------------"
+"$library_program" "$layout_file" --stdout $DEBUG_FLAG $DEBUG_LAYOUT_FLAG 2>&1 | tail -n 3
+"$library_program" "$layout_file.missing" 2>&1 | sed "s#$layout_file#<layout_file>#g"
+echo "Exit status: ${PIPESTATUS[0]}"